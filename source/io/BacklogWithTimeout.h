@@ -8,6 +8,7 @@
 #include <cmath>
 #include <cstdint>
 #include <functional>
+#include <limits>
 #include <vector>
 
 #include <assert.h>
@@ -21,6 +22,28 @@ public:
     using ItemTimeGetter = std::function<std::uint64_t(const T&)>;
     using MonothonicClockGetterType = std::uint64_t(*)();
 
+    // Identifies added item, allows to remove or touch it without search.
+    // Handle becomes invalid when item is removed or expired, operations with such handle have no effect.
+    class ItemHandle {
+    public:
+        friend class BacklogWithTimeout;
+
+        ItemHandle() = default;
+
+        bool is_valid() const {
+            return m_slot != INVALID_SLOT;
+        }
+
+    private:
+        ItemHandle(std::size_t slot, std::uint64_t generation) :
+            m_slot(slot),
+            m_generation(generation) {
+        }
+
+        std::size_t m_slot = INVALID_SLOT;
+        std::uint64_t m_generation = 0;
+    };
+
     IO_FORBID_COPY(BacklogWithTimeout);
 
     BacklogWithTimeout(BacklogWithTimeout&& other) :
@@ -29,7 +52,10 @@ public:
         m_time_getter(std::move(other.m_time_getter)),
         m_clock_getter(std::move(other.m_clock_getter)),
         m_timers(std::move(other.m_timers)),
-        m_items(std::move(other.m_items)) {
+        m_items(std::move(other.m_items)),
+        m_slots(std::move(other.m_slots)),
+        m_free_slots(std::move(other.m_free_slots)),
+        m_items_count(other.m_items_count) {
 
         refresh_timer_backlog_pointers();
     }
@@ -41,6 +67,9 @@ public:
         m_clock_getter = std::move(other.m_clock_getter);
         m_timers = std::move(other.m_timers);
         m_items = std::move(other.m_items);
+        m_slots = std::move(other.m_slots);
+        m_free_slots = std::move(other.m_free_slots);
+        m_items_count = other.m_items_count;
 
         refresh_timer_backlog_pointers();
         return *this;
@@ -87,7 +116,13 @@ public:
         m_items.resize(buckets_count);
     };
 
-    bool add_item(T t) {
+    // If 'handle' is not null, it receives handle of the added item. Handle is invalid if item
+    // was not added or was expired right away.
+    bool add_item(T t, ItemHandle* handle = nullptr) {
+        if (handle) {
+            *handle = ItemHandle();
+        }
+
         const std::uint64_t current_time = m_clock_getter();
         const std::uint64_t item_time = m_time_getter(t);
         if (current_time < item_time) { // item from the future
@@ -108,18 +143,22 @@ public:
             return true;
         }
 
-        auto index = bucket_index_from_time(m_entity_timeout - time_diff);
-        m_items[index].push_back(t);
+        const auto slot_index = allocate_slot(std::move(t));
+        push_to_bucket(slot_index, bucket_index_from_time(m_entity_timeout - time_diff));
+
+        if (handle) {
+            *handle = ItemHandle(slot_index, m_slots[slot_index].generation);
+        }
 
         return true;
     }
 
+    // Linear search, prefer removal by handle
     bool remove_item(const T& t) {
-        for(std::size_t i = 0; i < m_timers.size(); ++i) {
-            auto& items = m_items[i];
-            auto it = std::find(items.begin(), items.end(), t);
-            if (it != items.end()) {
-                items.erase(it);
+        for (std::size_t i = 0; i < m_slots.size(); ++i) {
+            auto& slot = m_slots[i];
+            if (slot.bucket != FREE_SLOT && slot.item == t) {
+                release_slot(i);
                 return true;
             }
         }
@@ -127,6 +166,51 @@ public:
         return false;
     }
 
+    bool remove_item(const ItemHandle& handle) {
+        if (!is_handle_alive(handle)) {
+            return false;
+        }
+
+        release_slot(handle.m_slot);
+        return true;
+    }
+
+    // Re-reads time of the item and moves it to the corresponding bucket, so item which time
+    // was updated is not checked again until the new expiration time approaches.
+    bool touch(const ItemHandle& handle) {
+        if (!is_handle_alive(handle)) {
+            return false;
+        }
+
+        auto& slot = m_slots[handle.m_slot];
+        if (slot.bucket == PROCESSING_SLOT) {
+            return true; // bucket is re-evaluated right now
+        }
+
+        const std::uint64_t current_time = m_clock_getter();
+        const std::uint64_t item_time = m_time_getter(slot.item);
+        if (current_time < item_time) {
+            return false;
+        }
+
+        const auto time_diff = current_time - item_time;
+        if (time_diff >= m_entity_timeout) {
+            return true; // will be expired on the next bucket check
+        }
+
+        const auto index = bucket_index_from_time(m_entity_timeout - time_diff);
+        if (index != slot.bucket) {
+            remove_from_bucket(handle.m_slot);
+            push_to_bucket(handle.m_slot, index);
+        }
+
+        return true;
+    }
+
+    std::size_t size() const {
+        return m_items_count;
+    }
+
     void stop() {
         m_entity_timeout = 0;
         m_expired_callback = nullptr;
@@ -134,6 +218,9 @@ public:
         m_clock_getter = nullptr;
         m_timers.clear();
         m_items.clear();
+        m_slots.clear();
+        m_free_slots.clear();
+        m_items_count = 0;
     }
 
 protected:
@@ -142,18 +229,30 @@ protected:
         const std::size_t timer_index = data.index;
         auto& this_ = *data.backlog;
 
-        const std::vector<T>& current_bucket = this_.m_items[timer_index];
+        // Bucket is detached because callbacks may add or remove items
+        std::vector<std::size_t> current_bucket;
+        current_bucket.swap(this_.m_items[timer_index]);
 
-        std::vector<T> bucket_replacement;
-        bucket_replacement.reserve(current_bucket.size());
+        for (auto slot_index : current_bucket) {
+            this_.m_slots[slot_index].bucket = PROCESSING_SLOT;
+        }
 
         for (std::size_t i = 0; i < current_bucket.size(); ++i) {
+            const auto slot_index = current_bucket[i];
+            auto& slot = this_.m_slots[slot_index];
+            if (slot.bucket != PROCESSING_SLOT) { // removed in one of previous callbacks
+                continue;
+            }
+
             const std::uint64_t current_time = this_.m_clock_getter();
-            const std::uint64_t item_time = this_.m_time_getter(current_bucket[i]);
+            const std::uint64_t item_time = this_.m_time_getter(slot.item);
 
             const auto time_diff = current_time - item_time;
             if (time_diff >= this_.m_entity_timeout) {
-                this_.m_expired_callback(this_, current_bucket[i]);
+                T item = std::move(slot.item);
+                this_.release_slot(slot_index);
+
+                this_.m_expired_callback(this_, item);
                 if (this_.m_timers.empty()) { // BacklogWithTimeout object could be stopped in callback
                     return;
                 }
@@ -161,15 +260,62 @@ protected:
                 continue;
             }
 
-            auto index = this_.bucket_index_from_time(this_.m_entity_timeout - time_diff);
-            if (index != timer_index) {
-                this_.m_items[index].push_back(current_bucket[i]);
-            } else {
-                bucket_replacement.push_back(current_bucket[i]);
-            }
+            this_.push_to_bucket(slot_index, this_.bucket_index_from_time(this_.m_entity_timeout - time_diff));
+        }
+    }
+
+    bool is_handle_alive(const ItemHandle& handle) const {
+        return handle.m_slot < m_slots.size() &&
+               m_slots[handle.m_slot].bucket != FREE_SLOT &&
+               m_slots[handle.m_slot].generation == handle.m_generation;
+    }
+
+    std::size_t allocate_slot(T&& t) {
+        ++m_items_count;
+
+        if (m_free_slots.empty()) {
+            m_slots.push_back(Slot(std::move(t)));
+            return m_slots.size() - 1;
+        }
+
+        const auto slot_index = m_free_slots.back();
+        m_free_slots.pop_back();
+        m_slots[slot_index].item = std::move(t);
+        return slot_index;
+    }
+
+    void release_slot(std::size_t slot_index) {
+        auto& slot = m_slots[slot_index];
+        if (slot.bucket != PROCESSING_SLOT) {
+            remove_from_bucket(slot_index);
         }
 
-        this_.m_items[timer_index].swap(bucket_replacement);
+        // Releasing resources held by the item (for example shared pointers)
+        T released_item = std::move(slot.item);
+        (void)released_item;
+
+        slot.bucket = FREE_SLOT;
+        ++slot.generation;
+        m_free_slots.push_back(slot_index);
+        --m_items_count;
+    }
+
+    void push_to_bucket(std::size_t slot_index, std::size_t bucket) {
+        auto& slot = m_slots[slot_index];
+        slot.bucket = bucket;
+        slot.position = m_items[bucket].size();
+        m_items[bucket].push_back(slot_index);
+    }
+
+    // O(1): the last element of the bucket takes place of the removed one
+    void remove_from_bucket(std::size_t slot_index) {
+        auto& slot = m_slots[slot_index];
+        auto& bucket = m_items[slot.bucket];
+
+        const auto last_slot_index = bucket.back();
+        bucket[slot.position] = last_slot_index;
+        m_slots[last_slot_index].position = slot.position;
+        bucket.pop_back();
     }
 
     std::size_t bucket_index_from_time(std::uint64_t time) const {
@@ -190,12 +336,31 @@ protected:
     }
 
 private:
+    static const std::size_t INVALID_SLOT = (std::numeric_limits<std::size_t>::max)();
+    static const std::size_t FREE_SLOT = (std::numeric_limits<std::size_t>::max)();
+    static const std::size_t PROCESSING_SLOT = (std::numeric_limits<std::size_t>::max)() - 1;
+
+    struct Slot {
+        explicit Slot(T&& t) :
+            item(std::move(t)) {
+        }
+
+        T item;
+        std::size_t bucket = FREE_SLOT; // or one of special values
+        std::size_t position = 0; // index in the bucket
+        std::uint64_t generation = 0;
+    };
+
     std::size_t m_entity_timeout = 0;
     OnItemExpiredCallback m_expired_callback;
     ItemTimeGetter m_time_getter = nullptr;
     MonothonicClockGetterType m_clock_getter = nullptr;
     std::vector<std::unique_ptr<TimerType, std::function<void(TimerType*)> >> m_timers;
-    std::vector<std::vector<T>> m_items;
+    // Buckets contain indexes of slots
+    std::vector<std::vector<std::size_t>> m_items;
+    std::vector<Slot> m_slots;
+    std::vector<std::size_t> m_free_slots;
+    std::size_t m_items_count = 0;
 };
 
 } // namespace io
@@ -0,0 +1,177 @@
+#include "ByteScan.h"
+
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #define IO_BYTE_SCAN_SSE2
+    #include <emmintrin.h>
+
+    // AVX2 code is compiled with target attribute and enabled at runtime, so it is available
+    // without -mavx2 for the whole library. MSVC has no equivalent of __builtin_cpu_supports.
+    #if defined(__GNUC__) || defined(__clang__)
+        #define IO_BYTE_SCAN_AVX2
+        #include <immintrin.h>
+    #endif
+#endif
+
+#ifdef _MSC_VER
+    #include <intrin.h>
+#endif
+
+namespace io {
+
+namespace {
+
+#ifdef IO_BYTE_SCAN_SSE2
+inline unsigned count_trailing_zeros(std::uint32_t mask) {
+#ifdef _MSC_VER
+    unsigned long index = 0;
+    _BitScanForward(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+#endif
+
+const char* find_byte_scalar(const char* begin, const char* end, char value) {
+    for (; begin != end; ++begin) {
+        if (*begin == value) {
+            return begin;
+        }
+    }
+
+    return end;
+}
+
+#ifdef IO_BYTE_SCAN_SSE2
+const char* find_byte_sse2(const char* begin, const char* end, char value) {
+    if (end - begin < 16) {
+        return find_byte_scalar(begin, end, value);
+    }
+
+    const __m128i needle = _mm_set1_epi8(value);
+
+    while (end - begin >= 16) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+        const auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle)));
+        if (mask) {
+            return begin + count_trailing_zeros(mask);
+        }
+        begin += 16;
+    }
+
+    if (begin == end) {
+        return end;
+    }
+
+    // Tail is checked by the last block of the range, already checked bytes are masked off
+    const char* const last = end - 16;
+    const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(last));
+    auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle)));
+    mask &= ~std::uint32_t(0) << (begin - last);
+    return mask ? last + count_trailing_zeros(mask) : end;
+}
+#endif
+
+#ifdef IO_BYTE_SCAN_AVX2
+__attribute__((target("avx2")))
+const char* find_byte_avx2(const char* begin, const char* end, char value) {
+    if (end - begin < 32) {
+        return find_byte_sse2(begin, end, value);
+    }
+
+    const __m256i needle = _mm256_set1_epi8(value);
+
+    // 2 blocks per iteration, matches are checked once for both
+    while (end - begin >= 64) {
+        const __m256i match_1 = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin)), needle);
+        const __m256i match_2 = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin + 32)), needle);
+        if (!_mm256_testz_si256(_mm256_or_si256(match_1, match_2), _mm256_or_si256(match_1, match_2))) {
+            const auto mask_1 = static_cast<std::uint32_t>(_mm256_movemask_epi8(match_1));
+            if (mask_1) {
+                return begin + count_trailing_zeros(mask_1);
+            }
+            return begin + 32 + count_trailing_zeros(static_cast<std::uint32_t>(_mm256_movemask_epi8(match_2)));
+        }
+        begin += 64;
+    }
+
+    while (end - begin >= 32) {
+        const __m256i match = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin)), needle);
+        const auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(match));
+        if (mask) {
+            return begin + count_trailing_zeros(mask);
+        }
+        begin += 32;
+    }
+
+    if (begin == end) {
+        return end;
+    }
+
+    const char* const last = end - 32;
+    const __m256i match = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(last)), needle);
+    auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(match));
+    mask &= ~std::uint32_t(0) << (begin - last);
+    return mask ? last + count_trailing_zeros(mask) : end;
+}
+#endif
+
+ByteScanMode detect_best_byte_scan_mode() {
+#ifdef IO_BYTE_SCAN_AVX2
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return ByteScanMode::AVX2;
+    }
+#endif
+
+#ifdef IO_BYTE_SCAN_SSE2
+    return ByteScanMode::SSE2;
+#else
+    return ByteScanMode::SCALAR;
+#endif
+}
+
+using FindByteFunction = const char* (*)(const char*, const char*, char);
+
+FindByteFunction find_byte_function(ByteScanMode mode) {
+    switch (mode) {
+#ifdef IO_BYTE_SCAN_AVX2
+        case ByteScanMode::AVX2:
+            return &find_byte_avx2;
+#endif
+#ifdef IO_BYTE_SCAN_SSE2
+        case ByteScanMode::SSE2:
+            return &find_byte_sse2;
+#endif
+        default:
+            return &find_byte_scalar;
+    }
+}
+
+} // namespace
+
+ByteScanMode best_byte_scan_mode() {
+    static const ByteScanMode mode = detect_best_byte_scan_mode();
+    return mode;
+}
+
+bool is_byte_scan_mode_supported(ByteScanMode mode) {
+    return static_cast<int>(mode) <= static_cast<int>(best_byte_scan_mode());
+}
+
+const char* find_byte(const char* begin, const char* end, char value) {
+    static const FindByteFunction function = find_byte_function(best_byte_scan_mode());
+    return function(begin, end, value);
+}
+
+const char* find_byte(const char* begin, const char* end, char value, ByteScanMode mode) {
+    if (!is_byte_scan_mode_supported(mode)) {
+        return find_byte_scalar(begin, end, value);
+    }
+
+    return find_byte_function(mode)(begin, end, value);
+}
+
+} // namespace io
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Export.h"
+
+namespace io {
+
+enum class ByteScanMode {
+    SCALAR,
+    SSE2, // x86_64 only
+    AVX2  // x86_64 with GCC or Clang, depends on CPU
+};
+
+// The fastest mode supported by the platform and CPU, detected once.
+IO_DLL_PUBLIC ByteScanMode best_byte_scan_mode();
+IO_DLL_PUBLIC bool is_byte_scan_mode_supported(ByteScanMode mode);
+
+// Returns pointer to the first byte equal to 'value' in [begin, end) or 'end' if there is no such byte.
+IO_DLL_PUBLIC const char* find_byte(const char* begin, const char* end, char value);
+
+// Same, but with explicitly selected mode, not supported mode falls back to the scalar one.
+// Intended for tests and benchmarks.
+IO_DLL_PUBLIC const char* find_byte(const char* begin, const char* end, char value, ByteScanMode mode);
+
+} // namespace io
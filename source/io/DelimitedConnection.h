@@ -0,0 +1,301 @@
+#pragma once
+
+#include "ByteScan.h"
+#include "CommonMacros.h"
+#include "DataChunk.h"
+#include "Error.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace io {
+
+// Splits stream of the connection into lines (or other records) terminated by delimiter.
+// Usage, buffers ownership and error handling are the same as for FramedConnection with lines instead
+// of frames. Delimiter is searched with SIMD instructions where they are available (see ByteScan.h).
+template<typename ConnectionType>
+class DelimitedConnection {
+public:
+    using LineReceiveCallback = std::function<void(ConnectionType&, const DataChunk&, const Error&)>;
+    using EndSendCallback = typename ConnectionType::EndSendCallback;
+
+    enum class Delimiter {
+        LF,  // "\n"
+        CRLF // "\r\n", single '\n' is a part of the line
+    };
+
+    static const std::size_t DEFAULT_MAX_LINE_SIZE = 64 * 1024;
+
+    IO_FORBID_COPY(DelimitedConnection);
+
+    DelimitedConnection(DelimitedConnection&& other) = default;
+    DelimitedConnection& operator=(DelimitedConnection&& other) = default;
+
+    DelimitedConnection(LineReceiveCallback line_callback,
+                        Delimiter delimiter = Delimiter::LF,
+                        std::size_t max_line_size = DEFAULT_MAX_LINE_SIZE) :
+        DelimitedConnection(std::move(line_callback), '\n', delimiter == Delimiter::CRLF, max_line_size) {
+    }
+
+    // Records terminated by custom byte, for example '\0'
+    DelimitedConnection(LineReceiveCallback line_callback,
+                        char delimiter_byte,
+                        std::size_t max_line_size = DEFAULT_MAX_LINE_SIZE) :
+        DelimitedConnection(std::move(line_callback), delimiter_byte, false, max_line_size) {
+    }
+
+    // Lines are passed to the callback without delimiter, limit for MESSAGE_TOO_LONG is max_line_size().
+    void on_receive(ConnectionType& connection, const DataChunk& chunk);
+
+    // Delimiter is appended to the line.
+    void send_line(ConnectionType& connection, std::shared_ptr<const char> buffer, std::uint32_t size, EndSendCallback callback = nullptr);
+    void send_line(ConnectionType& connection, const std::string& line, EndSendCallback callback = nullptr);
+
+    void reset();
+
+    std::size_t delimiter_size() const;
+    std::size_t max_line_size() const;
+
+    std::size_t zero_copy_lines_count() const;
+    std::size_t reassembled_lines_count() const;
+
+private:
+    DelimitedConnection(LineReceiveCallback line_callback, char delimiter_byte, bool crlf, std::size_t max_line_size);
+
+    const char* find_delimiter(const char* begin, const char* end) const;
+    bool append_partial_line(ConnectionType& connection, const char* begin, const char* end);
+    void deliver_line(ConnectionType& connection, const DataChunk& line);
+    void report_too_long_line(ConnectionType& connection);
+
+    LineReceiveCallback m_line_callback;
+    char m_delimiter_byte;
+    bool m_crlf;
+    std::size_t m_max_line_size;
+
+    // Delimiter is shared by all sent lines
+    std::shared_ptr<char> m_delimiter;
+
+    std::shared_ptr<char> m_partial_line;
+    std::size_t m_partial_line_capacity = 0;
+    std::size_t m_partial_line_size = 0;
+
+    bool m_failed = false;
+    std::uint64_t m_stream_offset = 0;
+    std::size_t m_reset_counter = 0;
+
+    std::size_t m_zero_copy_lines_count = 0;
+    std::size_t m_reassembled_lines_count = 0;
+};
+
+///////////////////////////////////////// implementation ///////////////////////////////////////////
+
+template<typename ConnectionType>
+const std::size_t DelimitedConnection<ConnectionType>::DEFAULT_MAX_LINE_SIZE;
+
+template<typename ConnectionType>
+DelimitedConnection<ConnectionType>::DelimitedConnection(LineReceiveCallback line_callback, char delimiter_byte, bool crlf, std::size_t max_line_size) :
+    m_line_callback(std::move(line_callback)),
+    m_delimiter_byte(delimiter_byte),
+    m_crlf(crlf),
+    m_max_line_size(max_line_size),
+    m_delimiter(new char[2], std::default_delete<char[]>()) {
+    if (m_crlf) {
+        m_delimiter.get()[0] = '\r';
+        m_delimiter.get()[1] = '\n';
+    } else {
+        m_delimiter.get()[0] = delimiter_byte;
+    }
+}
+
+template<typename ConnectionType>
+void DelimitedConnection<ConnectionType>::on_receive(ConnectionType& connection, const DataChunk& chunk) {
+    if (m_failed || chunk.size == 0 || chunk.buf == nullptr) {
+        return;
+    }
+
+    const char* position = chunk.buf.get();
+    const char* const end = position + chunk.size;
+
+    while (position < end) {
+        const char* const delimiter = find_delimiter(position, end);
+        if (delimiter == end) {
+            append_partial_line(connection, position, end);
+            return;
+        }
+
+        const char* line_end = delimiter;
+        if (m_crlf && delimiter != position) {
+            --line_end;
+        }
+
+        const auto reset_counter = m_reset_counter;
+
+        if (m_partial_line_size) {
+            if (!append_partial_line(connection, position, line_end)) {
+                return;
+            }
+
+            // '\r' of the delimiter was received with the previous chunk
+            if (m_crlf && delimiter == position) {
+                --m_partial_line_size;
+            }
+
+            const std::size_t line_size = m_partial_line_size;
+            m_partial_line_size = 0;
+            if (line_size > m_max_line_size) {
+                report_too_long_line(connection);
+                return;
+            }
+
+            if (line_size) {
+                ++m_reassembled_lines_count;
+                deliver_line(connection, DataChunk(m_partial_line, line_size, m_stream_offset));
+            } else {
+                deliver_line(connection, DataChunk(nullptr, 0, m_stream_offset));
+            }
+        } else {
+            const std::size_t line_size = static_cast<std::size_t>(line_end - position);
+            if (line_size > m_max_line_size) {
+                report_too_long_line(connection);
+                return;
+            }
+
+            if (line_size) {
+                // Aliasing constructor, line shares ownership of the chunk's buffer
+                ++m_zero_copy_lines_count;
+                deliver_line(connection, DataChunk(std::shared_ptr<const char>(chunk.buf, position), line_size, m_stream_offset));
+            } else {
+                deliver_line(connection, DataChunk(nullptr, 0, m_stream_offset));
+            }
+        }
+
+        if (reset_counter != m_reset_counter) {
+            return;
+        }
+
+        position = delimiter + 1;
+    }
+}
+
+template<typename ConnectionType>
+const char* DelimitedConnection<ConnectionType>::find_delimiter(const char* begin, const char* end) const {
+    if (!m_crlf) {
+        return find_byte(begin, end, m_delimiter_byte);
+    }
+
+    for (const char* current = begin; ; ++current) {
+        current = find_byte(current, end, '\n');
+        if (current == end) {
+            return end;
+        }
+
+        // Previous byte could be in the partial line from previous chunks
+        const char previous = current != begin ? current[-1] :
+                              m_partial_line_size ? m_partial_line.get()[m_partial_line_size - 1] : 0;
+        if (previous == '\r') {
+            return current;
+        }
+    }
+}
+
+template<typename ConnectionType>
+bool DelimitedConnection<ConnectionType>::append_partial_line(ConnectionType& connection, const char* begin, const char* end) {
+    const std::size_t size = static_cast<std::size_t>(end - begin);
+    if (size == 0) {
+        return true;
+    }
+
+    const std::size_t new_size = m_partial_line_size + size;
+    // In CRLF mode '\r' of the delimiter may be stored until '\n' is received
+    if (new_size > m_max_line_size + (m_crlf ? 1 : 0)) {
+        report_too_long_line(connection);
+        return false;
+    }
+
+    // Buffer which is still referenced by previously delivered line can not be overwritten
+    const bool is_shared = m_partial_line && m_partial_line.use_count() > 1;
+    if (m_partial_line_capacity < new_size || is_shared) {
+        const std::size_t capacity = std::min(std::max(new_size, m_partial_line_capacity * 2), m_max_line_size + 1);
+        std::shared_ptr<char> buffer(new char[capacity], std::default_delete<char[]>());
+        if (m_partial_line_size) {
+            std::memcpy(buffer.get(), m_partial_line.get(), m_partial_line_size);
+        }
+        m_partial_line = std::move(buffer);
+        m_partial_line_capacity = capacity;
+    }
+
+    std::memcpy(m_partial_line.get() + m_partial_line_size, begin, size);
+    m_partial_line_size = new_size;
+    return true;
+}
+
+template<typename ConnectionType>
+void DelimitedConnection<ConnectionType>::deliver_line(ConnectionType& connection, const DataChunk& line) {
+    m_stream_offset += line.size + delimiter_size();
+    if (m_line_callback) {
+        m_line_callback(connection, line, Error(0));
+    }
+}
+
+template<typename ConnectionType>
+void DelimitedConnection<ConnectionType>::report_too_long_line(ConnectionType& connection) {
+    m_failed = true;
+    m_partial_line_size = 0;
+    if (m_line_callback) {
+        m_line_callback(connection, DataChunk(), Error(StatusCode::MESSAGE_TOO_LONG));
+    }
+}
+
+template<typename ConnectionType>
+void DelimitedConnection<ConnectionType>::send_line(ConnectionType& connection, std::shared_ptr<const char> buffer, std::uint32_t size, EndSendCallback callback) {
+    std::vector<DataChunk> chunks;
+    chunks.reserve(2);
+    chunks.emplace_back(std::move(buffer), size, 0);
+    chunks.emplace_back(m_delimiter, delimiter_size(), 0);
+    connection.send_data(std::move(chunks), callback);
+}
+
+template<typename ConnectionType>
+void DelimitedConnection<ConnectionType>::send_line(ConnectionType& connection, const std::string& line, EndSendCallback callback) {
+    // Line and delimiter are copied to the one buffer
+    const std::size_t size = line.size() + delimiter_size();
+    std::shared_ptr<char> buffer(new char[size], std::default_delete<char[]>());
+    std::memcpy(buffer.get(), line.data(), line.size());
+    std::memcpy(buffer.get() + line.size(), m_delimiter.get(), delimiter_size());
+    connection.send_data(buffer, static_cast<std::uint32_t>(size), callback);
+}
+
+template<typename ConnectionType>
+void DelimitedConnection<ConnectionType>::reset() {
+    m_partial_line_size = 0;
+    m_failed = false;
+    m_stream_offset = 0;
+    ++m_reset_counter;
+}
+
+template<typename ConnectionType>
+std::size_t DelimitedConnection<ConnectionType>::delimiter_size() const {
+    return m_crlf ? 2 : 1;
+}
+
+template<typename ConnectionType>
+std::size_t DelimitedConnection<ConnectionType>::max_line_size() const {
+    return m_max_line_size;
+}
+
+template<typename ConnectionType>
+std::size_t DelimitedConnection<ConnectionType>::zero_copy_lines_count() const {
+    return m_zero_copy_lines_count;
+}
+
+template<typename ConnectionType>
+std::size_t DelimitedConnection<ConnectionType>::reassembled_lines_count() const {
+    return m_reassembled_lines_count;
+}
+
+} // namespace io
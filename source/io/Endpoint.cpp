@@ -20,6 +20,7 @@ public:
     Impl(const std::uint8_t* address_bytes, std::size_t _address_size, std::uint16_t port);
 
     Impl(const Impl& other);
+    Impl& operator=(const Impl& other) = default;
 
     std::string address_string() const;
     std::uint16_t port() const;
@@ -228,6 +229,10 @@ Endpoint::Type Endpoint::type() const {
     return m_impl->type();
 }
 
+void Endpoint::assign(const void* raw_address) {
+    *m_impl = Impl(reinterpret_cast<const ::sockaddr*>(raw_address));
+}
+
 void* Endpoint::raw_endpoint() {
     return m_impl->raw_endpoint();
 }
@@ -52,6 +52,9 @@ public:
     IO_DLL_PUBLIC std::uint32_t ipv4_addr() const;
 
 private:
+    // Reuses existing storage, does not allocate
+    void assign(const void* raw_address);
+
     void* raw_endpoint();
     const void* raw_endpoint() const;
 
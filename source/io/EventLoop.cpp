@@ -1,18 +1,22 @@
 #include "EventLoop.h"
 
 #include "detail/Common.h"
+#include "detail/MpscQueue.h"
+#include "detail/ReadBufferPool.h"
+#include "detail/WorkStealingThreadPool.h"
 #include "CommonMacros.h"
 #include "Logger.h"
+#include "Removable.h"
 #include "ScopeExitGuard.h"
 #include "Error.h"
 #include "global/Configuration.h"
 
+#include <algorithm>
 #include <atomic>
+#include <cstdlib>
 #include <cstring>
-#include <deque>
 #include <functional>
 #include <mutex>
-#include <thread>
 #include <type_traits>
 #include <unordered_map>
 #include <vector>
@@ -26,11 +30,75 @@ struct Idle : public uv_idle_t {
     std::size_t id = 0;
 };
 
+// Common part of all work requests which is used to link completed works into intrusive list
+struct WorkBase : public uv_work_t {
+    WorkBase* next_completed = nullptr;
+    void (*complete)(WorkBase& work) = nullptr;
+};
+
+template <typename WorkCallbackType, typename WorkDoneCallbackType>
+struct Work : public WorkBase {
+    WorkCallbackType work_callback;
+    WorkDoneCallbackType work_done_callback;
+
+    void call_work_callback() {
+        if (work_callback) {
+            work_callback();
+        }
+    }
+
+    void call_work_done_callback() {
+        if (work_done_callback) {
+            work_done_callback();
+        }
+    }
+
+    // Releases captured state before request is returned to the free list
+    void reset() {
+        work_callback = nullptr;
+        work_done_callback = nullptr;
+        next_completed = nullptr;
+    }
+};
+
+template <>
+struct Work<EventLoop::WorkCallbackWithUserData, EventLoop::WorkDoneCallbackWithUserData> : public WorkBase {
+    EventLoop::WorkCallbackWithUserData work_callback;
+    EventLoop::WorkDoneCallbackWithUserData work_done_callback;
+
+    void* user_data = nullptr;
+
+    void call_work_callback() {
+        if (work_callback) {
+            user_data = work_callback();
+        }
+    }
+
+    void call_work_done_callback() {
+        if (work_done_callback) {
+            work_done_callback(user_data);
+        }
+    }
+
+    void reset() {
+        work_callback = nullptr;
+        work_done_callback = nullptr;
+        user_data = nullptr;
+        next_completed = nullptr;
+    }
+};
+
+using PlainWork = Work<EventLoop::WorkCallback, EventLoop::WorkDoneCallback>;
+using WorkWithUserData = Work<EventLoop::WorkCallbackWithUserData, EventLoop::WorkDoneCallbackWithUserData>;
+
+// Free requests above this limit are deallocated to not hold memory after bursts of works
+const std::size_t MAX_FREE_WORK_REQUESTS_COUNT = 1024;
+
 } // namespace
 
 class EventLoop::Impl : public uv_loop_t {
 public:
-    Impl(EventLoop& loop);
+    Impl(EventLoop& loop, std::size_t work_threads_count);
     ~Impl();
 
     IO_FORBID_COPY(Impl)
@@ -39,7 +107,14 @@ public:
     template<typename WorkCallbackType, typename WorkDoneCallbackType>
     void add_work(WorkCallbackType work_callback, WorkDoneCallbackType work_done_callback);
 
+    void parallel_for(std::size_t begin,
+                      std::size_t end,
+                      std::size_t grain,
+                      ParallelForBodyCallback body_callback,
+                      ParallelForDoneCallback done_callback);
+
     void execute_on_loop_thread(AsyncCallback callback);
+    void execute_on_loop_thread(std::vector<AsyncCallback>&& callbacks);
 
     // Warning: do not perform heavy calculations or blocking calls here
     std::size_t schedule_call_on_each_loop_cycle(EachLoopCycleCallback callback);
@@ -55,20 +130,57 @@ public:
 
     void schedule_callback(WorkCallback callback);
 
+    void schedule_removal(Removable& removable);
+    std::size_t pending_removals_count() const;
+
+    detail::ReadBufferPool& read_buffer_pool();
+
+    std::size_t allocated_work_requests_count() const;
+    std::size_t reused_work_requests_count() const;
+
     void finish();
 protected:
-    void execute_pending_callbacks();
+    template<typename WorkType>
+    WorkType* acquire_work();
+    template<typename WorkType>
+    void release_work(WorkType* work);
+    std::vector<PlainWork*>& free_works(PlainWork*);
+    std::vector<WorkWithUserData*>& free_works(WorkWithUserData*);
+
+    template<typename WorkType>
+    void add_work_to_pool(WorkType* work);
+    detail::WorkStealingThreadPool& work_pool();
+
+    // Note: this method is thread safe
+    void push_completed_work(WorkBase* work);
+    std::size_t execute_completed_works();
+
+    void notify_async();
+    bool execute_pending_callbacks();
+
+    struct RemovalBatch : public uv_idle_t {
+        std::vector<Removable*> removals;
+    };
+
+    void notify_removals();
+    void delete_scheduled_removals();
+    void close_removal_idle();
 
     // statics
     template<typename WorkCallbackType, typename WorkDoneCallbackType>
     static void on_work(uv_work_t* req);
     template<typename WorkCallbackType, typename WorkDoneCallbackType>
     static void on_after_work(uv_work_t* req, int status);
+    template<typename WorkType>
+    static void on_pool_work_complete(WorkBase& work);
     static void on_idle(uv_idle_t* handle);
     static void on_each_loop_cycle_handler_close(uv_handle_t* handle);
     static void on_async(uv_async_t* handle);
     static void on_dummy_idle_tick(uv_timer_t*);
     static void on_dummy_idle_close(uv_handle_t* handle);
+    static void on_removal_idle(uv_idle_t* handle);
+    static void on_removal_idle_close(uv_handle_t* handle);
+    static void on_removal_batch_close(uv_handle_t* handle);
 
 private:
     EventLoop* m_loop;
@@ -80,8 +192,23 @@ private:
     std::int64_t m_dummy_idle_ref_counter = 0;
 
     std::unique_ptr<uv_async_t, std::function<void(uv_async_t*)>> m_async;
-    std::deque<std::function<void()>> m_async_callbacks_queue;
-    std::mutex m_async_callbacks_queue_mutex;
+    detail::MpscQueue<AsyncCallback> m_async_callbacks_queue;
+    // Set by the first producer after the queue was drained, so async is signaled once per batch
+    std::atomic<bool> m_async_notified;
+
+    // If 0, works are executed on libuv's thread pool
+    std::size_t m_work_threads_count = 0;
+    // Created on first use
+    std::unique_ptr<detail::WorkStealingThreadPool> m_work_pool;
+    // Accessed only from the loop thread
+    std::size_t m_pending_pool_works_count = 0;
+    // Works completed on the pool, linked in reverse order of completion
+    std::atomic<WorkBase*> m_completed_works;
+
+    std::vector<PlainWork*> m_free_works;
+    std::vector<WorkWithUserData*> m_free_works_with_user_data;
+    std::size_t m_allocated_work_requests_count = 0;
+    std::size_t m_reused_work_requests_count = 0;
 
     bool m_is_running = false;
     bool m_run_called = false;
@@ -89,6 +216,14 @@ private:
     std::size_t m_sync_callbacks_executor_handle = 0;
     std::function<void()> m_sync_callbacks_executor_function;
     std::vector<std::function<void()>> m_sync_callbacks_queue;
+
+    // Objects scheduled for removal are notified in the idle phase and deleted in the close phase
+    // of the same loop cycle all at once, using single handle per cycle instead of one per object.
+    uv_idle_t* m_removal_idle = nullptr;
+    std::vector<Removable*> m_scheduled_removals;
+    std::size_t m_notified_removals_count = 0;
+
+    detail::ReadBufferPool m_read_buffer_pool;
 };
 
 namespace {
@@ -99,11 +234,14 @@ void on_async_close(uv_handle_t* handle) {
 
 } // namespace
 
-EventLoop::Impl::Impl(EventLoop& loop) :
+EventLoop::Impl::Impl(EventLoop& loop, std::size_t work_threads_count) :
     m_loop(&loop),
     m_async(nullptr, [](uv_async_t* async) {
         uv_close(reinterpret_cast<uv_handle_t*>(async), on_async_close);
     }),
+    m_async_notified(false),
+    m_work_threads_count(work_threads_count),
+    m_completed_works(nullptr),
     m_sync_callbacks_executor_function([this]() {
         for(auto&& v: m_sync_callbacks_queue) {
             v();
@@ -131,12 +269,38 @@ EventLoop::Impl::Impl(EventLoop& loop) :
 void EventLoop::Impl::finish() {
     IO_LOG(m_loop, TRACE, "dummy_idle_ref_counter:", m_dummy_idle_ref_counter);
 
-    {
-        std::lock_guard<std::mutex> guard(m_async_callbacks_queue_mutex);
-        m_async.reset();
-        m_async_callbacks_queue.clear();
+    // Waiting for running works before closing async handle which they use to report completion
+    m_work_pool.reset();
+
+    // Completion callbacks are not called after the loop is finished
+    auto completed_work = m_completed_works.exchange(nullptr);
+    while (completed_work) {
+        auto next = completed_work->next_completed;
+        completed_work->data = nullptr;
+        completed_work->complete(*completed_work);
+        completed_work = next;
+    }
+
+    for (auto work : m_free_works) {
+        delete work;
+    }
+    m_free_works.clear();
+
+    if (m_run_called) {
+        // Objects which were scheduled for removal during the last loop cycle
+        delete_scheduled_removals();
     }
 
+    close_removal_idle();
+
+    for (auto work : m_free_works_with_user_data) {
+        delete work;
+    }
+    m_free_works_with_user_data.clear();
+
+    m_async.reset();
+    m_async_callbacks_queue.clear();
+
     int status = uv_loop_close(this);
 
     if (!m_run_called) {
@@ -151,6 +315,13 @@ void EventLoop::Impl::finish() {
         // Making the last attemt to close everything and shut down gracefully
         status = uv_run(this, UV_RUN_ONCE);
 
+        // Objects which were scheduled for removal from close callbacks of the last run
+        if (!m_scheduled_removals.empty()) {
+            delete_scheduled_removals();
+            close_removal_idle();
+            uv_run(this, UV_RUN_NOWAIT);
+        }
+
         uv_loop_close(this);
         IO_LOG(m_loop, DEBUG, "Done");
     }
@@ -159,6 +330,28 @@ void EventLoop::Impl::finish() {
 EventLoop::Impl::~Impl() {
 }
 
+void EventLoop::Impl::delete_scheduled_removals() {
+    while (!m_scheduled_removals.empty()) {
+        std::vector<Removable*> removals;
+        removals.swap(m_scheduled_removals);
+
+        for (auto removable : removals) {
+            removable->notify_removal();
+        }
+
+        for (auto removable : removals) {
+            delete removable;
+        }
+    }
+}
+
+void EventLoop::Impl::close_removal_idle() {
+    if (m_removal_idle) {
+        uv_close(reinterpret_cast<uv_handle_t*>(m_removal_idle), on_removal_idle_close);
+        m_removal_idle = nullptr;
+    }
+}
+
 void EventLoop::Impl::schedule_callback(WorkCallback callback) {
     if (m_sync_callbacks_queue.empty()) {
         m_sync_callbacks_executor_handle = schedule_call_on_each_loop_cycle(m_sync_callbacks_executor_function);
@@ -183,65 +376,209 @@ Error EventLoop::Impl::init_async() {
     return StatusCode::OK;
 }
 
-namespace {
+template<typename WorkCallbackType, typename WorkDoneCallbackType>
+void EventLoop::Impl::add_work(WorkCallbackType work_callback, WorkDoneCallbackType work_done_callback) {
+    if (work_callback == nullptr) {
+        return;
+    }
 
-template <typename WorkCallbackType, typename WorkDoneCallbackType>
-struct Work : public uv_work_t {
-    WorkCallbackType work_callback;
-    WorkDoneCallbackType work_done_callback;
+    auto work = acquire_work<Work<WorkCallbackType, WorkDoneCallbackType>>();
+    work->work_callback = std::move(work_callback);
+    work->work_done_callback = std::move(work_done_callback);
 
-    void call_work_callback() {
-        if (work_callback) {
-            work_callback();
-        }
+    if (m_work_threads_count) {
+        add_work_to_pool(work);
+        return;
     }
 
-    void call_work_done_callback() {
-        if (work_done_callback) {
-            work_done_callback();
-        }
+    Error error = uv_queue_work(this,
+                                  work,
+                                  on_work<WorkCallbackType, WorkDoneCallbackType>,
+                                  on_after_work<WorkCallbackType, WorkDoneCallbackType>);
+    if (error) {
+        // TODO: error handling
     }
-};
 
-template <>
-struct Work<EventLoop::WorkCallbackWithUserData, EventLoop::WorkDoneCallbackWithUserData> : public uv_work_t {
-    EventLoop::WorkCallbackWithUserData work_callback;
-    EventLoop::WorkDoneCallbackWithUserData work_done_callback;
+}
 
-    void* user_data = nullptr;
+detail::WorkStealingThreadPool& EventLoop::Impl::work_pool() {
+    if (!m_work_pool) {
+        m_work_pool.reset(new detail::WorkStealingThreadPool(m_work_threads_count));
+    }
 
-    void call_work_callback() {
-        if (work_callback) {
-            user_data = work_callback();
-        }
+    return *m_work_pool;
+}
+
+std::vector<PlainWork*>& EventLoop::Impl::free_works(PlainWork*) {
+    return m_free_works;
+}
+
+std::vector<WorkWithUserData*>& EventLoop::Impl::free_works(WorkWithUserData*) {
+    return m_free_works_with_user_data;
+}
+
+template<typename WorkType>
+WorkType* EventLoop::Impl::acquire_work() {
+    auto& free_list = free_works(static_cast<WorkType*>(nullptr));
+    if (free_list.empty()) {
+        ++m_allocated_work_requests_count;
+        return new WorkType;
     }
 
-    void call_work_done_callback() {
-        if (work_done_callback) {
-            work_done_callback(user_data);
+    ++m_reused_work_requests_count;
+    auto work = free_list.back();
+    free_list.pop_back();
+    return work;
+}
+
+template<typename WorkType>
+void EventLoop::Impl::release_work(WorkType* work) {
+    auto& free_list = free_works(static_cast<WorkType*>(nullptr));
+    if (free_list.size() >= MAX_FREE_WORK_REQUESTS_COUNT) {
+        delete work;
+        return;
+    }
+
+    work->reset();
+    free_list.push_back(work);
+}
+
+std::size_t EventLoop::Impl::allocated_work_requests_count() const {
+    return m_allocated_work_requests_count;
+}
+
+std::size_t EventLoop::Impl::reused_work_requests_count() const {
+    return m_reused_work_requests_count;
+}
+
+template<typename WorkType>
+void EventLoop::Impl::add_work_to_pool(WorkType* work) {
+    // Async handle is referenced while there are pending works to keep the loop running
+    if (m_pending_pool_works_count++ == 0 && m_async) {
+        uv_ref(reinterpret_cast<uv_handle_t*>(m_async.get()));
+    }
+
+    work->data = this;
+    work->complete = &EventLoop::Impl::on_pool_work_complete<WorkType>;
+
+    work_pool().submit([this, work]() {
+        work->call_work_callback();
+        push_completed_work(work);
+    });
+}
+
+void EventLoop::Impl::push_completed_work(WorkBase* work) {
+    // Request itself is a node of the list, so reporting completion does not allocate
+    auto head = m_completed_works.load(std::memory_order_relaxed);
+    do {
+        work->next_completed = head;
+    } while (!m_completed_works.compare_exchange_weak(head, work, std::memory_order_release, std::memory_order_relaxed));
+
+    notify_async();
+}
+
+std::size_t EventLoop::Impl::execute_completed_works() {
+    WorkBase* reversed = m_completed_works.exchange(nullptr, std::memory_order_acquire);
+
+    WorkBase* ordered = nullptr;
+    while (reversed) {
+        auto next = reversed->next_completed;
+        reversed->next_completed = ordered;
+        ordered = reversed;
+        reversed = next;
+    }
+
+    std::size_t count = 0;
+    while (ordered) {
+        auto next = ordered->next_completed;
+        ordered->complete(*ordered);
+        ordered = next;
+        ++count;
+    }
+
+    return count;
+}
+
+namespace {
+
+struct ParallelForState {
+    std::atomic<std::size_t> next_index;
+    std::size_t end = 0;
+    std::size_t grain = 1;
+    EventLoop::ParallelForBodyCallback body_callback;
+    EventLoop::ParallelForDoneCallback done_callback;
+    std::size_t pending_works_count = 0; // accessed only from the loop thread
+
+    void process_chunks() {
+        while (true) {
+            const std::size_t chunk_begin = next_index.fetch_add(grain, std::memory_order_relaxed);
+            if (chunk_begin >= end) {
+                break;
+            }
+
+            body_callback(chunk_begin, chunk_begin + (std::min)(grain, end - chunk_begin));
         }
     }
 };
 
+// Mirrors initialization of libuv's thread pool which is created once per process
+std::size_t uv_thread_pool_size() {
+    static const std::size_t size = []() {
+        // Defaults and limits of libuv's threadpool.c
+        unsigned int threads_count = 4;
+        const char* value = std::getenv("UV_THREADPOOL_SIZE");
+        if (value != nullptr) {
+            threads_count = static_cast<unsigned int>(std::atoi(value));
+        }
+
+        return static_cast<std::size_t>((std::max)(1u, (std::min)(threads_count, 1024u)));
+    }();
+
+    return size;
+}
+
 } // namespace
 
-template<typename WorkCallbackType, typename WorkDoneCallbackType>
-void EventLoop::Impl::add_work(WorkCallbackType work_callback, WorkDoneCallbackType work_done_callback) {
-    if (work_callback == nullptr) {
+void EventLoop::Impl::parallel_for(std::size_t begin,
+                                   std::size_t end,
+                                   std::size_t grain,
+                                   ParallelForBodyCallback body_callback,
+                                   ParallelForDoneCallback done_callback) {
+    if (body_callback == nullptr || begin >= end) {
+        if (done_callback) {
+            schedule_callback(done_callback);
+        }
         return;
     }
 
-    auto work = new Work<WorkCallbackType, WorkDoneCallbackType>;
-    work->work_callback = work_callback;
-    work->work_done_callback = work_done_callback;
-    Error error = uv_queue_work(this,
-                                  work,
-                                  on_work<WorkCallbackType, WorkDoneCallbackType>,
-                                  on_after_work<WorkCallbackType, WorkDoneCallbackType>);
-    if (error) {
-        // TODO: error handling
+    if (grain == 0) {
+        grain = 1;
     }
 
+    const std::size_t chunks_count = (end - begin) / grain + ((end - begin) % grain ? 1 : 0);
+
+    const std::size_t threads_count = m_work_threads_count ? work_pool().threads_count() : uv_thread_pool_size();
+
+    // Instead of a work per chunk, every work takes chunks from the shared counter until range is exhausted
+    auto state = std::make_shared<ParallelForState>();
+    state->next_index = begin;
+    state->end = end;
+    state->grain = grain;
+    state->body_callback = std::move(body_callback);
+    state->done_callback = std::move(done_callback);
+    state->pending_works_count = (std::min)(chunks_count, threads_count);
+
+    for (std::size_t i = 0; i < state->pending_works_count; ++i) {
+        add_work<WorkCallback, WorkDoneCallback>(
+            [state]() {
+                state->process_chunks();
+            },
+            [state]() {
+                if (--state->pending_works_count == 0 && state->done_callback) {
+                    state->done_callback();
+                }
+            });
+    }
 }
 
 int EventLoop::Impl::run() {
@@ -256,12 +593,7 @@ int EventLoop::Impl::run() {
 
         // If there were pending async callbacks after the loop exit, executing one more run
         // because some new events may be scheduled right away.
-        {
-            std::lock_guard<std::mutex> guard(m_async_callbacks_queue_mutex);
-            has_pending_callbacks = m_async_callbacks_queue.size();
-        }
-
-        execute_pending_callbacks();
+        has_pending_callbacks = execute_pending_callbacks();
     } while(run_status == 0 && has_pending_callbacks);
 
     m_is_running = false;
@@ -269,6 +601,68 @@ int EventLoop::Impl::run() {
     return run_status;
 }
 
+void EventLoop::Impl::schedule_removal(Removable& removable) {
+    m_scheduled_removals.push_back(&removable);
+
+    if (m_removal_idle == nullptr) {
+        auto removal_idle = new uv_idle_t;
+        const Error init_error = uv_idle_init(this, removal_idle);
+        if (init_error) {
+            // Scheduled objects are deleted when loop finishes, next removal makes one more attempt
+            IO_LOG(m_loop, ERROR, "removal idle init failed:", init_error.string());
+            delete removal_idle;
+            return;
+        }
+
+        removal_idle->data = this;
+        m_removal_idle = removal_idle;
+    }
+
+    if (!uv_is_active(reinterpret_cast<uv_handle_t*>(m_removal_idle))) {
+        uv_idle_start(m_removal_idle, on_removal_idle);
+    }
+}
+
+std::size_t EventLoop::Impl::pending_removals_count() const {
+    return m_scheduled_removals.size() + m_notified_removals_count;
+}
+
+detail::ReadBufferPool& EventLoop::Impl::read_buffer_pool() {
+    return m_read_buffer_pool;
+}
+
+void EventLoop::Impl::notify_removals() {
+    auto batch = new RemovalBatch;
+    // Objects scheduled for removal from callbacks below are processed on the next cycle
+    batch->removals.swap(m_scheduled_removals);
+    m_notified_removals_count += batch->removals.size();
+
+    for (auto removable : batch->removals) {
+        removable->notify_removal();
+    }
+
+    if (m_scheduled_removals.empty()) {
+        uv_idle_stop(m_removal_idle);
+    }
+
+    // Close callbacks are called in reverse order, so handles closed in this loop cycle before deletion
+    // of objects (by these objects too) are processed first. This is the same as closing handle per object.
+    const Error init_error = uv_idle_init(this, batch);
+    if (init_error) {
+        // Objects are already notified, so they could not wait for the next attempt
+        IO_LOG(m_loop, ERROR, "removal batch init failed:", init_error.string());
+        m_notified_removals_count -= batch->removals.size();
+        for (auto removable : batch->removals) {
+            delete removable;
+        }
+        delete batch;
+        return;
+    }
+
+    batch->data = this;
+    uv_close(reinterpret_cast<uv_handle_t*>(batch), on_removal_batch_close);
+}
+
 std::size_t EventLoop::Impl::schedule_call_on_each_loop_cycle(EachLoopCycleCallback callback) {
     std::unique_ptr<Idle> ptr(new Idle);
     uv_idle_init(this, ptr.get());
@@ -326,29 +720,49 @@ void EventLoop::Impl::stop_dummy_idle() {
 }
 
 void EventLoop::Impl::execute_on_loop_thread(AsyncCallback callback) {
-    {
-        std::lock_guard<std::mutex> guard(m_async_callbacks_queue_mutex);
-        m_async_callbacks_queue.push_back(callback);
+    m_async_callbacks_queue.push(std::move(callback));
+    notify_async();
+}
+
+void EventLoop::Impl::execute_on_loop_thread(std::vector<AsyncCallback>&& callbacks) {
+    if (callbacks.empty()) {
+        return;
+    }
+
+    m_async_callbacks_queue.push(std::move(callbacks));
+    notify_async();
+}
+
+void EventLoop::Impl::notify_async() {
+    // Only transition from 'drained' to 'has data' wakes up the loop
+    if (m_async_notified.exchange(true, std::memory_order_acq_rel)) {
+        return;
     }
 
-    uv_async_send(m_async.get());
+    if (m_async) {
+        uv_async_send(m_async.get());
+    }
 }
 
 bool EventLoop::Impl::is_running() const {
     return m_is_running;
 }
 
-void EventLoop::Impl::execute_pending_callbacks() {
-    std::deque<std::function<void()>> callbacks_queue_copy;
+bool EventLoop::Impl::execute_pending_callbacks() {
+    // Flag is reset before draining, so producer which pushed after this point will signal again
+    m_async_notified.store(false, std::memory_order_seq_cst);
 
-    {
-        std::lock_guard<decltype(m_async_callbacks_queue_mutex)> guard(m_async_callbacks_queue_mutex);
-        m_async_callbacks_queue.swap(callbacks_queue_copy);
-    }
+    auto count = execute_completed_works();
 
-    for(auto& callback : callbacks_queue_copy) {
-        callback();
-    }
+    count += m_async_callbacks_queue.consume_all([](AsyncCallback& callback) {
+        if (callback) {
+            callback();
+        }
+    });
+
+    return count != 0 ||
+           !m_async_callbacks_queue.empty() ||
+           m_completed_works.load(std::memory_order_acquire) != nullptr;
 }
 
 ////////////////////////////////////////////// static //////////////////////////////////////////////
@@ -362,9 +776,28 @@ template<typename WorkCallbackType, typename WorkDoneCallbackType>
 void EventLoop::Impl::on_after_work(uv_work_t* req, int status) {
     // TODO: check cancel status????
     auto& work = *reinterpret_cast<Work<WorkCallbackType, WorkDoneCallbackType>*>(req);
+    auto& this_ = *reinterpret_cast<EventLoop::Impl*>(req->loop);
     work.call_work_done_callback();
 
-    delete &work;
+    this_.release_work(&work);
+}
+
+template<typename WorkType>
+void EventLoop::Impl::on_pool_work_complete(WorkBase& base_work) {
+    auto& work = static_cast<WorkType&>(base_work);
+    if (work.data == nullptr) { // loop is finished
+        delete &work;
+        return;
+    }
+
+    auto& this_ = *reinterpret_cast<EventLoop::Impl*>(work.data);
+    work.call_work_done_callback();
+
+    this_.release_work(&work);
+
+    if (--this_.m_pending_pool_works_count == 0 && this_.m_async) {
+        uv_unref(reinterpret_cast<uv_handle_t*>(this_.m_async.get()));
+    }
 }
 
 void EventLoop::Impl::on_idle(uv_idle_t* handle) {
@@ -396,6 +829,29 @@ void EventLoop::Impl::on_async(uv_async_t* handle) {
     this_.execute_pending_callbacks();
 }
 
+void EventLoop::Impl::on_removal_idle(uv_idle_t* handle) {
+    auto& this_ = *reinterpret_cast<EventLoop::Impl*>(handle->data);
+    this_.notify_removals();
+}
+
+void EventLoop::Impl::on_removal_idle_close(uv_handle_t* handle) {
+    delete reinterpret_cast<uv_idle_t*>(handle);
+}
+
+void EventLoop::Impl::on_removal_batch_close(uv_handle_t* handle) {
+    auto batch = reinterpret_cast<RemovalBatch*>(handle);
+    auto& this_ = *reinterpret_cast<EventLoop::Impl*>(batch->data);
+
+    this_.m_notified_removals_count -= batch->removals.size();
+
+    // Destructors may schedule removal of other objects
+    for (auto removable : batch->removals) {
+        delete removable;
+    }
+
+    delete batch;
+}
+
 void EventLoop::Impl::on_dummy_idle_tick(uv_timer_t* handle) {
     auto& this_ = *reinterpret_cast<EventLoop::Impl*>(handle->data);
     IO_LOG(this_.m_loop, TRACE, "_");
@@ -419,8 +875,12 @@ std::atomic<std::size_t> m_loop_id_counter(0);
 } // namespace
 
 EventLoop::EventLoop() :
+    EventLoop(0) {
+}
+
+EventLoop::EventLoop(std::size_t work_threads_count) :
     Logger("Loop-" + std::to_string(m_loop_id_counter++)),
-    m_impl(new EventLoop::Impl(*this)) {
+    m_impl(new EventLoop::Impl(*this, work_threads_count)) {
     if (global::logger_callback()) {
         enable_log(global::logger_callback());
     }
@@ -431,15 +891,35 @@ EventLoop::~EventLoop() {
 }
 
 void EventLoop::execute_on_loop_thread(AsyncCallback callback) {
-    m_impl->execute_on_loop_thread(callback);
+    m_impl->execute_on_loop_thread(std::move(callback));
+}
+
+void EventLoop::execute_on_loop_thread(std::vector<AsyncCallback>&& callbacks) {
+    m_impl->execute_on_loop_thread(std::move(callbacks));
 }
 
 void EventLoop::add_work(WorkCallback work_callback, WorkDoneCallback work_done_callback) {
-    return m_impl->add_work(work_callback, work_done_callback);
+    return m_impl->add_work(std::move(work_callback), std::move(work_done_callback));
 }
 
 void EventLoop::add_work(WorkCallbackWithUserData work_callback, WorkDoneCallbackWithUserData work_done_callback) {
-    return m_impl->add_work(work_callback, work_done_callback);
+    return m_impl->add_work(std::move(work_callback), std::move(work_done_callback));
+}
+
+std::size_t EventLoop::allocated_work_requests_count() const {
+    return m_impl->allocated_work_requests_count();
+}
+
+std::size_t EventLoop::reused_work_requests_count() const {
+    return m_impl->reused_work_requests_count();
+}
+
+void EventLoop::parallel_for(std::size_t begin,
+                             std::size_t end,
+                             std::size_t grain,
+                             ParallelForBodyCallback body_callback,
+                             ParallelForDoneCallback done_callback) {
+    return m_impl->parallel_for(begin, end, grain, body_callback, done_callback);
 }
 
 std::size_t EventLoop::schedule_call_on_each_loop_cycle(EachLoopCycleCallback callback) {
@@ -466,6 +946,26 @@ bool EventLoop::is_running() const {
     return m_impl->is_running();
 }
 
+std::size_t EventLoop::pending_removals_count() const {
+    return m_impl->pending_removals_count();
+}
+
+std::size_t EventLoop::read_buffer_pool_hits() const {
+    return m_impl->read_buffer_pool().hits();
+}
+
+std::size_t EventLoop::read_buffer_pool_misses() const {
+    return m_impl->read_buffer_pool().misses();
+}
+
+detail::ReadBufferPool& EventLoop::read_buffer_pool() {
+    return m_impl->read_buffer_pool();
+}
+
+void EventLoop::schedule_removal(Removable& removable) {
+    return m_impl->schedule_removal(removable);
+}
+
 void* EventLoop::raw_loop() {
     return m_impl.get();
 }
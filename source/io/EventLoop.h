@@ -8,13 +8,23 @@
 #include <functional>
 #include <memory>
 #include <limits>
-
-// TODO: memory pool for objects allocations???
+#include <vector>
 
 // DOC: calling some loop methods and not calling run() will result in memory leak
 
 namespace io {
 
+class Removable;
+
+namespace detail {
+
+class ReadBufferPool;
+
+template<typename ParentType, typename ImplType>
+class TcpClientImplBase;
+
+} // namespace detail
+
 class EventLoop : public Logger,
                   public UserDataHolder {
 public:
@@ -27,21 +37,58 @@ public:
     using WorkCallbackWithUserData = std::function<void*()>;
     using WorkDoneCallbackWithUserData = std::function<void(void*)>;
 
+    using ParallelForBodyCallback = std::function<void(std::size_t begin, std::size_t end)>;
+    using ParallelForDoneCallback = std::function<void()>;
+
     static const std::size_t INVALID_HANDLE = (std::numeric_limits<std::size_t>::max)();
 
     IO_FORBID_COPY(EventLoop);
     IO_FORBID_MOVE(EventLoop);
 
     IO_DLL_PUBLIC EventLoop();
+    // Works added by add_work are executed on the loop's own work stealing thread pool
+    // of 'work_threads_count' threads instead of libuv's global one, which is left for file system operations.
+    // 0 means default behavior (libuv's thread pool).
+    IO_DLL_PUBLIC explicit EventLoop(std::size_t work_threads_count);
     IO_DLL_PUBLIC ~EventLoop();
 
-    // Executed on thread pool
+    // Executed on thread pool, work_done_callback is executed on the loop's thread
     IO_DLL_PUBLIC void add_work(WorkCallback work_callback, WorkDoneCallback work_done_callback = nullptr);
     IO_DLL_PUBLIC void add_work(WorkCallbackWithUserData work_callback, WorkDoneCallbackWithUserData work_done_callback = nullptr);
 
+    // Work requests are recycled on the loop's thread. In steady state reused count grows
+    // while allocated count stays the same.
+    IO_DLL_PUBLIC std::size_t allocated_work_requests_count() const;
+    IO_DLL_PUBLIC std::size_t reused_work_requests_count() const;
+
+    // Splits range [begin, end) into chunks of 'grain' size and calls body_callback for each chunk on thread pool.
+    // Chunks are taken dynamically by at most one work per pool thread (size of libuv's pool is defined
+    // by UV_THREADPOOL_SIZE, 4 by default). done_callback is called once on the loop's thread after
+    // all chunks were processed.
+    IO_DLL_PUBLIC void parallel_for(std::size_t begin,
+                                    std::size_t end,
+                                    std::size_t grain,
+                                    ParallelForBodyCallback body_callback,
+                                    ParallelForDoneCallback done_callback = nullptr);
+
+    // Calls map_callback for each chunk as parallel_for does, results of chunks are combined with
+    // reduce_callback in order of chunks on the loop's thread and passed to done_callback.
+    // Example: loop.map_reduce<int>(0, 100, 10, map, reduce, 0, done);
+    template<typename ResultType>
+    void map_reduce(std::size_t begin,
+                    std::size_t end,
+                    std::size_t grain,
+                    std::function<ResultType(std::size_t begin, std::size_t end)> map_callback,
+                    std::function<ResultType(const ResultType& accumulated, const ResultType& value)> reduce_callback,
+                    ResultType initial_value,
+                    std::function<void(const ResultType& result)> done_callback);
+
     // Call callback on the EventLoop's thread. Could be executed from any thread
     // Note: this method is thread safe
     IO_DLL_PUBLIC void execute_on_loop_thread(AsyncCallback callback);
+    // All callbacks are published at once and executed in the same order.
+    // Note: this method is thread safe
+    IO_DLL_PUBLIC void execute_on_loop_thread(std::vector<AsyncCallback>&& callbacks);
 
     // Schedule on loop's thread, will block loop. Not thread safe.
     IO_DLL_PUBLIC void schedule_callback(WorkCallback callback);
@@ -60,12 +107,69 @@ public:
 
     IO_DLL_PUBLIC bool is_running() const;
 
+    // Number of objects which removal was scheduled but which are not deleted yet.
+    // Removed objects are collected during loop cycle and deleted all at once.
+    IO_DLL_PUBLIC std::size_t pending_removals_count() const;
+
+    // Read buffers of TCP connections are taken from the loop-wide pool for the time of a single read
+    // and return there unless retained by user (via DataChunk). Miss means that new buffer was allocated.
+    IO_DLL_PUBLIC std::size_t read_buffer_pool_hits() const;
+    IO_DLL_PUBLIC std::size_t read_buffer_pool_misses() const;
+
     // TODO: make private???
     IO_DLL_PUBLIC void* raw_loop();
 
 private:
+    friend class Removable;
+    template<typename ParentType, typename ImplType>
+    friend class detail::TcpClientImplBase;
+
+    // Interface for Removable
+    void schedule_removal(Removable& removable);
+
+    // Interface for TCP connections
+    detail::ReadBufferPool& read_buffer_pool();
+
     class Impl;
     std::unique_ptr<Impl> m_impl;
 };
 
+template<typename ResultType>
+void EventLoop::map_reduce(std::size_t begin,
+                           std::size_t end,
+                           std::size_t grain,
+                           std::function<ResultType(std::size_t begin, std::size_t end)> map_callback,
+                           std::function<ResultType(const ResultType& accumulated, const ResultType& value)> reduce_callback,
+                           ResultType initial_value,
+                           std::function<void(const ResultType& result)> done_callback) {
+    if (map_callback == nullptr || reduce_callback == nullptr) {
+        return;
+    }
+
+    if (grain == 0) {
+        grain = 1;
+    }
+
+    const std::size_t chunks_count = begin < end ? (end - begin) / grain + ((end - begin) % grain ? 1 : 0) : 0;
+
+    // Each chunk writes only its own slot, so no synchronization is required.
+    // Plain array is used instead of vector because of vector<bool> specialization.
+    std::shared_ptr<ResultType> results(new ResultType[chunks_count], std::default_delete<ResultType[]>());
+
+    parallel_for(begin, end, grain,
+        [=](std::size_t chunk_begin, std::size_t chunk_end) {
+            results.get()[(chunk_begin - begin) / grain] = map_callback(chunk_begin, chunk_end);
+        },
+        [=]() {
+            ResultType accumulated = initial_value;
+            for (std::size_t i = 0; i < chunks_count; ++i) {
+                accumulated = reduce_callback(accumulated, results.get()[i]);
+            }
+
+            if (done_callback) {
+                done_callback(accumulated);
+            }
+        });
+}
+
 } // namespace io
@@ -0,0 +1,162 @@
+#include "EventLoopGroup.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <assert.h>
+
+namespace io {
+
+class EventLoopGroup::Impl {
+public:
+    Impl(std::size_t loops_count);
+    ~Impl();
+
+    std::size_t size() const;
+
+    EventLoop& loop(std::size_t index);
+    const EventLoop& loop(std::size_t index) const;
+
+    EventLoop& next_loop();
+
+    void execute_on_each_loop_thread(EachLoopCallback callback);
+
+    int run();
+
+    bool is_running() const;
+
+private:
+    std::vector<std::unique_ptr<EventLoop>> m_loops;
+    std::size_t m_next_loop_index = 0;
+
+    std::atomic<bool> m_is_running;
+};
+
+EventLoopGroup::Impl::Impl(std::size_t loops_count) :
+    m_is_running(false) {
+    if (loops_count == 0) {
+        loops_count = std::thread::hardware_concurrency();
+    }
+
+    // hardware_concurrency may return 0 if value is not computable
+    if (loops_count == 0) {
+        loops_count = 1;
+    }
+
+    m_loops.reserve(loops_count);
+    for (std::size_t i = 0; i < loops_count; ++i) {
+        m_loops.emplace_back(new EventLoop);
+    }
+}
+
+EventLoopGroup::Impl::~Impl() {
+    assert(!m_is_running && "EventLoopGroup should not be destroyed while it is running");
+}
+
+std::size_t EventLoopGroup::Impl::size() const {
+    return m_loops.size();
+}
+
+EventLoop& EventLoopGroup::Impl::loop(std::size_t index) {
+    assert(index < m_loops.size());
+    return *m_loops[index];
+}
+
+const EventLoop& EventLoopGroup::Impl::loop(std::size_t index) const {
+    assert(index < m_loops.size());
+    return *m_loops[index];
+}
+
+EventLoop& EventLoopGroup::Impl::next_loop() {
+    auto& result = *m_loops[m_next_loop_index];
+    m_next_loop_index = (m_next_loop_index + 1) % m_loops.size();
+    return result;
+}
+
+void EventLoopGroup::Impl::execute_on_each_loop_thread(EachLoopCallback callback) {
+    if (callback == nullptr) {
+        return;
+    }
+
+    for (auto& loop : m_loops) {
+        auto loop_ptr = loop.get();
+        loop->execute_on_loop_thread([callback, loop_ptr]() {
+            callback(*loop_ptr);
+        });
+    }
+}
+
+int EventLoopGroup::Impl::run() {
+    m_is_running = true;
+
+    std::vector<int> statuses(m_loops.size(), 0);
+
+    // The first loop is executed in the calling thread
+    std::vector<std::thread> threads;
+    threads.reserve(m_loops.size() - 1);
+    for (std::size_t i = 1; i < m_loops.size(); ++i) {
+        threads.emplace_back([this, i, &statuses]() {
+            statuses[i] = m_loops[i]->run();
+        });
+    }
+
+    statuses[0] = m_loops[0]->run();
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    m_is_running = false;
+
+    for (auto status : statuses) {
+        if (status) {
+            return status;
+        }
+    }
+
+    return 0;
+}
+
+bool EventLoopGroup::Impl::is_running() const {
+    return m_is_running;
+}
+
+///////////////////////////////////////// implementation ///////////////////////////////////////////
+
+EventLoopGroup::EventLoopGroup(std::size_t loops_count) :
+    m_impl(new Impl(loops_count)) {
+}
+
+EventLoopGroup::~EventLoopGroup() {
+}
+
+std::size_t EventLoopGroup::size() const {
+    return m_impl->size();
+}
+
+EventLoop& EventLoopGroup::loop(std::size_t index) {
+    return m_impl->loop(index);
+}
+
+const EventLoop& EventLoopGroup::loop(std::size_t index) const {
+    return m_impl->loop(index);
+}
+
+EventLoop& EventLoopGroup::next_loop() {
+    return m_impl->next_loop();
+}
+
+void EventLoopGroup::execute_on_each_loop_thread(EachLoopCallback callback) {
+    return m_impl->execute_on_each_loop_thread(callback);
+}
+
+int EventLoopGroup::run() {
+    return m_impl->run();
+}
+
+bool EventLoopGroup::is_running() const {
+    return m_impl->is_running();
+}
+
+} // namespace io
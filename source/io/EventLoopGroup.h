@@ -0,0 +1,49 @@
+#pragma once
+
+#include "CommonMacros.h"
+#include "EventLoop.h"
+#include "Export.h"
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+namespace io {
+
+// Set of independent event loops, each one is executed in its own thread by run().
+// Objects bound to some loop of the group should be accessed only from the thread of that loop.
+class EventLoopGroup {
+public:
+    using EachLoopCallback = std::function<void(EventLoop&)>;
+
+    IO_FORBID_COPY(EventLoopGroup);
+    IO_FORBID_MOVE(EventLoopGroup);
+
+    // If loops_count is 0, number of loops is equal to the number of hardware threads.
+    IO_DLL_PUBLIC EventLoopGroup(std::size_t loops_count = 0);
+    IO_DLL_PUBLIC ~EventLoopGroup();
+
+    IO_DLL_PUBLIC std::size_t size() const;
+
+    IO_DLL_PUBLIC EventLoop& loop(std::size_t index);
+    IO_DLL_PUBLIC const EventLoop& loop(std::size_t index) const;
+
+    // Round robin selection of loops. Not thread safe.
+    IO_DLL_PUBLIC EventLoop& next_loop();
+
+    // Callback is executed on the thread of each loop.
+    // Note: this method is thread safe
+    IO_DLL_PUBLIC void execute_on_each_loop_thread(EachLoopCallback callback);
+
+    // Runs every loop in a separate thread and blocks until all of them finished.
+    // Returns first non-zero run status of loops or 0.
+    IO_DLL_PUBLIC int run();
+
+    IO_DLL_PUBLIC bool is_running() const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> m_impl;
+};
+
+} // namespace io
@@ -40,6 +40,8 @@ public:
 
     bool schedule_removal();
 
+    int native_handle() const;
+
 protected:
     // statics
     static void on_open(uv_fs_t* req);
@@ -119,6 +121,10 @@ bool File::Impl::is_open() const {
     return m_file_handle != -1;
 }
 
+int File::Impl::native_handle() const {
+    return m_file_handle;
+}
+
 void File::Impl::close() {
     if (!is_open()) {
         return;
@@ -470,6 +476,10 @@ const Path& File::path() const {
     return m_impl->path();
 }
 
+int File::native_handle() const {
+    return m_impl->native_handle();
+}
+
 void File::stat(StatCallback callback) {
     return m_impl->stat(callback);
 }
@@ -53,6 +53,12 @@ protected:
     IO_DLL_PUBLIC ~File();
 
 private:
+    template<typename ParentType, typename ImplType>
+    friend class detail::TcpClientImplBase;
+
+    // Interface for TCP connections which send file contents. Returns -1 if file is not open.
+    int native_handle() const;
+
     class Impl;
     std::unique_ptr<Impl> m_impl;
 };
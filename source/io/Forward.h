@@ -6,6 +6,8 @@ namespace io {
 class TcpServer;
 class TcpConnectedClient;
 class TcpClient;
+class TcpRelay;
+class ShardedTcpServer;
 
 class TlsTcpServer;
 class TlsTcpConnectedClient;
@@ -19,6 +21,14 @@ class UdpClient;
 class UdpServer;
 class UdpPeer;
 
+class EventLoop;
+class EventLoopGroup;
+
+class Timer;
+class TimerWheel;
+
+class File;
+
 class RefCounted;
 class Removable;
 
@@ -27,6 +37,7 @@ class Removable;
 namespace detail {
 
 struct PeerId;
+class TcpRelayHooks;
 
 } // namespace detail
 
@@ -0,0 +1,364 @@
+#pragma once
+
+#include "ByteSwap.h"
+#include "CommonMacros.h"
+#include "DataChunk.h"
+#include "Error.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <assert.h>
+
+namespace io {
+
+// Splits stream of the connection into messages (frames), each one is prefixed by the size of its payload.
+// ConnectionType is one of TcpClient, TcpConnectedClient, TlsTcpClient or TlsTcpConnectedClient.
+// Framer does not own the connection, received data should be passed to on_receive() from the receive
+// callback of the connection, for example:
+//
+//     io::FramedConnection<io::TcpClient> framer(on_frame);
+//     client->connect(endpoint, on_connect,
+//         [&](io::TcpClient& client, const io::DataChunk& chunk, const io::Error& error) {
+//             framer.on_receive(client, chunk);
+//         });
+//
+template<typename ConnectionType>
+class FramedConnection {
+public:
+    using FrameReceiveCallback = std::function<void(ConnectionType&, const DataChunk&, const Error&)>;
+    using EndSendCallback = typename ConnectionType::EndSendCallback;
+
+    enum class ByteOrder {
+        BIG,   // network byte order
+        LITTLE
+    };
+
+    static const std::size_t DEFAULT_MAX_FRAME_SIZE = 16 * 1024 * 1024;
+
+    IO_FORBID_COPY(FramedConnection);
+
+    FramedConnection(FramedConnection&& other) = default;
+    FramedConnection& operator=(FramedConnection&& other) = default;
+
+    // Prefix size could be 1, 2, 4 or 8 bytes.
+    FramedConnection(FrameReceiveCallback frame_callback,
+                     std::size_t prefix_size = 4,
+                     ByteOrder byte_order = ByteOrder::BIG,
+                     std::size_t max_frame_size = DEFAULT_MAX_FRAME_SIZE) :
+        m_frame_callback(std::move(frame_callback)),
+        m_prefix_size(prefix_size),
+        m_byte_order(byte_order),
+        m_max_frame_size(max_frame_size) {
+        assert(prefix_size == 1 || prefix_size == 2 || prefix_size == 4 || prefix_size == 8);
+    }
+
+    // Complete frames of the chunk are passed to the callback in order. Frame which is entirely inside
+    // the chunk shares the chunk's buffer and is not copied. Frames split between chunks are assembled in
+    // the buffer which is reused for the next ones while callback does not retain the previous frame.
+    // Offset of the frame is the position of its payload in the stream. Empty frames have null buffer.
+    // Frame larger than max_frame_size() is reported with MESSAGE_TOO_LONG error, after that the stream
+    // can not be parsed anymore and data is ignored until reset(). Usually connection is closed in this case.
+    void on_receive(ConnectionType& connection, const DataChunk& chunk);
+
+    // Prefix is written before the payload and both are sent by the single write of the connection.
+    // Payload larger than max_frame_size() or not representable by prefix is rejected with MESSAGE_TOO_LONG.
+    void send_frame(ConnectionType& connection, std::shared_ptr<const char> buffer, std::uint32_t size, EndSendCallback callback = nullptr);
+    void send_frame(ConnectionType& connection, const std::string& message, EndSendCallback callback = nullptr);
+
+    // Drops partially received frame and error state, for example when the connection is reused.
+    // Could be called from the frame callback, rest of the current chunk is ignored in this case.
+    void reset();
+
+    std::size_t prefix_size() const;
+    ByteOrder byte_order() const;
+    std::size_t max_frame_size() const;
+
+    // Statistics of delivered frames: shared with received chunks and assembled from several chunks.
+    std::size_t zero_copy_frames_count() const;
+    std::size_t reassembled_frames_count() const;
+
+private:
+    std::uint64_t decode_prefix(const char* data) const;
+    void encode_prefix(std::uint64_t size, char* data) const;
+    std::uint64_t max_prefix_value() const;
+
+    void prepare_reassembly_buffer(std::size_t size);
+    bool deliver_frame(ConnectionType& connection, const DataChunk& frame);
+
+    FrameReceiveCallback m_frame_callback;
+    std::size_t m_prefix_size;
+    ByteOrder m_byte_order;
+    std::size_t m_max_frame_size;
+
+    char m_prefix[8];
+    std::size_t m_prefix_bytes = 0;
+
+    bool m_in_frame = false;
+    bool m_failed = false;
+    std::size_t m_frame_size = 0;
+
+    std::shared_ptr<char> m_reassembly_buffer;
+    std::size_t m_reassembly_buffer_capacity = 0;
+    std::size_t m_reassembled_bytes = 0;
+
+    std::uint64_t m_stream_offset = 0;
+    std::size_t m_reset_counter = 0;
+
+    std::size_t m_zero_copy_frames_count = 0;
+    std::size_t m_reassembled_frames_count = 0;
+};
+
+///////////////////////////////////////// implementation ///////////////////////////////////////////
+
+template<typename ConnectionType>
+const std::size_t FramedConnection<ConnectionType>::DEFAULT_MAX_FRAME_SIZE;
+
+template<typename ConnectionType>
+void FramedConnection<ConnectionType>::on_receive(ConnectionType& connection, const DataChunk& chunk) {
+    if (m_failed || chunk.size == 0 || chunk.buf == nullptr) {
+        return;
+    }
+
+    const char* const data = chunk.buf.get();
+    std::size_t position = 0;
+
+    while (position < chunk.size) {
+        const std::size_t available = chunk.size - position;
+
+        if (m_in_frame) {
+            const std::size_t bytes_to_copy = std::min(m_frame_size - m_reassembled_bytes, available);
+            std::memcpy(m_reassembly_buffer.get() + m_reassembled_bytes, data + position, bytes_to_copy);
+            m_reassembled_bytes += bytes_to_copy;
+            position += bytes_to_copy;
+
+            if (m_reassembled_bytes == m_frame_size) {
+                m_in_frame = false;
+                ++m_reassembled_frames_count;
+                if (!deliver_frame(connection, DataChunk(m_reassembly_buffer, m_frame_size, m_stream_offset))) {
+                    return;
+                }
+            }
+
+            continue;
+        }
+
+        std::uint64_t frame_size = 0;
+        if (m_prefix_bytes == 0 && available >= m_prefix_size) {
+            frame_size = decode_prefix(data + position);
+            position += m_prefix_size;
+        } else {
+            const std::size_t bytes_to_copy = std::min(m_prefix_size - m_prefix_bytes, available);
+            std::memcpy(m_prefix + m_prefix_bytes, data + position, bytes_to_copy);
+            m_prefix_bytes += bytes_to_copy;
+            position += bytes_to_copy;
+
+            if (m_prefix_bytes < m_prefix_size) {
+                break;
+            }
+
+            m_prefix_bytes = 0;
+            frame_size = decode_prefix(m_prefix);
+        }
+
+        m_stream_offset += m_prefix_size;
+
+        if (frame_size > m_max_frame_size) {
+            m_failed = true;
+            if (m_frame_callback) {
+                m_frame_callback(connection, DataChunk(), Error(StatusCode::MESSAGE_TOO_LONG));
+            }
+            return;
+        }
+
+        m_frame_size = static_cast<std::size_t>(frame_size);
+
+        if (m_frame_size == 0) {
+            if (!deliver_frame(connection, DataChunk(nullptr, 0, m_stream_offset))) {
+                return;
+            }
+        } else if (chunk.size - position >= m_frame_size) {
+            // Aliasing constructor, frame shares ownership of the chunk's buffer
+            std::shared_ptr<const char> frame_buf(chunk.buf, data + position);
+            position += m_frame_size;
+            ++m_zero_copy_frames_count;
+            if (!deliver_frame(connection, DataChunk(frame_buf, m_frame_size, m_stream_offset))) {
+                return;
+            }
+        } else {
+            prepare_reassembly_buffer(m_frame_size);
+            m_reassembled_bytes = 0;
+            m_in_frame = true;
+        }
+    }
+}
+
+template<typename ConnectionType>
+bool FramedConnection<ConnectionType>::deliver_frame(ConnectionType& connection, const DataChunk& frame) {
+    m_stream_offset += frame.size;
+
+    const auto reset_counter = m_reset_counter;
+    if (m_frame_callback) {
+        m_frame_callback(connection, frame, Error(0));
+    }
+
+    return reset_counter == m_reset_counter;
+}
+
+template<typename ConnectionType>
+void FramedConnection<ConnectionType>::prepare_reassembly_buffer(std::size_t size) {
+    // Buffer is still referenced by previously delivered frame, it can not be overwritten
+    if (m_reassembly_buffer && m_reassembly_buffer.use_count() == 1 && m_reassembly_buffer_capacity >= size) {
+        return;
+    }
+
+    const std::size_t capacity = std::max(size, m_reassembly_buffer_capacity);
+    m_reassembly_buffer.reset(new char[capacity], std::default_delete<char[]>());
+    m_reassembly_buffer_capacity = capacity;
+}
+
+template<typename ConnectionType>
+void FramedConnection<ConnectionType>::send_frame(ConnectionType& connection, std::shared_ptr<const char> buffer, std::uint32_t size, EndSendCallback callback) {
+    if (size > m_max_frame_size || size > max_prefix_value()) {
+        if (callback) {
+            callback(connection, Error(StatusCode::MESSAGE_TOO_LONG));
+        }
+        return;
+    }
+
+    std::shared_ptr<char> prefix(new char[m_prefix_size], std::default_delete<char[]>());
+    encode_prefix(size, prefix.get());
+
+    std::vector<DataChunk> chunks;
+    chunks.reserve(2);
+    chunks.emplace_back(std::move(prefix), m_prefix_size, 0);
+    chunks.emplace_back(std::move(buffer), size, 0);
+    connection.send_data(std::move(chunks), callback);
+}
+
+template<typename ConnectionType>
+void FramedConnection<ConnectionType>::send_frame(ConnectionType& connection, const std::string& message, EndSendCallback callback) {
+    if (message.size() > m_max_frame_size || message.size() > max_prefix_value()) {
+        if (callback) {
+            callback(connection, Error(StatusCode::MESSAGE_TOO_LONG));
+        }
+        return;
+    }
+
+    // Prefix and payload are copied to the one buffer
+    std::shared_ptr<char> buffer(new char[m_prefix_size + message.size()], std::default_delete<char[]>());
+    encode_prefix(message.size(), buffer.get());
+    std::memcpy(buffer.get() + m_prefix_size, message.data(), message.size());
+    connection.send_data(buffer, static_cast<std::uint32_t>(m_prefix_size + message.size()), callback);
+}
+
+template<typename ConnectionType>
+void FramedConnection<ConnectionType>::reset() {
+    m_prefix_bytes = 0;
+    m_in_frame = false;
+    m_failed = false;
+    m_frame_size = 0;
+    m_reassembled_bytes = 0;
+    m_stream_offset = 0;
+    ++m_reset_counter;
+}
+
+template<typename ConnectionType>
+std::uint64_t FramedConnection<ConnectionType>::decode_prefix(const char* data) const {
+    if (m_byte_order == ByteOrder::LITTLE) {
+        std::uint64_t result = 0;
+        for (std::size_t i = m_prefix_size; i > 0; --i) {
+            result = (result << 8) | static_cast<unsigned char>(data[i - 1]);
+        }
+        return result;
+    }
+
+    switch (m_prefix_size) {
+        case 1:
+            return static_cast<unsigned char>(data[0]);
+        case 2: {
+            unsigned short value = 0;
+            std::memcpy(&value, data, sizeof(value));
+            return network_to_host(value);
+        }
+        case 4: {
+            unsigned int value = 0;
+            std::memcpy(&value, data, sizeof(value));
+            return network_to_host(value);
+        }
+        default: {
+            unsigned long long value = 0;
+            std::memcpy(&value, data, sizeof(value));
+            return network_to_host(value);
+        }
+    }
+}
+
+template<typename ConnectionType>
+void FramedConnection<ConnectionType>::encode_prefix(std::uint64_t size, char* data) const {
+    if (m_byte_order == ByteOrder::LITTLE) {
+        for (std::size_t i = 0; i < m_prefix_size; ++i) {
+            data[i] = static_cast<char>((size >> (i * 8)) & 0xFF);
+        }
+        return;
+    }
+
+    switch (m_prefix_size) {
+        case 1:
+            data[0] = static_cast<char>(size);
+            break;
+        case 2: {
+            const unsigned short value = host_to_network(static_cast<unsigned short>(size));
+            std::memcpy(data, &value, sizeof(value));
+            break;
+        }
+        case 4: {
+            const unsigned int value = host_to_network(static_cast<unsigned int>(size));
+            std::memcpy(data, &value, sizeof(value));
+            break;
+        }
+        default: {
+            const unsigned long long value = host_to_network(static_cast<unsigned long long>(size));
+            std::memcpy(data, &value, sizeof(value));
+            break;
+        }
+    }
+}
+
+template<typename ConnectionType>
+std::uint64_t FramedConnection<ConnectionType>::max_prefix_value() const {
+    return m_prefix_size == 8 ? std::numeric_limits<std::uint64_t>::max() : (std::uint64_t(1) << (m_prefix_size * 8)) - 1;
+}
+
+template<typename ConnectionType>
+std::size_t FramedConnection<ConnectionType>::prefix_size() const {
+    return m_prefix_size;
+}
+
+template<typename ConnectionType>
+typename FramedConnection<ConnectionType>::ByteOrder FramedConnection<ConnectionType>::byte_order() const {
+    return m_byte_order;
+}
+
+template<typename ConnectionType>
+std::size_t FramedConnection<ConnectionType>::max_frame_size() const {
+    return m_max_frame_size;
+}
+
+template<typename ConnectionType>
+std::size_t FramedConnection<ConnectionType>::zero_copy_frames_count() const {
+    return m_zero_copy_frames_count;
+}
+
+template<typename ConnectionType>
+std::size_t FramedConnection<ConnectionType>::reassembled_frames_count() const {
+    return m_reassembled_frames_count;
+}
+
+} // namespace io
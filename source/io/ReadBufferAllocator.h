@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace io {
+
+// Allows to receive data directly into application owned memory (ring buffer, message arena, etc.)
+// instead of library's buffers. 'allocate' should return buffer of at least 'size' bytes or nullptr
+// if there is no memory, in that case receive fails with NO_BUFFER_SPACE_AVAILABLE error.
+// Received DataChunk refers to the returned buffer and 'release' is called when the last copy
+// of DataChunk is destroyed, or when buffer was not used. Note: if DataChunk is passed to other
+// thread, 'release' will be called there.
+// Both functions should be set, default constructed allocator means library's buffers.
+struct ReadBufferAllocator {
+    using AllocateFunction = std::function<char*(std::size_t size)>;
+    using ReleaseFunction = std::function<void(char* buffer)>;
+
+    ReadBufferAllocator() = default;
+
+    ReadBufferAllocator(AllocateFunction a, ReleaseFunction r) :
+        allocate(a),
+        release(r) {
+    }
+
+    bool is_set() const {
+        return allocate != nullptr;
+    }
+
+    bool is_valid() const {
+        return (allocate == nullptr) == (release == nullptr);
+    }
+
+    AllocateFunction allocate;
+    ReleaseFunction release;
+};
+
+} // namespace io
@@ -20,10 +20,7 @@ public:
 
     static DefaultDelete default_delete();
 
-protected:
-    // statics
-    static void on_removal(uv_idle_t* handle);
-    static void on_delete_idle_handle_close(uv_handle_t* handle);
+    void notify_removal();
 
 private:
     EventLoop* m_loop;
@@ -32,6 +29,7 @@ private:
     OnScheduleRemovalCallback m_on_remove_callback = nullptr;
 
     bool m_removal_scheduled = false;
+    bool m_removal_queued = false;
     bool m_about_to_remove = false;
 
     static Removable::DefaultDelete m_default_deleter;
@@ -67,12 +65,12 @@ void Removable::Impl::schedule_removal() {
 
     IO_LOG(m_loop, TRACE, m_parent, "");
 
-    auto idle_ptr = new uv_idle_t;
-    idle_ptr->data = this;
+    if (m_removal_queued) {
+        return;
+    }
 
-    // TODO: error handling
-    Error init_error = uv_idle_init(reinterpret_cast<uv_loop_t*>(m_loop->raw_loop()), idle_ptr);
-    Error start_error = uv_idle_start(idle_ptr, on_removal);
+    m_removal_queued = true;
+    m_loop->schedule_removal(*m_parent);
 }
 
 void Removable::Impl::set_on_schedule_removal(OnScheduleRemovalCallback callback) {
@@ -83,28 +81,16 @@ void Removable::Impl::set_on_schedule_removal(OnScheduleRemovalCallback callback
     m_on_remove_callback = callback;
 }
 
-////////////////////////////////////////////// static //////////////////////////////////////////////
-
-void Removable::Impl::on_delete_idle_handle_close(uv_handle_t* handle) {
-    auto& this_ = *reinterpret_cast<Removable::Impl*>(handle->data);
-
-    delete this_.m_parent;
-    delete reinterpret_cast<uv_idle_t*>(handle);
-}
-
-void Removable::Impl::on_removal(uv_idle_t* handle) {
-    auto& this_ = *reinterpret_cast<Removable::Impl*>(handle->data);
+void Removable::Impl::notify_removal() {
+    m_about_to_remove = true;
 
-    this_.m_about_to_remove = true;
-
-    if (this_.m_on_remove_callback) {
-        this_.m_on_remove_callback(*this_.m_parent);
+    if (m_on_remove_callback) {
+        m_on_remove_callback(*m_parent);
     }
-
-    uv_idle_stop(handle);
-    uv_close(reinterpret_cast<uv_handle_t*>(handle), on_delete_idle_handle_close);
 }
 
+////////////////////////////////////////////// static //////////////////////////////////////////////
+
 Removable::DefaultDelete Removable::Impl::default_delete() {
     return m_default_deleter;
 }
@@ -138,4 +124,8 @@ void Removable::set_removal_scheduled() {
     return m_impl->set_removal_scheduled();
 }
 
+void Removable::notify_removal() {
+    return m_impl->notify_removal();
+}
+
 } // namespace io
@@ -10,6 +10,7 @@ namespace io {
 
 class IO_DLL_PUBLIC_CLASS_UNIX_ONLY Removable {
 public:
+    friend class EventLoop;
     friend class RefCounted;
 
     // Used for smart pointers
@@ -36,6 +37,9 @@ protected:
     IO_DLL_PUBLIC void set_removal_scheduled();
 
 private:
+    // Called by the loop right before object is deleted
+    void notify_removal();
+
     class Impl;
     std::unique_ptr<Impl> m_impl;
 };
@@ -0,0 +1,182 @@
+#include "ShardedTcpServer.h"
+
+#include <mutex>
+#include <vector>
+
+#include <assert.h>
+
+namespace io {
+
+class ShardedTcpServer::Impl {
+public:
+    Impl(EventLoopGroup& loop_group, ShardedTcpServer& parent);
+    ~Impl();
+
+    Error listen(const Endpoint& endpoint,
+                 NewConnectionCallback new_connection_callback,
+                 DataReceivedCallback data_receive_callback,
+                 CloseConnectionCallback close_connection_callback,
+                 int backlog_size);
+
+    void close(CloseServerCallback close_callback);
+
+    std::size_t shards_count() const;
+
+    TcpServer& shard(std::size_t index);
+
+    const Endpoint& endpoint() const;
+
+private:
+    ShardedTcpServer* m_parent;
+    EventLoopGroup* m_loop_group;
+
+    // Guards shards, because close could be called from any thread
+    mutable std::mutex m_shards_mutex;
+    std::vector<TcpServer*> m_shards;
+    bool m_closed = false;
+
+    Endpoint m_endpoint;
+};
+
+ShardedTcpServer::Impl::Impl(EventLoopGroup& loop_group, ShardedTcpServer& parent) :
+    m_parent(&parent),
+    m_loop_group(&loop_group) {
+}
+
+ShardedTcpServer::Impl::~Impl() {
+    close(nullptr);
+}
+
+Error ShardedTcpServer::Impl::listen(const Endpoint& endpoint,
+                                     NewConnectionCallback new_connection_callback,
+                                     DataReceivedCallback data_receive_callback,
+                                     CloseConnectionCallback close_connection_callback,
+                                     int backlog_size) {
+    std::lock_guard<std::mutex> guard(m_shards_mutex);
+
+    if (!m_shards.empty()) {
+        return Error(StatusCode::CONNECTION_ALREADY_IN_PROGRESS);
+    }
+
+    if (m_loop_group->is_running()) {
+        // Loops could not be accessed from the current thread
+        return Error(StatusCode::OPERATION_NOT_PERMITTED);
+    }
+
+    m_endpoint = endpoint;
+
+    for (std::size_t i = 0; i < m_loop_group->size(); ++i) {
+        auto server = new TcpServer(m_loop_group->loop(i));
+        server->reuse_port(true);
+
+        const auto listen_error = server->listen(endpoint,
+                                                 new_connection_callback,
+                                                 data_receive_callback,
+                                                 close_connection_callback,
+                                                 backlog_size);
+        if (listen_error) {
+            server->schedule_removal();
+            for (auto& shard : m_shards) {
+                shard->schedule_removal();
+            }
+            m_shards.clear();
+
+            return listen_error;
+        }
+
+        m_shards.push_back(server);
+    }
+
+    m_closed = false;
+
+    return Error(0);
+}
+
+void ShardedTcpServer::Impl::close(CloseServerCallback close_callback) {
+    std::lock_guard<std::mutex> guard(m_shards_mutex);
+
+    if (m_closed) {
+        return;
+    }
+    m_closed = true;
+
+    if (!m_loop_group->is_running()) {
+        // Loops will not execute posted callbacks until the next run (which may never happen),
+        // so shards are closed from the current thread, as in listen.
+        for (auto server : m_shards) {
+            if (close_callback) {
+                close_callback(*server, Error(0));
+            }
+
+            server->schedule_removal();
+        }
+
+        m_shards.clear();
+        return;
+    }
+
+    for (std::size_t i = 0; i < m_shards.size(); ++i) {
+        auto server = m_shards[i];
+        m_loop_group->loop(i).execute_on_loop_thread([server, close_callback]() {
+            server->close([close_callback](TcpServer& server, const Error& error) {
+                if (close_callback) {
+                    close_callback(server, error);
+                }
+
+                server.schedule_removal();
+            });
+        });
+    }
+
+    m_shards.clear();
+}
+
+std::size_t ShardedTcpServer::Impl::shards_count() const {
+    std::lock_guard<std::mutex> guard(m_shards_mutex);
+    return m_shards.size();
+}
+
+TcpServer& ShardedTcpServer::Impl::shard(std::size_t index) {
+    std::lock_guard<std::mutex> guard(m_shards_mutex);
+    assert(index < m_shards.size());
+    return *m_shards[index];
+}
+
+const Endpoint& ShardedTcpServer::Impl::endpoint() const {
+    return m_endpoint;
+}
+
+///////////////////////////////////////// implementation ///////////////////////////////////////////
+
+ShardedTcpServer::ShardedTcpServer(EventLoopGroup& loop_group) :
+    m_impl(new Impl(loop_group, *this)) {
+}
+
+ShardedTcpServer::~ShardedTcpServer() {
+}
+
+Error ShardedTcpServer::listen(const Endpoint& endpoint,
+                               NewConnectionCallback new_connection_callback,
+                               DataReceivedCallback data_receive_callback,
+                               CloseConnectionCallback close_connection_callback,
+                               int backlog_size) {
+    return m_impl->listen(endpoint, new_connection_callback, data_receive_callback, close_connection_callback, backlog_size);
+}
+
+void ShardedTcpServer::close(CloseServerCallback close_callback) {
+    return m_impl->close(close_callback);
+}
+
+std::size_t ShardedTcpServer::shards_count() const {
+    return m_impl->shards_count();
+}
+
+TcpServer& ShardedTcpServer::shard(std::size_t index) {
+    return m_impl->shard(index);
+}
+
+const Endpoint& ShardedTcpServer::endpoint() const {
+    return m_impl->endpoint();
+}
+
+} // namespace io
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "CommonMacros.h"
+#include "Endpoint.h"
+#include "Error.h"
+#include "EventLoopGroup.h"
+#include "Export.h"
+#include "TcpServer.h"
+#include "UserDataHolder.h"
+
+#include <cstddef>
+#include <memory>
+
+namespace io {
+
+// TCP server which listens on the same endpoint from each loop of EventLoopGroup.
+// Every loop owns its own listening socket bound with SO_REUSEPORT, so kernel spreads
+// incoming connections between loops. Connection is served by the loop which accepted it
+// and all callbacks are executed on the thread of that loop.
+// EventLoopGroup should outlive the server, because destructor closes shards on its loops.
+class ShardedTcpServer : public UserDataHolder {
+public:
+    using NewConnectionCallback = TcpServer::NewConnectionCallback;
+    using DataReceivedCallback = TcpServer::DataReceivedCallback;
+    using CloseConnectionCallback = TcpServer::CloseConnectionCallback;
+
+    using CloseServerCallback = TcpServer::CloseServerCallback;
+
+    IO_FORBID_COPY(ShardedTcpServer);
+    IO_FORBID_MOVE(ShardedTcpServer);
+
+    IO_DLL_PUBLIC ShardedTcpServer(EventLoopGroup& loop_group);
+    IO_DLL_PUBLIC ~ShardedTcpServer();
+
+    // Should be called before EventLoopGroup::run.
+    IO_DLL_PUBLIC
+    Error listen(const Endpoint& endpoint,
+                 NewConnectionCallback new_connection_callback,
+                 DataReceivedCallback data_receive_callback,
+                 CloseConnectionCallback close_connection_callback,
+                 int backlog_size = 128);
+
+    // Closes every shard on its own loop's thread. Callback is called once per shard.
+    // If EventLoopGroup is not running, shards are closed from the calling thread and
+    // callback is called right away.
+    // Subsequent calls do nothing until the next listen.
+    // Note: this method is thread safe
+    IO_DLL_PUBLIC void close(CloseServerCallback close_callback = nullptr);
+
+    IO_DLL_PUBLIC std::size_t shards_count() const;
+
+    // Shard should be accessed only from the thread of its loop and only until close
+    IO_DLL_PUBLIC TcpServer& shard(std::size_t index);
+
+    IO_DLL_PUBLIC const Endpoint& endpoint() const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> m_impl;
+};
+
+} // namespace io
@@ -28,6 +28,8 @@ public:
 
     void shutdown();
 
+    Error resume_reading();
+
     EventLoop* loop();
 
 protected:
@@ -137,11 +139,31 @@ void TcpClient::Impl::shutdown() {
         return;
     }
 
+    flush_corked_sends();
+
     auto shutdown_req = new uv_shutdown_t;
     shutdown_req->data = this;
     uv_shutdown(shutdown_req, reinterpret_cast<uv_stream_t*>(m_tcp_stream), on_shutdown);
 }
 
+Error TcpClient::Impl::resume_reading() {
+    if (!is_open()) {
+        return Error(StatusCode::NOT_CONNECTED);
+    }
+
+    if (!m_read_paused) {
+        return Error(0);
+    }
+
+    const Error error = uv_read_start(reinterpret_cast<uv_stream_t*>(m_tcp_stream), alloc_read_buffer, on_read);
+    if (error) {
+        return error;
+    }
+
+    m_read_paused = false;
+    return Error(0);
+}
+
 bool TcpClient::Impl::schedule_removal() {
     IO_LOG(m_loop, TRACE, m_parent, "endpoint:", m_destination_endpoint);
 
@@ -171,6 +193,9 @@ bool TcpClient::Impl::close() {
         if (0 != setsockopt(handle, SOL_SOCKET, SO_LINGER, &l, sizeof(l)))
             return false;
         //*/
+        flush_corked_sends();
+        close_zero_copy_sends();
+        cancel_file_send();
         uv_close(reinterpret_cast<uv_handle_t*>(m_tcp_stream), on_close);
         m_tcp_stream = nullptr;
     }
@@ -192,6 +217,8 @@ void TcpClient::Impl::on_shutdown(uv_shutdown_t* req, int uv_status) {
     this_.m_is_open = false;
 
     if (!uv_is_closing(reinterpret_cast<uv_handle_t*>(this_.m_tcp_stream))) {
+        this_.close_zero_copy_sends();
+        this_.cancel_file_send();
         uv_close(reinterpret_cast<uv_handle_t*>(req->handle), on_close);
     }
 
@@ -214,7 +241,10 @@ void TcpClient::Impl::on_connect(uv_connect_t* req, int uv_status) {
         return;
     }
 
-    uv_read_start(req->handle, alloc_read_buffer, on_read);
+    // Reading could be paused in connect callback
+    if (!this_.m_read_paused) {
+        uv_read_start(req->handle, alloc_read_buffer, on_read);
+    }
 }
 
 void TcpClient::Impl::on_close(uv_handle_t* handle) {
@@ -243,16 +273,22 @@ void TcpClient::Impl::on_close(uv_handle_t* handle) {
 
 void TcpClient::Impl::on_read(uv_stream_t* handle, ssize_t nread, const uv_buf_t* buf) {
     auto& this_ = *reinterpret_cast<TcpClient::Impl*>(handle->data);
+
+    // Socket error queue with zero copy notifications makes socket readable without data
+    this_.process_zero_copy_completions();
+
+    if (this_.relay_read(nread)) {
+        return;
+    }
+
     auto& loop = *reinterpret_cast<EventLoop*>(handle->loop->data);
 
+    const auto read_buf = this_.take_read_buffer(nread);
+
     Error error(nread);
     if (!error) {
         if (this_.m_receive_callback) {
-            const auto prev_use_count = this_.m_read_buf.use_count();
-            this_.m_receive_callback(*this_.m_parent, {this_.m_read_buf,  std::size_t(nread), this_.m_data_offset}, Error(0));
-            if (prev_use_count != this_.m_read_buf.use_count()) { // user made a copy
-                this_.m_read_buf.reset(); // will reallocate new one on demand
-            }
+            this_.m_receive_callback(*this_.m_parent, {read_buf,  std::size_t(nread), this_.m_data_offset}, Error(0));
         }
 
         this_.m_data_offset += static_cast<std::size_t>(nread);
@@ -260,6 +296,8 @@ void TcpClient::Impl::on_read(uv_stream_t* handle, ssize_t nread, const uv_buf_t
         IO_LOG(&loop, TRACE, "Closed from other side. Reason:", error.string());
 
         if (this_.m_close_callback) {
+            this_.close_zero_copy_sends();
+            this_.cancel_file_send();
             this_.m_is_open = false;
 
             // Need this because user may connect to other endpoint in close callback
@@ -331,6 +369,14 @@ void TcpClient::send_data(std::string&& message, EndSendCallback callback) {
     return m_impl->send_data(std::move(message), callback);
 }
 
+void TcpClient::send_data(std::vector<DataChunk> chunks, EndSendCallback callback) {
+    return m_impl->send_data(std::move(chunks), callback);
+}
+
+void TcpClient::send_file(File& file, std::uint64_t offset, std::size_t length, SendFileCallback callback) {
+    return m_impl->send_file(file, offset, length, callback);
+}
+
 std::size_t TcpClient::pending_write_requesets() const {
     return m_impl->pending_write_requests();
 }
@@ -347,4 +393,72 @@ bool TcpClient::is_delay_send() const {
     return m_impl->is_delay_send();
 }
 
+void TcpClient::cork_send(bool enabled) {
+    return m_impl->cork_send(enabled);
+}
+
+bool TcpClient::is_cork_send() const {
+    return m_impl->is_cork_send();
+}
+
+Error TcpClient::pause_reading() {
+    return m_impl->pause_reading();
+}
+
+Error TcpClient::resume_reading() {
+    return m_impl->resume_reading();
+}
+
+bool TcpClient::is_reading_paused() const {
+    return m_impl->is_reading_paused();
+}
+
+Error TcpClient::set_read_buffer_allocator(const ReadBufferAllocator& allocator) {
+    return m_impl->set_read_buffer_allocator(allocator);
+}
+
+Error TcpClient::set_zero_copy_send_threshold(std::size_t size) {
+    return m_impl->set_zero_copy_send_threshold(size);
+}
+
+std::size_t TcpClient::zero_copy_send_threshold() const {
+    return m_impl->zero_copy_send_threshold();
+}
+
+std::size_t TcpClient::zero_copy_sends_count() const {
+    return m_impl->zero_copy_sends_count();
+}
+
+std::size_t TcpClient::pending_write_bytes() const {
+    return m_impl->pending_write_bytes();
+}
+
+Error TcpClient::set_write_watermarks(std::size_t low, std::size_t high) {
+    return m_impl->set_write_watermarks(low, high);
+}
+
+bool TcpClient::is_write_buffer_full() const {
+    return m_impl->is_write_buffer_full();
+}
+
+void TcpClient::set_on_write_buffer_full(WriteBufferFullCallback callback) {
+    return m_impl->set_on_write_buffer_full(callback);
+}
+
+void TcpClient::set_on_write_buffer_drained(WriteBufferDrainedCallback callback) {
+    return m_impl->set_on_write_buffer_drained(callback);
+}
+
+void TcpClient::set_relay_hooks(detail::TcpRelayHooks* hooks, bool zero_copy) {
+    return m_impl->set_relay_hooks(hooks, zero_copy);
+}
+
+int TcpClient::native_handle() const {
+    return m_impl->native_handle();
+}
+
+Error TcpClient::shutdown_write() {
+    return m_impl->shutdown_write();
+}
+
 } // namespace io
@@ -4,12 +4,15 @@
 #include "Endpoint.h"
 #include "EventLoop.h"
 #include "Export.h"
+#include "Forward.h"
 #include "DataChunk.h"
+#include "ReadBufferAllocator.h"
 #include "Removable.h"
 #include "UserDataHolder.h"
 #include "Error.h"
 
 #include <memory>
+#include <vector>
 
 namespace io {
 
@@ -20,6 +23,9 @@ public:
     using DataReceiveCallback = std::function<void(TcpClient&, const DataChunk&, const Error&)>;
     using CloseCallback = std::function<void(TcpClient&, const Error&)>;
     using EndSendCallback = std::function<void(TcpClient&, const Error&)>;
+    using SendFileCallback = std::function<void(TcpClient&, std::size_t, const Error&)>;
+    using WriteBufferFullCallback = std::function<void(TcpClient&)>;
+    using WriteBufferDrainedCallback = std::function<void(TcpClient&)>;
 
     IO_FORBID_COPY(TcpClient);
     IO_FORBID_MOVE(TcpClient);
@@ -42,6 +48,17 @@ public:
     IO_DLL_PUBLIC void send_data(std::shared_ptr<const char> buffer, std::uint32_t size, EndSendCallback callback = nullptr);
     IO_DLL_PUBLIC void send_data(const std::string& message, EndSendCallback callback = nullptr);
     IO_DLL_PUBLIC void send_data(std::string&& message, EndSendCallback callback = nullptr);
+    // All chunks are written by a single system call where possible (scatter-gather), without copying.
+    // Chunks of zero size are skipped. Data is sent from the beginning of the chunk's buffer,
+    // offset is the position in the stream and is ignored (use aliasing shared_ptr for a part of buffer).
+    IO_DLL_PUBLIC void send_data(std::vector<DataChunk> chunks, EndSendCallback callback = nullptr);
+
+    // Sends 'length' bytes of the file starting from 'offset' by sendfile, file data is not copied
+    // to user space. Sends made before are written first, the ones made while file is being sent
+    // are written after it. File bytes are counted in pending bytes and write watermarks. Callback
+    // receives number of bytes sent, which is less than 'length' on error (END_OF_FILE if file is
+    // shorter). Only one file could be sent at a time. File should stay open until callback is called.
+    IO_DLL_PUBLIC void send_file(File& file, std::uint64_t offset, std::size_t length, SendFileCallback callback = nullptr);
 
     IO_DLL_PUBLIC std::size_t pending_write_requesets() const;
 
@@ -50,10 +67,56 @@ public:
     IO_DLL_PUBLIC void delay_send(bool enabled);
     IO_DLL_PUBLIC bool is_delay_send() const;
 
+    // Corked mode, disabled by default. Data sent during one loop iteration is accumulated and written
+    // by a single vectored write right before the loop waits for I/O (or earlier if 256 KB or 256 buffers
+    // are accumulated). Order of data and callbacks is preserved, every send still gets own callback.
+    IO_DLL_PUBLIC void cork_send(bool enabled);
+    IO_DLL_PUBLIC bool is_cork_send() const;
+
+    // Number of bytes which were sent but are not yet written to the socket.
+    IO_DLL_PUBLIC std::size_t pending_write_bytes() const;
+
+    // Full callback is called when pending bytes reach 'high', drained callback is called when they
+    // go down to 'low' after that. Allows to stop producing data for slow consumers. High watermark 0
+    // disables notifications, which is default. Low watermark could not be greater than high one.
+    IO_DLL_PUBLIC Error set_write_watermarks(std::size_t low, std::size_t high);
+    IO_DLL_PUBLIC bool is_write_buffer_full() const;
+    IO_DLL_PUBLIC void set_on_write_buffer_full(WriteBufferFullCallback callback);
+    IO_DLL_PUBLIC void set_on_write_buffer_drained(WriteBufferDrainedCallback callback);
+
+    // Stops receiving data from the connection, so peer is slowed down by TCP flow control when
+    // socket buffers are full. Data receive callback is not called until reading is resumed.
+    // Pausing of already paused connection does nothing, the same is true for resuming.
+    IO_DLL_PUBLIC Error pause_reading();
+    IO_DLL_PUBLIC Error resume_reading();
+    IO_DLL_PUBLIC bool is_reading_paused() const;
+
+    // Data is received into buffers allocated by user's allocator instead of the loop's pool.
+    // If allocator has no memory, connection is closed with NO_BUFFER_SPACE_AVAILABLE error.
+    // Default constructed allocator restores library's buffers.
+    IO_DLL_PUBLIC Error set_read_buffer_allocator(const ReadBufferAllocator& allocator);
+
+    // Sends of at least 'size' bytes made by send_data(std::shared_ptr<const char>, ...) are done with
+    // MSG_ZEROCOPY on Linux. Data is not copied to the kernel, buffer is held until kernel reports that it
+    // is not needed anymore and callback is called after that, so callbacks of such sends could be called
+    // after callbacks of later sends. Saves CPU for multi-megabyte buffers only. Zero disables (default).
+    // Returns FUNCTION_NOT_IMPLEMENTED on other platforms.
+    IO_DLL_PUBLIC Error set_zero_copy_send_threshold(std::size_t size);
+    IO_DLL_PUBLIC std::size_t zero_copy_send_threshold() const;
+    // Number of sends done with MSG_ZEROCOPY, others fall back to regular writes
+    IO_DLL_PUBLIC std::size_t zero_copy_sends_count() const;
+
 protected:
     IO_DLL_PUBLIC ~TcpClient();
 
 private:
+    friend class TcpRelay;
+
+    // Interface for TcpRelay
+    void set_relay_hooks(detail::TcpRelayHooks* hooks, bool zero_copy);
+    int native_handle() const;
+    Error shutdown_write();
+
     class Impl;
     std::unique_ptr<Impl> m_impl;
 };
@@ -21,6 +21,7 @@ public:
     void shutdown();
 
     void start_read(DataReceiveCallback data_receive_callback);
+    Error resume_reading();
     uv_tcp_t* tcp_client_stream();
 
     TcpServer& server();
@@ -63,6 +64,8 @@ void TcpConnectedClient::Impl::shutdown() {
 
     m_is_open = false;
 
+    flush_corked_sends();
+
     auto shutdown_req = new uv_shutdown_t;
     shutdown_req->data = this;
     uv_shutdown(shutdown_req, reinterpret_cast<uv_stream_t*>(m_tcp_stream), on_shutdown);
@@ -81,6 +84,10 @@ void TcpConnectedClient::Impl::close() {
 
     m_is_open = false;
 
+    flush_corked_sends();
+    close_zero_copy_sends();
+    cancel_file_send();
+
     // TODO: check uv_is_closing???
     uv_close(reinterpret_cast<uv_handle_t*>(m_tcp_stream), on_close);
 }
@@ -88,12 +95,35 @@ void TcpConnectedClient::Impl::close() {
 void TcpConnectedClient::Impl::start_read(DataReceiveCallback data_receive_callback) {
     m_receive_callback = data_receive_callback;
 
+    // Reading could be paused in new connection callback
+    if (m_read_paused) {
+        return;
+    }
+
     // TODO: handle return status code
     uv_read_start(reinterpret_cast<uv_stream_t*>(m_tcp_stream),
                   alloc_read_buffer,
                   on_read);
 }
 
+Error TcpConnectedClient::Impl::resume_reading() {
+    if (!is_open()) {
+        return Error(StatusCode::NOT_CONNECTED);
+    }
+
+    if (!m_read_paused) {
+        return Error(0);
+    }
+
+    const Error error = uv_read_start(reinterpret_cast<uv_stream_t*>(m_tcp_stream), alloc_read_buffer, on_read);
+    if (error) {
+        return error;
+    }
+
+    m_read_paused = false;
+    return Error(0);
+}
+
 TcpServer& TcpConnectedClient::Impl::server() {
     return *m_server;
 }
@@ -116,6 +146,8 @@ void TcpConnectedClient::Impl::on_shutdown(uv_shutdown_t* req, int status) {
         this_.m_close_callback = nullptr; // TODO: looks like a hack
     }
 
+    this_.close_zero_copy_sends();
+    this_.cancel_file_send();
     uv_close(reinterpret_cast<uv_handle_t*>(req->handle), on_close);
     delete req;
 }
@@ -142,20 +174,25 @@ void TcpConnectedClient::Impl::on_close(uv_handle_t* handle) {
 void TcpConnectedClient::Impl::on_read(uv_stream_t* handle, ssize_t nread, const uv_buf_t* buf) {
     auto& this_ = *reinterpret_cast<TcpConnectedClient::Impl*>(handle->data);
 
+    // Socket error queue with zero copy notifications makes socket readable without data
+    this_.process_zero_copy_completions();
+
+    if (this_.relay_read(nread)) {
+        return;
+    }
+
     if (nread >= 0) {
         IO_LOG(this_.m_loop, TRACE, this_.m_parent, "Received data, size:", nread);
     } else {
         IO_LOG(this_.m_loop, TRACE, this_.m_parent, "Receive error:", uv_strerror(nread));
     }
 
+    const auto read_buf = this_.take_read_buffer(nread);
+
     Error error(nread);
     if (!error) {
         if (this_.m_receive_callback) {
-            const auto prev_use_count = this_.m_read_buf.use_count();
-            this_.m_receive_callback(*this_.m_parent, {this_.m_read_buf,  std::size_t(nread), this_.m_data_offset}, Error(0));
-            if (prev_use_count != this_.m_read_buf.use_count()) { // user made a copy
-                this_.m_read_buf.reset(); // will reallocate new one on demand
-            }
+            this_.m_receive_callback(*this_.m_parent, {read_buf,  std::size_t(nread), this_.m_data_offset}, Error(0));
         }
 
         this_.m_data_offset += static_cast<std::size_t>(nread);
@@ -219,6 +256,14 @@ void TcpConnectedClient::send_data(std::string&& message, EndSendCallback callba
     return m_impl->send_data(std::move(message), callback);
 }
 
+void TcpConnectedClient::send_data(std::vector<DataChunk> chunks, EndSendCallback callback) {
+    return m_impl->send_data(std::move(chunks), callback);
+}
+
+void TcpConnectedClient::send_file(File& file, std::uint64_t offset, std::size_t length, SendFileCallback callback) {
+    return m_impl->send_file(file, offset, length, callback);
+}
+
 std::size_t TcpConnectedClient::pending_write_requesets() const {
     return m_impl->pending_write_requests();
 }
@@ -243,6 +288,62 @@ bool TcpConnectedClient::is_delay_send() const {
     return m_impl->is_delay_send();
 }
 
+void TcpConnectedClient::cork_send(bool enabled) {
+    return m_impl->cork_send(enabled);
+}
+
+bool TcpConnectedClient::is_cork_send() const {
+    return m_impl->is_cork_send();
+}
+
+Error TcpConnectedClient::pause_reading() {
+    return m_impl->pause_reading();
+}
+
+Error TcpConnectedClient::resume_reading() {
+    return m_impl->resume_reading();
+}
+
+bool TcpConnectedClient::is_reading_paused() const {
+    return m_impl->is_reading_paused();
+}
+
+Error TcpConnectedClient::set_read_buffer_allocator(const ReadBufferAllocator& allocator) {
+    return m_impl->set_read_buffer_allocator(allocator);
+}
+
+Error TcpConnectedClient::set_zero_copy_send_threshold(std::size_t size) {
+    return m_impl->set_zero_copy_send_threshold(size);
+}
+
+std::size_t TcpConnectedClient::zero_copy_send_threshold() const {
+    return m_impl->zero_copy_send_threshold();
+}
+
+std::size_t TcpConnectedClient::zero_copy_sends_count() const {
+    return m_impl->zero_copy_sends_count();
+}
+
+std::size_t TcpConnectedClient::pending_write_bytes() const {
+    return m_impl->pending_write_bytes();
+}
+
+Error TcpConnectedClient::set_write_watermarks(std::size_t low, std::size_t high) {
+    return m_impl->set_write_watermarks(low, high);
+}
+
+bool TcpConnectedClient::is_write_buffer_full() const {
+    return m_impl->is_write_buffer_full();
+}
+
+void TcpConnectedClient::set_on_write_buffer_full(WriteBufferFullCallback callback) {
+    return m_impl->set_on_write_buffer_full(callback);
+}
+
+void TcpConnectedClient::set_on_write_buffer_drained(WriteBufferDrainedCallback callback) {
+    return m_impl->set_on_write_buffer_drained(callback);
+}
+
 TcpServer& TcpConnectedClient::server() {
     return m_impl->server();
 }
@@ -259,4 +360,16 @@ Error TcpConnectedClient::init_stream() {
     return m_impl->init_stream();
 }
 
+void TcpConnectedClient::set_relay_hooks(detail::TcpRelayHooks* hooks, bool zero_copy) {
+    return m_impl->set_relay_hooks(hooks, zero_copy);
+}
+
+int TcpConnectedClient::native_handle() const {
+    return m_impl->native_handle();
+}
+
+Error TcpConnectedClient::shutdown_write() {
+    return m_impl->shutdown_write();
+}
+
 } // namespace io
@@ -0,0 +1,668 @@
+#include "TcpRelay.h"
+
+#include "detail/Common.h"
+#include "detail/TcpRelayHooks.h"
+#include "TcpClient.h"
+#include "TcpConnectedClient.h"
+
+#include <assert.h>
+
+#if defined(__linux__)
+    #include <cerrno>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+namespace io {
+
+class TcpRelay::Impl {
+public:
+    Impl(EventLoop& loop, TcpRelay& parent);
+    ~Impl();
+
+    Error start(TcpConnectedClient& downstream, TcpClient& upstream, EndRelayCallback end_callback);
+    void stop();
+    bool is_active() const;
+
+    void set_zero_copy(bool enabled);
+    bool is_zero_copy() const;
+
+    std::uint64_t bytes_to_upstream() const;
+    std::uint64_t bytes_to_downstream() const;
+
+private:
+    // Reading of the source is paused when this amount of data is waiting to be written to the other
+    // connection and resumed when half of it is written. Does not apply to zero copy mode.
+    static const std::size_t MAX_PENDING_BYTES = 1024 * 1024;
+    // Default capacity of Linux pipe
+    static const std::size_t PIPE_CAPACITY = 64 * 1024;
+    // Number of reads from one socket per readability notification, so other connections are not starved
+    static const std::size_t MAX_READS_PER_EVENT = 16;
+
+    using SendCallback = std::function<void(const Error&)>;
+
+    // Connection and state of the direction where it is the source of data
+    class Connection : public detail::TcpRelayHooks {
+    public:
+        Connection(Impl& relay);
+        virtual ~Connection();
+
+        virtual bool is_destroyed() const = 0;
+        virtual bool is_open() const = 0;
+        virtual void set_relay_hooks(bool enabled, bool zero_copy) = 0;
+        virtual int native_handle() const = 0;
+        virtual Error shutdown_write() = 0;
+        virtual Error pause_reading() = 0;
+        virtual Error resume_reading() = 0;
+        virtual std::size_t pending_write_bytes() const = 0;
+        virtual void send_data(std::shared_ptr<const char> buffer, std::uint32_t size, SendCallback callback) = 0;
+
+        void on_relay_read(const DataChunk& chunk, const Error& error) override;
+
+        Impl* relay;
+        Connection* peer = nullptr;
+
+        // Pipe of zero copy mode
+        int pipe_read_end = -1;
+        int pipe_write_end = -1;
+        std::size_t pipe_bytes = 0;
+
+        // Writability of the peer is polled on duplicate of its descriptor, because libuv does not
+        // allow to have 2 handles for the same one
+        int peer_handle_dup = -1;
+        uv_poll_t* peer_poll = nullptr;
+
+        std::uint64_t bytes_to_peer = 0;
+
+        bool eof = false;
+        bool finished = false;
+        bool waiting_peer = false;
+        bool paused_by_relay = false;
+    };
+
+    template<typename ClientType>
+    class ConnectionImpl;
+
+    void on_read(Connection& from, const DataChunk& chunk, const Error& error);
+    void on_connection_destroyed(Connection& connection);
+
+    void pump(Connection& from);
+    void wait_peer(Connection& from);
+    void finish_direction(Connection& from);
+
+    void pause_source(Connection& from);
+    void resume_source(Connection& from);
+
+    Error open_pipe(Connection& connection);
+    void drain_pipe(Connection& from);
+    void close_pipe(Connection& connection);
+    void close_peer_poll(Connection& from);
+
+    static void on_peer_writable(uv_poll_t* handle, int status, int events);
+    static void on_peer_poll_close(uv_handle_t* handle);
+
+    void release();
+    void finish(const Error& error);
+
+    EventLoop* m_loop;
+    TcpRelay* m_parent;
+
+    std::unique_ptr<Connection> m_downstream;
+    std::unique_ptr<Connection> m_upstream;
+
+    // Callbacks of sends made by previous relay sessions are ignored
+    std::shared_ptr<bool> m_alive;
+
+    EndRelayCallback m_end_callback = nullptr;
+
+    bool m_active = false;
+#if defined(__linux__)
+    bool m_zero_copy = true;
+#else
+    bool m_zero_copy = false;
+#endif
+    bool m_zero_copy_active = false;
+};
+
+TcpRelay::Impl::Connection::Connection(Impl& relay) :
+    relay(&relay) {
+}
+
+TcpRelay::Impl::Connection::~Connection() {
+}
+
+void TcpRelay::Impl::Connection::on_relay_read(const DataChunk& chunk, const Error& error) {
+    relay->on_read(*this, chunk, error);
+}
+
+template<typename ClientType>
+class TcpRelay::Impl::ConnectionImpl : public TcpRelay::Impl::Connection {
+public:
+    ConnectionImpl(Impl& relay, ClientType& client) :
+        Connection(relay),
+        m_client(&client) {
+    }
+
+    bool is_destroyed() const override {
+        return m_client == nullptr;
+    }
+
+    bool is_open() const override {
+        return m_client && m_client->is_open();
+    }
+
+    void set_relay_hooks(bool enabled, bool zero_copy) override {
+        m_client->set_relay_hooks(enabled ? this : nullptr, zero_copy);
+    }
+
+    int native_handle() const override {
+        return m_client->native_handle();
+    }
+
+    Error shutdown_write() override {
+        return m_client->shutdown_write();
+    }
+
+    Error pause_reading() override {
+        return m_client->pause_reading();
+    }
+
+    Error resume_reading() override {
+        return m_client->resume_reading();
+    }
+
+    std::size_t pending_write_bytes() const override {
+        return m_client->pending_write_bytes();
+    }
+
+    void send_data(std::shared_ptr<const char> buffer, std::uint32_t size, SendCallback callback) override {
+        m_client->send_data(buffer, size, [callback](ClientType&, const Error& error) {
+            if (callback) {
+                callback(error);
+            }
+        });
+    }
+
+    void on_relay_connection_destroyed() override {
+        m_client = nullptr;
+        relay->on_connection_destroyed(*this);
+    }
+
+private:
+    ClientType* m_client;
+};
+
+TcpRelay::Impl::Impl(EventLoop& loop, TcpRelay& parent) :
+    m_loop(&loop),
+    m_parent(&parent),
+    m_alive(std::make_shared<bool>(true)) {
+}
+
+TcpRelay::Impl::~Impl() {
+    release();
+    *m_alive = false;
+}
+
+Error TcpRelay::Impl::start(TcpConnectedClient& downstream, TcpClient& upstream, EndRelayCallback end_callback) {
+    if (m_active) {
+        return Error(StatusCode::RESOURCE_BUSY_OR_LOCKED);
+    }
+
+    if (!downstream.is_open() || !upstream.is_open()) {
+        return Error(StatusCode::NOT_CONNECTED);
+    }
+
+    m_downstream.reset(new ConnectionImpl<TcpConnectedClient>(*this, downstream));
+    m_upstream.reset(new ConnectionImpl<TcpClient>(*this, upstream));
+    m_downstream->peer = m_upstream.get();
+    m_upstream->peer = m_downstream.get();
+
+    m_zero_copy_active = m_zero_copy;
+    if (m_zero_copy_active) {
+        for (auto connection : {m_downstream.get(), m_upstream.get()}) {
+            const Error pipe_error = open_pipe(*connection);
+            if (pipe_error) {
+                close_pipe(*m_downstream);
+                close_pipe(*m_upstream);
+                return pipe_error;
+            }
+        }
+    }
+
+    IO_LOG(m_loop, DEBUG, m_parent, "downstream:", downstream.endpoint(), "upstream:", upstream.endpoint(),
+           "zero copy:", m_zero_copy_active);
+
+    m_end_callback = end_callback;
+    m_active = true;
+
+    for (auto connection : {m_downstream.get(), m_upstream.get()}) {
+        connection->set_relay_hooks(true, m_zero_copy_active);
+        // Relay reads from both connections, even if user paused them before
+        connection->resume_reading();
+    }
+
+    return Error(0);
+}
+
+void TcpRelay::Impl::stop() {
+    release();
+}
+
+bool TcpRelay::Impl::is_active() const {
+    return m_active;
+}
+
+void TcpRelay::Impl::set_zero_copy(bool enabled) {
+#if defined(__linux__)
+    m_zero_copy = enabled;
+#else
+    (void)enabled;
+#endif
+}
+
+bool TcpRelay::Impl::is_zero_copy() const {
+    return m_zero_copy;
+}
+
+std::uint64_t TcpRelay::Impl::bytes_to_upstream() const {
+    return m_downstream ? m_downstream->bytes_to_peer : 0;
+}
+
+std::uint64_t TcpRelay::Impl::bytes_to_downstream() const {
+    return m_upstream ? m_upstream->bytes_to_peer : 0;
+}
+
+void TcpRelay::Impl::on_read(Connection& from, const DataChunk& chunk, const Error& error) {
+    if (error) {
+        if (error.code() == StatusCode::END_OF_FILE) {
+            from.eof = true;
+            finish_direction(from);
+        } else {
+            finish(error);
+        }
+        return;
+    }
+
+    if (m_zero_copy_active) {
+        pump(from);
+        return;
+    }
+
+    auto& to = *from.peer;
+    from.bytes_to_peer += chunk.size;
+
+    auto alive = m_alive;
+    Connection* from_ptr = &from;
+    to.send_data(chunk.buf, static_cast<std::uint32_t>(chunk.size), [this, alive, from_ptr](const Error& error) {
+        if (!*alive) {
+            return;
+        }
+
+        if (error) {
+            finish(error);
+            return;
+        }
+
+        if (from_ptr->paused_by_relay && from_ptr->peer->pending_write_bytes() <= MAX_PENDING_BYTES / 2) {
+            resume_source(*from_ptr);
+        }
+    });
+
+    if (to.pending_write_bytes() >= MAX_PENDING_BYTES) {
+        pause_source(from);
+    }
+}
+
+void TcpRelay::Impl::on_connection_destroyed(Connection& connection) {
+    IO_LOG(m_loop, DEBUG, m_parent, "Relayed connection is removed");
+    (void)connection;
+    finish(Error(StatusCode::OPERATION_CANCELED));
+}
+
+void TcpRelay::Impl::pump(Connection& from) {
+#if defined(__linux__)
+    if (from.waiting_peer || from.finished) {
+        return;
+    }
+
+    auto& to = *from.peer;
+    if (!from.is_open() || !to.is_open()) {
+        finish(Error(StatusCode::NOT_CONNECTED));
+        return;
+    }
+
+    const int from_handle = from.native_handle();
+    const int to_handle = to.native_handle();
+
+    for (std::size_t reads_count = 0; ; ++reads_count) {
+        bool source_is_empty = from.eof || reads_count >= MAX_READS_PER_EVENT;
+
+        if (!source_is_empty && from.pipe_bytes < PIPE_CAPACITY) {
+            const ssize_t read_count = ::splice(from_handle, nullptr, from.pipe_write_end, nullptr,
+                                                PIPE_CAPACITY - from.pipe_bytes, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+            if (read_count > 0) {
+                from.pipe_bytes += static_cast<std::size_t>(read_count);
+            } else if (read_count == 0) {
+                from.eof = true;
+                source_is_empty = true;
+                // Socket stays readable after the end of stream
+                pause_source(from);
+            } else if (errno == EAGAIN) {
+                source_is_empty = true;
+            } else if (errno != EINTR) {
+                finish(Error(-errno));
+                return;
+            }
+        }
+
+        if (from.pipe_bytes) {
+            // Data which was sent via libuv goes first
+            if (to.pending_write_bytes()) {
+                wait_peer(from);
+                return;
+            }
+
+            const ssize_t write_count = ::splice(from.pipe_read_end, nullptr, to_handle, nullptr,
+                                                 from.pipe_bytes, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+            if (write_count > 0) {
+                from.pipe_bytes -= static_cast<std::size_t>(write_count);
+                from.bytes_to_peer += static_cast<std::size_t>(write_count);
+            } else if (write_count < 0 && errno == EAGAIN) {
+                wait_peer(from);
+                return;
+            } else if (write_count < 0 && errno != EINTR) {
+                finish(Error(-errno));
+                return;
+            }
+        }
+
+        if (source_is_empty && from.pipe_bytes == 0) {
+            break;
+        }
+    }
+
+    if (from.eof) {
+        finish_direction(from);
+    }
+#else
+    (void)from;
+#endif
+}
+
+void TcpRelay::Impl::wait_peer(Connection& from) {
+#if defined(__linux__)
+    assert(from.pipe_bytes);
+
+    from.waiting_peer = true;
+    if (!from.eof) {
+        pause_source(from);
+    }
+
+    // libuv has no notification about writability of TCP stream, so socket of the peer is polled.
+    // Data which was sent via libuv is written when socket becomes writable too, pump() checks it again.
+    if (from.peer_poll == nullptr) {
+        from.peer_handle_dup = ::dup(from.peer->native_handle());
+        if (from.peer_handle_dup == -1) {
+            finish(Error(-errno));
+            return;
+        }
+
+        from.peer_poll = new uv_poll_t;
+        const Error init_error = uv_poll_init(reinterpret_cast<uv_loop_t*>(m_loop->raw_loop()), from.peer_poll, from.peer_handle_dup);
+        if (init_error) {
+            delete from.peer_poll;
+            from.peer_poll = nullptr;
+            finish(init_error);
+            return;
+        }
+
+        from.peer_poll->data = &from;
+    }
+
+    const Error start_error = uv_poll_start(from.peer_poll, UV_WRITABLE, on_peer_writable);
+    if (start_error) {
+        finish(start_error);
+        return;
+    }
+#else
+    (void)from;
+#endif
+}
+
+void TcpRelay::Impl::finish_direction(Connection& from) {
+    if (from.finished || from.pipe_bytes || from.waiting_peer) {
+        return;
+    }
+
+    from.finished = true;
+
+    IO_LOG(m_loop, TRACE, m_parent, "Relay direction is finished, bytes:", from.bytes_to_peer);
+
+    // Data sent via libuv is written before FIN
+    const Error shutdown_error = from.peer->shutdown_write();
+    if (shutdown_error) {
+        finish(shutdown_error);
+        return;
+    }
+
+    if (from.peer->finished) {
+        finish(Error(0));
+    }
+}
+
+void TcpRelay::Impl::pause_source(Connection& from) {
+    if (from.paused_by_relay) {
+        return;
+    }
+
+    from.paused_by_relay = true;
+    from.pause_reading();
+}
+
+void TcpRelay::Impl::resume_source(Connection& from) {
+    if (!from.paused_by_relay) {
+        return;
+    }
+
+    from.paused_by_relay = false;
+    from.resume_reading();
+}
+
+Error TcpRelay::Impl::open_pipe(Connection& connection) {
+#if defined(__linux__)
+    int handles[2];
+    if (::pipe2(handles, O_NONBLOCK | O_CLOEXEC) != 0) {
+        return Error(-errno);
+    }
+
+    connection.pipe_read_end = handles[0];
+    connection.pipe_write_end = handles[1];
+    return Error(0);
+#else
+    (void)connection;
+    return Error(StatusCode::FUNCTION_NOT_IMPLEMENTED);
+#endif
+}
+
+void TcpRelay::Impl::drain_pipe(Connection& from) {
+#if defined(__linux__)
+    if (from.pipe_bytes == 0 || from.peer->is_destroyed() || !from.peer->is_open()) {
+        return;
+    }
+
+    std::shared_ptr<char> buffer(new char[from.pipe_bytes], std::default_delete<char[]>());
+    std::size_t size = 0;
+    while (size < from.pipe_bytes) {
+        const ssize_t read_count = ::read(from.pipe_read_end, buffer.get() + size, from.pipe_bytes - size);
+        if (read_count < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (read_count <= 0) {
+            break;
+        }
+
+        size += static_cast<std::size_t>(read_count);
+    }
+
+    from.pipe_bytes = 0;
+    if (size) {
+        from.bytes_to_peer += size;
+        from.peer->send_data(buffer, static_cast<std::uint32_t>(size), nullptr);
+    }
+#else
+    (void)from;
+#endif
+}
+
+void TcpRelay::Impl::close_pipe(Connection& connection) {
+#if defined(__linux__)
+    for (auto handle : {&connection.pipe_read_end, &connection.pipe_write_end}) {
+        if (*handle != -1) {
+            ::close(*handle);
+            *handle = -1;
+        }
+    }
+#else
+    (void)connection;
+#endif
+}
+
+void TcpRelay::Impl::close_peer_poll(Connection& from) {
+#if defined(__linux__)
+    // Closing handle stops polling immediately, so descriptor could be closed right away
+    if (from.peer_poll) {
+        from.peer_poll->data = nullptr;
+        uv_close(reinterpret_cast<uv_handle_t*>(from.peer_poll), on_peer_poll_close);
+        from.peer_poll = nullptr;
+    }
+
+    if (from.peer_handle_dup != -1) {
+        ::close(from.peer_handle_dup);
+        from.peer_handle_dup = -1;
+    }
+
+    from.waiting_peer = false;
+#else
+    (void)from;
+#endif
+}
+
+void TcpRelay::Impl::release() {
+    if (!m_active) {
+        return;
+    }
+
+    m_active = false;
+
+    // Callbacks of pending sends do nothing after this
+    *m_alive = false;
+    m_alive = std::make_shared<bool>(true);
+
+    for (auto connection : {m_downstream.get(), m_upstream.get()}) {
+        if (connection->is_destroyed()) {
+            continue;
+        }
+
+        connection->set_relay_hooks(false, false);
+        // Reading stays paused after the end of stream, so user's callback gets it when reading is resumed
+        if (!connection->eof && connection->is_open()) {
+            resume_source(*connection);
+        }
+    }
+
+    for (auto connection : {m_downstream.get(), m_upstream.get()}) {
+        close_peer_poll(*connection);
+        drain_pipe(*connection);
+        close_pipe(*connection);
+    }
+}
+
+void TcpRelay::Impl::finish(const Error& error) {
+    if (!m_active) {
+        return;
+    }
+
+    if (error) {
+        IO_LOG(m_loop, DEBUG, m_parent, "Relay error:", error.string());
+    }
+
+    release();
+
+    if (m_end_callback) {
+        m_end_callback(*m_parent, error);
+    }
+}
+
+////////////////////////////////////////////// static //////////////////////////////////////////////
+void TcpRelay::Impl::on_peer_writable(uv_poll_t* handle, int status, int /*events*/) {
+    if (handle->data == nullptr) {
+        return;
+    }
+
+    auto& from = *reinterpret_cast<Connection*>(handle->data);
+    auto& this_ = *from.relay;
+
+    uv_poll_stop(handle);
+    from.waiting_peer = false;
+
+    if (status < 0) {
+        this_.finish(Error(status));
+        return;
+    }
+
+    if (!from.eof) {
+        this_.resume_source(from);
+    }
+
+    this_.pump(from);
+}
+
+void TcpRelay::Impl::on_peer_poll_close(uv_handle_t* handle) {
+    delete reinterpret_cast<uv_poll_t*>(handle);
+}
+
+///////////////////////////////////////// implementation ///////////////////////////////////////////
+
+TcpRelay::TcpRelay(EventLoop& loop) :
+    Removable(loop),
+    m_impl(new Impl(loop, *this)) {
+}
+
+TcpRelay::~TcpRelay() {
+}
+
+void TcpRelay::schedule_removal() {
+    stop();
+    return Removable::schedule_removal();
+}
+
+Error TcpRelay::start(TcpConnectedClient& downstream, TcpClient& upstream, EndRelayCallback end_callback) {
+    return m_impl->start(downstream, upstream, end_callback);
+}
+
+void TcpRelay::stop() {
+    return m_impl->stop();
+}
+
+bool TcpRelay::is_active() const {
+    return m_impl->is_active();
+}
+
+void TcpRelay::set_zero_copy(bool enabled) {
+    return m_impl->set_zero_copy(enabled);
+}
+
+bool TcpRelay::is_zero_copy() const {
+    return m_impl->is_zero_copy();
+}
+
+std::uint64_t TcpRelay::bytes_to_upstream() const {
+    return m_impl->bytes_to_upstream();
+}
+
+std::uint64_t TcpRelay::bytes_to_downstream() const {
+    return m_impl->bytes_to_downstream();
+}
+
+} // namespace io
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "CommonMacros.h"
+#include "EventLoop.h"
+#include "Export.h"
+#include "Error.h"
+#include "Forward.h"
+#include "Removable.h"
+#include "UserDataHolder.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace io {
+
+// Moves data between two connections in both directions, for example between client and upstream
+// server in L4 proxy. On Linux data goes from one socket to another through kernel pipe by splice and
+// is never copied to user space. On other platforms (or if zero copy is disabled) received chunks are
+// sent to the other connection, reading is paused while too much data is waiting to be written.
+// Receive callbacks of connections are not called while they are relayed.
+// When one peer finishes sending, sending to the other one is shut down after the pending data and
+// the opposite direction keeps working until it is finished too (half-close propagation).
+class TcpRelay : public Removable,
+                 public UserDataHolder {
+public:
+    using EndRelayCallback = std::function<void(TcpRelay&, const Error&)>;
+
+    IO_FORBID_COPY(TcpRelay);
+    IO_FORBID_MOVE(TcpRelay);
+
+    IO_DLL_PUBLIC TcpRelay(EventLoop& loop);
+
+    IO_DLL_PUBLIC void schedule_removal() override;
+
+    // Callback is called when both directions are finished or on the first error. Connections are not
+    // closed by relay, this is done by user usually in the callback. Connections should not be closed
+    // while relay is active, relay finishes with OPERATION_CANCELED if any of them is removed.
+    IO_DLL_PUBLIC Error start(TcpConnectedClient& downstream, TcpClient& upstream, EndRelayCallback end_callback = nullptr);
+
+    // Connections get back to their own callbacks. Data which was already taken from one socket
+    // is sent to the other one. End callback is not called.
+    IO_DLL_PUBLIC void stop();
+
+    IO_DLL_PUBLIC bool is_active() const;
+
+    // Enabled by default, ignored on platforms without splice. Should be set before start.
+    IO_DLL_PUBLIC void set_zero_copy(bool enabled);
+    IO_DLL_PUBLIC bool is_zero_copy() const;
+
+    // Number of bytes passed from one connection to another
+    IO_DLL_PUBLIC std::uint64_t bytes_to_upstream() const;
+    IO_DLL_PUBLIC std::uint64_t bytes_to_downstream() const;
+
+protected:
+    IO_DLL_PUBLIC ~TcpRelay();
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> m_impl;
+};
+
+} // namespace io
@@ -4,6 +4,7 @@
 #include "detail/Common.h"
 
 #include <assert.h>
+#include <cerrno>
 
 namespace io {
 
@@ -31,7 +32,14 @@ public:
 
     bool schedule_removal();
 
+    void reuse_port(bool enabled);
+    bool is_reuse_port() const;
+
+    Error set_read_buffer_allocator(const ReadBufferAllocator& allocator);
+
 protected:
+    Error enable_reuse_port();
+
     void close_impl();
 
     bool is_open() const;
@@ -62,6 +70,10 @@ private:
 
     Endpoint m_endpoint;
 
+    bool m_reuse_port = false;
+
+    ReadBufferAllocator m_read_buffer_allocator;
+
     // Made as unique_ptr because boost::pool has no move constructor defined
     //std::unique_ptr<boost::pool<>> m_pool;
 };
@@ -96,16 +108,13 @@ Error TcpServer::Impl::listen(const Endpoint& endpoint,
         return init_error;
     }
 
-    /*
-    uv_os_fd_t handle;
-    int status = uv_fileno((uv_handle_t*)m_server_handle, &handle);
-    if (status < 0) {
-        std::cout << uv_strerror(status) << std::endl;
+    if (m_reuse_port) {
+        const Error reuse_port_error = enable_reuse_port();
+        if (reuse_port_error) {
+            IO_LOG(m_loop, ERROR, m_parent, "Failed to enable SO_REUSEPORT:", reuse_port_error.string());
+            return reuse_port_error;
+        }
     }
-    // Enable SO_REUSEPORT on it, before we have a chance to listen on it.
-    int enable = 1;
-    setsockopt(handle, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable));
-    */
 
     const int bind_status = uv_tcp_bind(m_server_handle, reinterpret_cast<const struct sockaddr*>(m_endpoint.raw_endpoint()), 0);
     if (bind_status < 0) {
@@ -124,10 +133,47 @@ Error TcpServer::Impl::listen(const Endpoint& endpoint,
     return listen_status;
 }
 
+Error TcpServer::Impl::enable_reuse_port() {
+#if defined(_WIN32)
+    return Error(StatusCode::OPERATION_NOT_SUPPORTED_ON_SOCKET);
+#else
+    uv_os_fd_t handle;
+    const Error fileno_error = uv_fileno(reinterpret_cast<uv_handle_t*>(m_server_handle), &handle);
+    if (fileno_error) {
+        return fileno_error;
+    }
+
+    // Enabling SO_REUSEPORT before we have a chance to bind on it.
+    int enable = 1;
+    if (setsockopt(handle, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable)) != 0) {
+        return Error(uv_translate_sys_error(errno));
+    }
+
+    return Error(0);
+#endif
+}
+
 const Endpoint& TcpServer::Impl::endpoint() const {
     return m_endpoint;
 }
 
+void TcpServer::Impl::reuse_port(bool enabled) {
+    m_reuse_port = enabled;
+}
+
+bool TcpServer::Impl::is_reuse_port() const {
+    return m_reuse_port;
+}
+
+Error TcpServer::Impl::set_read_buffer_allocator(const ReadBufferAllocator& allocator) {
+    if (!allocator.is_valid()) {
+        return Error(StatusCode::INVALID_ARGUMENT);
+    }
+
+    m_read_buffer_allocator = allocator;
+    return Error(0);
+}
+
 void TcpServer::Impl::shutdown(ShutdownServerCallback shutdown_callback) {
     m_end_server_callback = shutdown_callback;
 
@@ -217,6 +263,7 @@ void TcpServer::Impl::on_new_connection(uv_stream_t* server, int status) {
     };
 
     auto tcp_client = new TcpConnectedClient(*this_.m_loop, *this_.m_parent, on_client_close_callback);
+    tcp_client->set_read_buffer_allocator(this_.m_read_buffer_allocator);
     const auto init_error = tcp_client->init_stream();
     if (init_error) {
         IO_LOG(this_.m_loop, ERROR, this_.m_parent, "init_error");
@@ -340,6 +387,18 @@ const Endpoint& TcpServer::endpoint() const {
     return m_impl->endpoint();
 }
 
+void TcpServer::reuse_port(bool enabled) {
+    return m_impl->reuse_port(enabled);
+}
+
+bool TcpServer::is_reuse_port() const {
+    return m_impl->is_reuse_port();
+}
+
+Error TcpServer::set_read_buffer_allocator(const ReadBufferAllocator& allocator) {
+    return m_impl->set_read_buffer_allocator(allocator);
+}
+
 void TcpServer::schedule_removal() {
     const bool ready_to_remove = m_impl->schedule_removal();
     if (ready_to_remove) {
@@ -5,6 +5,7 @@
 #include "Endpoint.h"
 #include "EventLoop.h"
 #include "Export.h"
+#include "ReadBufferAllocator.h"
 #include "Removable.h"
 #include "TcpConnectedClient.h"
 #include "UserDataHolder.h"
@@ -54,6 +55,16 @@ public:
 
     IO_DLL_PUBLIC const Endpoint& endpoint() const;
 
+    // Enables SO_REUSEPORT on the listening socket, so several servers (usually running on different loops)
+    // could listen on the same endpoint and kernel will balance incoming connections between them.
+    // Should be called before listen. Not supported on Windows.
+    IO_DLL_PUBLIC void reuse_port(bool enabled);
+    IO_DLL_PUBLIC bool is_reuse_port() const;
+
+    // Allocator is set for each accepted connection before new connection callback,
+    // see TcpConnectedClient::set_read_buffer_allocator.
+    IO_DLL_PUBLIC Error set_read_buffer_allocator(const ReadBufferAllocator& allocator);
+
 protected:
     IO_DLL_PUBLIC ~TcpServer();
 
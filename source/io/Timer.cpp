@@ -1,6 +1,7 @@
 #include "Timer.h"
 
 #include "detail/Common.h"
+#include "detail/TimerWheelEntry.h"
 
 #include <assert.h>
 
@@ -9,6 +10,7 @@ namespace io {
 class Timer::Impl  {
 public:
     Impl(EventLoop& loop, Timer& parent);
+    Impl(TimerWheel& wheel, Timer& parent);
     ~Impl();
 
     void start(uint64_t timeout_ms, uint64_t repeat_ms, Callback callback);
@@ -16,6 +18,7 @@ public:
     void start(const std::deque<std::uint64_t>& timeouts_ms, Callback callback);
     void start(const std::deque<std::uint64_t>& timeouts_ms, uint64_t repeat_ms, Callback callback);
     void start_impl();
+    void start_backend(std::uint64_t timeout_ms, std::uint64_t repeat_ms);
     void stop();
 
     std::uint64_t timeout_ms() const;
@@ -26,11 +29,18 @@ public:
 protected:
     // statics
     static void on_timer(uv_timer_t* handle);
+    static void on_wheel_timer(detail::TimerWheelEntry& entry);
+    static void on_timeout(Timer::Impl& this_);
 
 private:
     Timer* m_parent = nullptr;
     EventLoop* m_loop = nullptr;
+
+    // Timer is backed either by its own uv timer or by the wheel
     uv_timer_t* m_uv_timer = nullptr;
+    TimerWheel* m_wheel = nullptr;
+    detail::TimerWheelEntry m_wheel_entry;
+    std::uint64_t m_wheel_repeat_ms = 0;
     Callback m_callback = nullptr;
 
     std::deque<std::uint64_t> m_timeouts_ms;
@@ -51,6 +61,14 @@ Timer::Impl::Impl(EventLoop& loop, Timer& parent) :
     m_uv_timer->data = this;
 }
 
+Timer::Impl::Impl(TimerWheel& wheel, Timer& parent) :
+    m_parent(&parent),
+    m_loop(&wheel.loop()),
+    m_wheel(&wheel) {
+    m_wheel_entry.callback = on_wheel_timer;
+    m_wheel_entry.data = this;
+}
+
 namespace {
 
 void on_timer_close(uv_handle_t* handle) {
@@ -60,6 +78,11 @@ void on_timer_close(uv_handle_t* handle) {
 } // namespace
 
 Timer::Impl::~Impl() {
+    if (m_wheel) {
+        m_wheel->stop_entry(m_wheel_entry);
+        return;
+    }
+
     uv_timer_stop(m_uv_timer);
     uv_close(reinterpret_cast<uv_handle_t*>(m_uv_timer), on_timer_close);
 }
@@ -99,24 +122,42 @@ void Timer::Impl::start(const std::deque<std::uint64_t>& timeouts_ms, uint64_t r
 void Timer::Impl::start_impl() {
     // Return value may not be checked here because callback not nullptr is checked above
     if (m_timeouts_ms.size() == 1) {
-        uv_timer_start(m_uv_timer, on_timer, m_timeouts_ms.front(), m_repeat_ms);
+        start_backend(m_timeouts_ms.front(), m_repeat_ms);
     } else {
-        uv_timer_start(m_uv_timer, on_timer, m_timeouts_ms.front(), 0);
+        start_backend(m_timeouts_ms.front(), 0);
     }
 
     m_current_timeout_ms = m_timeouts_ms.front();
     m_timeouts_ms.pop_front();
 }
 
+void Timer::Impl::start_backend(std::uint64_t timeout_ms, std::uint64_t repeat_ms) {
+    if (m_wheel) {
+        m_wheel_repeat_ms = repeat_ms;
+        m_wheel->start_entry(m_wheel_entry, timeout_ms);
+    } else {
+        uv_timer_start(m_uv_timer, on_timer, timeout_ms, repeat_ms);
+    }
+}
+
 void Timer::Impl::stop() {
+    if (m_wheel) {
+        m_wheel->stop_entry(m_wheel_entry);
+        return;
+    }
+
     uv_timer_stop(m_uv_timer); // TODO: error handling
 }
 
 std::uint64_t Timer::Impl::timeout_ms() const {
-    return m_uv_timer ? m_current_timeout_ms : 0;
+    return m_uv_timer || m_wheel ? m_current_timeout_ms : 0;
 }
 
 std::uint64_t Timer::Impl::repeat_ms() const {
+    if (m_wheel) {
+        return m_wheel_repeat_ms;
+    }
+
     return m_uv_timer ? uv_timer_get_repeat(m_uv_timer) : 0;
 }
 
@@ -129,6 +170,23 @@ void Timer::Impl::on_timer(uv_timer_t* handle) {
     assert(handle->data);
 
     auto& this_ = *reinterpret_cast<Timer::Impl*>(handle->data);
+    on_timeout(this_);
+}
+
+void Timer::Impl::on_wheel_timer(detail::TimerWheelEntry& entry) {
+    assert(entry.data);
+
+    auto& this_ = *reinterpret_cast<Timer::Impl*>(entry.data);
+
+    // Same as uv timer, repeating timer is restarted before the callback
+    if (this_.m_wheel_repeat_ms) {
+        this_.m_wheel->start_entry(this_.m_wheel_entry, this_.m_wheel_repeat_ms);
+    }
+
+    on_timeout(this_);
+}
+
+void Timer::Impl::on_timeout(Timer::Impl& this_) {
     auto& parent_ = *this_.m_parent;
 
     this_.m_state_was_reset = false;
@@ -154,6 +212,11 @@ Timer::Timer(EventLoop& loop) :
     m_impl(new Impl(loop, *this)) {
 }
 
+Timer::Timer(TimerWheel& wheel) :
+    Removable(wheel.loop()),
+    m_impl(new Impl(wheel, *this)) {
+}
+
 Timer::~Timer() {
 }
 
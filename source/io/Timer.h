@@ -5,6 +5,7 @@
 #include "Error.h"
 #include "UserDataHolder.h"
 #include "Removable.h"
+#include "TimerWheel.h"
 
 #include <cstdint>
 #include <deque>
@@ -19,6 +20,8 @@ public:
     using Callback = std::function<void(Timer&)>;
 
     IO_DLL_PUBLIC Timer(EventLoop& loop);
+    // Timer is backed by the wheel instead of its own uv timer
+    IO_DLL_PUBLIC Timer(TimerWheel& wheel);
 
     IO_FORBID_COPY(Timer);
     IO_FORBID_MOVE(Timer);
@@ -0,0 +1,257 @@
+#include "TimerWheel.h"
+
+#include "detail/Common.h"
+#include "detail/TimerWheelEntry.h"
+
+#include <assert.h>
+
+namespace io {
+
+class TimerWheel::Impl {
+public:
+    Impl(EventLoop& loop, std::uint64_t tick_ms, TimerWheel& parent);
+    ~Impl();
+
+    EventLoop& loop();
+
+    void start_entry(detail::TimerWheelEntry& entry, std::uint64_t timeout_ms);
+    void stop_entry(detail::TimerWheelEntry& entry);
+
+    std::uint64_t tick_ms() const;
+
+    std::size_t active_timers_count() const;
+
+protected:
+    std::uint64_t now_ticks() const;
+
+    void insert(detail::TimerWheelEntry& entry);
+    void cascade(std::size_t level);
+    void process_tick();
+
+    // statics
+    static void on_timer(uv_timer_t* handle);
+
+private:
+    static const std::size_t LEVELS_COUNT = 4;
+    static const std::size_t SLOT_BITS = 8;
+    static const std::size_t SLOTS_COUNT = std::size_t(1) << SLOT_BITS;
+    static const std::uint64_t SLOT_MASK = SLOTS_COUNT - 1;
+    // Entries with larger delay are placed to the farthest slot and re-inserted when it is reached
+    static const std::uint64_t MAX_DELAY_TICKS = (std::uint64_t(1) << (LEVELS_COUNT * SLOT_BITS)) - 1;
+
+    TimerWheel* m_parent = nullptr;
+    EventLoop* m_loop = nullptr;
+    uv_timer_t* m_uv_timer = nullptr;
+
+    std::uint64_t m_tick_ms = 1;
+    std::uint64_t m_start_time_ms = 0;
+    // The next tick which will be processed
+    std::uint64_t m_current_tick = 0;
+
+    std::size_t m_active_timers_count = 0;
+
+    detail::TimerWheelEntry m_slots[LEVELS_COUNT][SLOTS_COUNT];
+};
+
+TimerWheel::Impl::Impl(EventLoop& loop, std::uint64_t tick_ms, TimerWheel& parent) :
+    m_parent(&parent),
+    m_loop(&loop),
+    m_uv_timer(new uv_timer_t),
+    m_tick_ms(tick_ms ? tick_ms : 1) {
+    // TODO: check return value
+    uv_timer_init(reinterpret_cast<uv_loop_t*>(loop.raw_loop()), m_uv_timer);
+    m_uv_timer->data = this;
+
+    m_start_time_ms = uv_now(reinterpret_cast<uv_loop_t*>(loop.raw_loop()));
+
+    for (auto& level : m_slots) {
+        for (auto& slot : level) {
+            slot.make_empty_list();
+        }
+    }
+}
+
+namespace {
+
+void on_timer_close(uv_handle_t* handle) {
+    delete reinterpret_cast<uv_timer_t*>(handle);
+}
+
+} // namespace
+
+TimerWheel::Impl::~Impl() {
+    // Detaching remaining entries, so they are not pointing to the destroyed slots
+    for (auto& level : m_slots) {
+        for (auto& slot : level) {
+            while (!slot.is_empty_list()) {
+                slot.next->unlink();
+            }
+        }
+    }
+
+    uv_timer_stop(m_uv_timer);
+    uv_close(reinterpret_cast<uv_handle_t*>(m_uv_timer), on_timer_close);
+}
+
+EventLoop& TimerWheel::Impl::loop() {
+    return *m_loop;
+}
+
+std::uint64_t TimerWheel::Impl::tick_ms() const {
+    return m_tick_ms;
+}
+
+std::size_t TimerWheel::Impl::active_timers_count() const {
+    return m_active_timers_count;
+}
+
+std::uint64_t TimerWheel::Impl::now_ticks() const {
+    return (uv_now(m_uv_timer->loop) - m_start_time_ms) / m_tick_ms;
+}
+
+void TimerWheel::Impl::start_entry(detail::TimerWheelEntry& entry, std::uint64_t timeout_ms) {
+    if (entry.is_linked()) {
+        entry.unlink();
+        --m_active_timers_count;
+    }
+
+    const auto now = now_ticks();
+    if (m_active_timers_count == 0) {
+        // Wheel was idle, so there is nothing to process between the last processed tick and now
+        if (m_current_tick < now) {
+            m_current_tick = now;
+        }
+
+        uv_timer_start(m_uv_timer, on_timer, m_tick_ms, m_tick_ms);
+    }
+
+    // Expiration is computed from exact time, because current tick could be partially elapsed
+    const std::uint64_t expiration_ms = uv_now(m_uv_timer->loop) - m_start_time_ms + timeout_ms;
+    entry.expiration_tick = expiration_ms / m_tick_ms + (expiration_ms % m_tick_ms ? 1 : 0);
+    insert(entry);
+    ++m_active_timers_count;
+}
+
+void TimerWheel::Impl::stop_entry(detail::TimerWheelEntry& entry) {
+    if (!entry.is_linked()) {
+        return;
+    }
+
+    entry.unlink();
+
+    if (--m_active_timers_count == 0) {
+        uv_timer_stop(m_uv_timer);
+    }
+}
+
+void TimerWheel::Impl::insert(detail::TimerWheelEntry& entry) {
+    std::uint64_t expiration_tick = entry.expiration_tick;
+    if (expiration_tick < m_current_tick) {
+        expiration_tick = m_current_tick;
+    } else if (expiration_tick - m_current_tick > MAX_DELAY_TICKS) {
+        expiration_tick = m_current_tick + MAX_DELAY_TICKS;
+    }
+
+    const std::uint64_t delay = expiration_tick - m_current_tick;
+
+    std::size_t level = 0;
+    while (level < LEVELS_COUNT - 1 && delay >> ((level + 1) * SLOT_BITS)) {
+        ++level;
+    }
+
+    const std::size_t slot = (expiration_tick >> (level * SLOT_BITS)) & SLOT_MASK;
+    m_slots[level][slot].push_back(entry);
+}
+
+void TimerWheel::Impl::cascade(std::size_t level) {
+    const std::size_t slot = (m_current_tick >> (level * SLOT_BITS)) & SLOT_MASK;
+
+    detail::TimerWheelEntry entries;
+    entries.make_empty_list();
+    m_slots[level][slot].move_to(entries);
+
+    while (!entries.is_empty_list()) {
+        auto& entry = *entries.next;
+        entry.unlink();
+        insert(entry);
+    }
+
+    // When slot index wraps around, next level should be cascaded too
+    if (slot == 0 && level + 1 < LEVELS_COUNT) {
+        cascade(level + 1);
+    }
+}
+
+void TimerWheel::Impl::process_tick() {
+    const std::size_t slot = m_current_tick & SLOT_MASK;
+    if (slot == 0) {
+        cascade(1);
+    }
+
+    detail::TimerWheelEntry expired;
+    expired.make_empty_list();
+    m_slots[0][slot].move_to(expired);
+
+    // Advancing before callbacks, so timers restarted from them with zero timeout go to the next tick
+    ++m_current_tick;
+
+    while (!expired.is_empty_list()) {
+        auto& entry = *expired.next;
+        entry.unlink();
+        --m_active_timers_count;
+
+        // Callback may stop or restart any other entry including ones from the 'expired' list
+        if (entry.callback) {
+            entry.callback(entry);
+        }
+    }
+}
+
+////////////////////////////////////////////// static //////////////////////////////////////////////
+
+void TimerWheel::Impl::on_timer(uv_timer_t* handle) {
+    assert(handle->data);
+
+    auto& this_ = *reinterpret_cast<TimerWheel::Impl*>(handle->data);
+
+    const auto now = this_.now_ticks();
+    while (this_.m_current_tick <= now && this_.m_active_timers_count) {
+        this_.process_tick();
+    }
+
+    if (this_.m_active_timers_count == 0) {
+        uv_timer_stop(handle);
+    }
+}
+
+///////////////////////////////////////// implementation ///////////////////////////////////////////
+
+TimerWheel::TimerWheel(EventLoop& loop, std::uint64_t tick_ms) :
+    Removable(loop),
+    m_impl(new Impl(loop, tick_ms, *this)) {
+}
+
+TimerWheel::~TimerWheel() {
+}
+
+std::uint64_t TimerWheel::tick_ms() const {
+    return m_impl->tick_ms();
+}
+
+std::size_t TimerWheel::active_timers_count() const {
+    return m_impl->active_timers_count();
+}
+
+EventLoop& TimerWheel::loop() {
+    return m_impl->loop();
+}
+
+void TimerWheel::start_entry(detail::TimerWheelEntry& entry, std::uint64_t timeout_ms) {
+    return m_impl->start_entry(entry, timeout_ms);
+}
+
+void TimerWheel::stop_entry(detail::TimerWheelEntry& entry) {
+    return m_impl->stop_entry(entry);
+}
+
+} // namespace io
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "CommonMacros.h"
+#include "EventLoop.h"
+#include "Export.h"
+#include "Removable.h"
+#include "UserDataHolder.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace io {
+
+namespace detail {
+
+struct TimerWheelEntry;
+
+} // namespace detail
+
+// Hierarchical hashed timing wheel driven by a single uv timer.
+// Timers created with Timer(TimerWheel&) are started, stopped and restarted in O(1) regardless
+// of number of active timers. Timer expires at the first tick of the wheel which is not earlier
+// than the timeout, so it never fires early, but may fire up to the tick later.
+// Wheel should outlive all timers which are backed by it.
+class TimerWheel : public Removable,
+                   public UserDataHolder {
+public:
+    friend class Timer;
+
+    IO_FORBID_COPY(TimerWheel);
+    IO_FORBID_MOVE(TimerWheel);
+
+    IO_DLL_PUBLIC TimerWheel(EventLoop& loop, std::uint64_t tick_ms = 1);
+
+    IO_DLL_PUBLIC std::uint64_t tick_ms() const;
+
+    IO_DLL_PUBLIC std::size_t active_timers_count() const;
+
+protected:
+    IO_DLL_PUBLIC ~TimerWheel();
+
+private:
+    // Interface for Timer
+    EventLoop& loop();
+    void start_entry(detail::TimerWheelEntry& entry, std::uint64_t timeout_ms);
+    void stop_entry(detail::TimerWheelEntry& entry);
+
+    class Impl;
+    std::unique_ptr<Impl> m_impl;
+};
+
+} // namespace io
@@ -62,6 +62,7 @@ void TlsTcpClient::Impl::connect(const Endpoint endpoint,
                                  DataReceiveCallback receive_callback,
                                  CloseCallback close_callback) {
     m_client = new TcpClient(*m_loop);
+    apply_write_watermarks();
 
     if (!is_ssl_inited()) {
         auto context_errror = m_openssl_context.init_ssl_context(ssl_method());
@@ -219,6 +220,42 @@ void TlsTcpClient::send_data(const std::string& message, EndSendCallback callbac
     return m_impl->send_data(message, callback);
 }
 
+void TlsTcpClient::send_data(const std::vector<DataChunk>& chunks, EndSendCallback callback) {
+    return m_impl->send_data(chunks, callback);
+}
+
+std::size_t TlsTcpClient::pending_write_bytes() const {
+    return m_impl->pending_write_bytes();
+}
+
+Error TlsTcpClient::set_write_watermarks(std::size_t low, std::size_t high) {
+    return m_impl->set_write_watermarks(low, high);
+}
+
+bool TlsTcpClient::is_write_buffer_full() const {
+    return m_impl->is_write_buffer_full();
+}
+
+void TlsTcpClient::set_on_write_buffer_full(WriteBufferFullCallback callback) {
+    return m_impl->set_on_write_buffer_full(callback);
+}
+
+void TlsTcpClient::set_on_write_buffer_drained(WriteBufferDrainedCallback callback) {
+    return m_impl->set_on_write_buffer_drained(callback);
+}
+
+Error TlsTcpClient::pause_reading() {
+    return m_impl->pause_reading();
+}
+
+Error TlsTcpClient::resume_reading() {
+    return m_impl->resume_reading();
+}
+
+bool TlsTcpClient::is_reading_paused() const {
+    return m_impl->is_reading_paused();
+}
+
 TlsVersion TlsTcpClient::negotiated_tls_version() const {
     return m_impl->negotiated_tls_version();
 }
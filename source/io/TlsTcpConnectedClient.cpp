@@ -61,6 +61,7 @@ TlsTcpConnectedClient::Impl::Impl(EventLoop& loop,
     m_new_connection_callback(new_connection_callback) {
     m_client = &tcp_client;
     m_client->set_user_data(&parent);
+    apply_write_watermarks();
 }
 
 TlsTcpConnectedClient::Impl::~Impl() {
@@ -202,6 +203,42 @@ void TlsTcpConnectedClient::send_data(const std::string& message, EndSendCallbac
     return m_impl->send_data(message, callback);
 }
 
+void TlsTcpConnectedClient::send_data(const std::vector<DataChunk>& chunks, EndSendCallback callback) {
+    return m_impl->send_data(chunks, callback);
+}
+
+std::size_t TlsTcpConnectedClient::pending_write_bytes() const {
+    return m_impl->pending_write_bytes();
+}
+
+Error TlsTcpConnectedClient::set_write_watermarks(std::size_t low, std::size_t high) {
+    return m_impl->set_write_watermarks(low, high);
+}
+
+bool TlsTcpConnectedClient::is_write_buffer_full() const {
+    return m_impl->is_write_buffer_full();
+}
+
+void TlsTcpConnectedClient::set_on_write_buffer_full(WriteBufferFullCallback callback) {
+    return m_impl->set_on_write_buffer_full(callback);
+}
+
+void TlsTcpConnectedClient::set_on_write_buffer_drained(WriteBufferDrainedCallback callback) {
+    return m_impl->set_on_write_buffer_drained(callback);
+}
+
+Error TlsTcpConnectedClient::pause_reading() {
+    return m_impl->pause_reading();
+}
+
+Error TlsTcpConnectedClient::resume_reading() {
+    return m_impl->resume_reading();
+}
+
+bool TlsTcpConnectedClient::is_reading_paused() const {
+    return m_impl->is_reading_paused();
+}
+
 void TlsTcpConnectedClient::close() {
     return m_impl->close();
 }
@@ -10,6 +10,7 @@
 #include "TlsVersion.h"
 
 #include <memory>
+#include <vector>
 
 namespace io {
 
@@ -23,6 +24,8 @@ public:
     using DataReceiveCallback = std::function<void(TlsTcpConnectedClient&, const DataChunk&, const Error&)>;
     using CloseCallback = std::function<void(TlsTcpConnectedClient&, const Error&)>;
     using EndSendCallback = std::function<void(TlsTcpConnectedClient&, const Error&)>;
+    using WriteBufferFullCallback = std::function<void(TlsTcpConnectedClient&)>;
+    using WriteBufferDrainedCallback = std::function<void(TlsTcpConnectedClient&)>;
 
     using NewConnectionCallback = std::function<void(TlsTcpConnectedClient&, const Error&)>;
 
@@ -35,6 +38,22 @@ public:
 
     IO_DLL_PUBLIC void send_data(std::shared_ptr<const char> buffer, std::uint32_t size, EndSendCallback callback = nullptr);
     IO_DLL_PUBLIC void send_data(const std::string& message, EndSendCallback callback = nullptr);
+    // Chunks are encrypted one after another and sent by a single write of the underlying connection.
+    // Chunks of zero size are skipped. Data is sent from the beginning of the chunk's buffer,
+    // offset is the position in the stream and is ignored (use aliasing shared_ptr for a part of buffer).
+    IO_DLL_PUBLIC void send_data(const std::vector<DataChunk>& chunks, EndSendCallback callback = nullptr);
+
+    // Same as in TcpClient, but encrypted bytes (including TLS records overhead) are counted.
+    IO_DLL_PUBLIC std::size_t pending_write_bytes() const;
+    IO_DLL_PUBLIC Error set_write_watermarks(std::size_t low, std::size_t high);
+    IO_DLL_PUBLIC bool is_write_buffer_full() const;
+    IO_DLL_PUBLIC void set_on_write_buffer_full(WriteBufferFullCallback callback);
+    IO_DLL_PUBLIC void set_on_write_buffer_drained(WriteBufferDrainedCallback callback);
+
+    // Same as in TcpClient. Note: TLS handshake does not progress while reading is paused.
+    IO_DLL_PUBLIC Error pause_reading();
+    IO_DLL_PUBLIC Error resume_reading();
+    IO_DLL_PUBLIC bool is_reading_paused() const;
 
     IO_DLL_PUBLIC TlsTcpServer& server();
     IO_DLL_PUBLIC const TlsTcpServer& server() const;
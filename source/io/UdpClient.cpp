@@ -2,6 +2,9 @@
 
 #include "BacklogWithTimeout.h"
 #include "ByteSwap.h"
+#include "detail/ReceiveBufferPool.h"
+#include "detail/UdpBatchReceiver.h"
+#include "detail/UdpBatchSender.h"
 #include "detail/UdpClientImplBase.h"
 
 #include <cstring>
@@ -26,8 +29,17 @@ public:
 
     Error set_destination(const Endpoint& endpoint);
 
+    Error set_receive_batch_size(std::size_t size);
+    std::size_t receive_batch_size() const;
+
+    void send_batch(std::vector<OutgoingDatagram> datagrams, EndSendCallback callback);
+
 protected:
     Error start_receive_impl();
+    Error start_batch_receive();
+
+    void on_datagram_received(const struct sockaddr* addr, std::shared_ptr<const char> buf, std::size_t size);
+    void on_receive_error(const Error& error);
 
     // statics
     static void on_data_received(
@@ -43,6 +55,17 @@ private:
     // Here is a bit unusual usage of backlog which consists of one single element to track expiration
     std::unique_ptr<BacklogWithTimeout<UdpClient::Impl*>> m_timeout_handler;
     std::function<void(BacklogWithTimeout<UdpClient::Impl*>&, UdpClient::Impl* const& )> m_on_item_expired = nullptr;
+
+    std::size_t m_receive_batch_size = 1;
+    // Buffers are pooled in batch mode only
+    detail::ReceiveBufferPool m_receive_buffer_pool;
+    std::unique_ptr<detail::UdpBatchReceiver> m_batch_receiver;
+
+    struct SendBatch : public detail::UdpBatchSender::Batch {
+        std::vector<OutgoingDatagram> datagrams;
+    };
+
+    std::unique_ptr<detail::UdpBatchSender> m_batch_sender;
 };
 
 UdpClient::Impl::Impl(EventLoop& loop, UdpClient& parent) :
@@ -112,7 +135,15 @@ bool UdpClient::Impl::close(CloseHandler handler) {
             uv_udp_recv_stop(m_udp_handle.get());
         }
 
+        if (m_batch_receiver) {
+            m_batch_receiver->stop();
+        }
+
         uv_close(reinterpret_cast<uv_handle_t*>(m_udp_handle.get()), handler);
+        // After closing, so callbacks could not close client again
+        if (m_batch_sender) {
+            m_batch_sender->cancel();
+        }
         return false; // not ready to remove
     }
 
@@ -125,6 +156,10 @@ Error UdpClient::Impl::start_receive_impl() {
         return handle_init_error;
     }
 
+    if (m_receive_batch_size > 1 && detail::UdpBatchReceiver::is_supported()) {
+        return start_batch_receive();
+    }
+
     Error recv_start_error = uv_udp_recv_start(m_udp_handle.get(), detail::default_alloc_buffer, on_data_received);
     if (recv_start_error) {
         return recv_start_error;
@@ -133,6 +168,147 @@ Error UdpClient::Impl::start_receive_impl() {
     return Error(0);
 }
 
+Error UdpClient::Impl::start_batch_receive() {
+    if ((m_udp_handle.get()->flags & IO_UV_HANDLE_BOUND) == 0) {
+        // uv_udp_recv_start binds socket implicitly, doing the same here
+        ::sockaddr_in address;
+        uv_ip4_addr("0.0.0.0", 0, &address);
+        const Error bind_error = uv_udp_bind(m_udp_handle.get(), reinterpret_cast<const ::sockaddr*>(&address), 0);
+        if (bind_error) {
+            return bind_error;
+        }
+    }
+
+    if (!m_batch_receiver) {
+        m_batch_receiver.reset(new detail::UdpBatchReceiver(m_receive_buffer_pool));
+    }
+
+    return m_batch_receiver->start(
+        m_udp_handle.get(),
+        m_receive_batch_size,
+        [this](detail::UdpBatchReceiver::Datagram* datagrams, std::size_t count) {
+            this->set_last_packet_time(::uv_hrtime());
+
+            // Client could be closed from the callback while there are still datagrams in the batch
+            for (std::size_t i = 0; i < count && this->is_open(); ++i) {
+                this->on_datagram_received(datagrams[i].address, std::move(datagrams[i].buf), datagrams[i].size);
+            }
+        },
+        [this](const Error& error) {
+            this->on_receive_error(error);
+        }
+    );
+}
+
+Error UdpClient::Impl::set_receive_batch_size(std::size_t size) {
+    if (size == 0 || size > detail::UdpBatchReceiver::MAX_BATCH_SIZE) {
+        return Error(StatusCode::INVALID_ARGUMENT);
+    }
+
+    m_receive_batch_size = size;
+
+    const std::size_t buffers_count = size + detail::ReceiveBufferPool::DEFAULT_MAX_BUFFERS_COUNT;
+    if (m_receive_buffer_pool.max_buffers_count() < buffers_count) {
+        m_receive_buffer_pool.set_max_buffers_count(buffers_count);
+    }
+
+    return Error(0);
+}
+
+std::size_t UdpClient::Impl::receive_batch_size() const {
+    return m_receive_batch_size;
+}
+
+void UdpClient::Impl::send_batch(std::vector<OutgoingDatagram> datagrams, EndSendCallback callback) {
+    auto parent = m_parent;
+
+    Error error(0);
+    const auto handle_init_error = ensure_handle_inited();
+    if (handle_init_error) {
+        error = handle_init_error;
+    } else if (datagrams.empty()) {
+        error = Error(StatusCode::INVALID_ARGUMENT);
+    } else if (!is_open()) {
+        error = Error(StatusCode::OPERATION_CANCELED);
+    } else if (m_destination_endpoint.type() == Endpoint::UNDEFINED) {
+        error = Error(StatusCode::DESTINATION_ADDRESS_REQUIRED);
+    }
+
+    if (error) {
+        auto shared_datagrams = std::make_shared<std::vector<OutgoingDatagram>>(std::move(datagrams));
+        m_loop->schedule_callback([=]() {
+            for (auto& datagram : *shared_datagrams) {
+                if (datagram.end_send_callback) {
+                    datagram.end_send_callback(*parent, error);
+                }
+            }
+
+            if (callback) {
+                callback(*parent, error);
+            }
+        });
+        return;
+    }
+
+    this->set_last_packet_time(::uv_hrtime());
+
+    if (!m_batch_sender) {
+        m_batch_sender.reset(new detail::UdpBatchSender(m_uv_loop, m_udp_handle.get()));
+    }
+
+    auto batch = std::make_shared<SendBatch>();
+    batch->datagrams = std::move(datagrams);
+
+    // Batch owns callbacks, so raw pointer is valid while they are alive
+    auto batch_ptr = batch.get();
+    batch->on_datagram_sent = [batch_ptr, parent](std::size_t index, const Error& error) {
+        auto& datagram = batch_ptr->datagrams[index];
+        if (datagram.end_send_callback) {
+            datagram.end_send_callback(*parent, error);
+        }
+    };
+
+    if (callback) {
+        batch->on_batch_sent = [parent, callback](const Error& error) {
+            callback(*parent, error);
+        };
+    }
+
+    for (std::size_t i = 0; i < batch->datagrams.size(); ++i) {
+        const auto& datagram = batch->datagrams[i];
+        m_batch_sender->enqueue(batch,
+                                i,
+                                reinterpret_cast<const ::sockaddr*>(m_raw_endpoint),
+                                datagram.buf,
+                                datagram.size);
+    }
+}
+
+void UdpClient::Impl::on_datagram_received(const struct sockaddr* addr, std::shared_ptr<const char> buf, std::size_t size) {
+    if (!m_receive_callback) {
+        return;
+    }
+
+    const auto& address_in_from = *reinterpret_cast<const struct sockaddr_in*>(addr);
+    const auto& address_in_expect = *reinterpret_cast<sockaddr_in*>(m_destination_endpoint.raw_endpoint());
+
+    if (address_in_from.sin_addr.s_addr == address_in_expect.sin_addr.s_addr &&
+        address_in_from.sin_port == address_in_expect.sin_port) {
+
+        DataChunk data_chunk(buf, size);
+        m_receive_callback(*m_parent, data_chunk, Error(0));
+    }
+}
+
+void UdpClient::Impl::on_receive_error(const Error& error) {
+    if (!m_receive_callback) {
+        return;
+    }
+
+    DataChunk data(nullptr, 0);
+    m_receive_callback(*m_parent, data, error);
+}
+
 ///////////////////////////////////////////  static  ////////////////////////////////////////////
 
 void UdpClient::Impl::on_data_received(uv_udp_t* handle,
@@ -142,33 +318,19 @@ void UdpClient::Impl::on_data_received(uv_udp_t* handle,
                                        unsigned flags) {
     assert(handle);
     auto& this_ = *reinterpret_cast<UdpClient::Impl*>(handle->data);
-    auto& parent = *this_.m_parent;
 
     this_.set_last_packet_time(::uv_hrtime());
 
     std::shared_ptr<const char> buf(uv_buf->base, std::default_delete<char[]>());
 
-    if (!this_.m_receive_callback) {
-        return;
-    }
-
     Error error(nread);
 
     if (!error) {
         if (addr && nread) {
-            const auto& address_in_from = *reinterpret_cast<const struct sockaddr_in*>(addr);
-            const auto& address_in_expect = *reinterpret_cast<sockaddr_in*>(this_.m_destination_endpoint.raw_endpoint());
-
-            if (address_in_from.sin_addr.s_addr == address_in_expect.sin_addr.s_addr &&
-                address_in_from.sin_port == address_in_expect.sin_port) {
-
-                DataChunk data_chunk(buf, std::size_t(nread));
-                this_.m_receive_callback(parent, data_chunk, error);
-            }
+            this_.on_datagram_received(addr, buf, std::size_t(nread));
         }
     } else {
-        DataChunk data(nullptr, 0);
-        this_.m_receive_callback(parent, data, error);
+        this_.on_receive_error(error);
     }
 }
 
@@ -215,6 +377,18 @@ void UdpClient::send_data(std::shared_ptr<const char> buffer, std::uint32_t size
     return m_impl->send_data(buffer, size, callback);
 }
 
+Error UdpClient::set_receive_batch_size(std::size_t size) {
+    return m_impl->set_receive_batch_size(size);
+}
+
+std::size_t UdpClient::receive_batch_size() const {
+    return m_impl->receive_batch_size();
+}
+
+void UdpClient::send_batch(std::vector<OutgoingDatagram> datagrams, EndSendCallback callback) {
+    return m_impl->send_batch(std::move(datagrams), callback);
+}
+
 void UdpClient::schedule_removal() {
     const bool ready_to_remove = m_impl->close_with_removal();
     if (ready_to_remove) {
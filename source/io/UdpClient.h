@@ -11,8 +11,10 @@
 #include "Removable.h"
 #include "UserDataHolder.h"
 
+#include <cstdint>
 #include <memory>
 #include <functional>
+#include <vector>
 
 namespace io {
 
@@ -23,6 +25,13 @@ public:
     using DataReceivedCallback = std::function<void(UdpClient&, const DataChunk&, const Error&)>;
     using TimeoutCallback = std::function<void(UdpClient&, const Error&)>;
 
+    // Datagram of outgoing batch, callback is optional
+    struct OutgoingDatagram {
+        std::shared_ptr<const char> buf;
+        std::uint32_t size;
+        EndSendCallback end_send_callback;
+    };
+
     IO_FORBID_COPY(UdpClient);
     IO_FORBID_MOVE(UdpClient);
 
@@ -45,10 +54,20 @@ public:
     IO_DLL_PUBLIC Error set_receive_buffer_size(std::size_t size);
     IO_DLL_PUBLIC Error set_send_buffer_size(std::size_t size);
 
+    // Max number of datagrams received by a single system call, default is 1. Values greater than 1
+    // enable batch receive via recvmmsg on Linux. Should be set before start_receive.
+    IO_DLL_PUBLIC Error set_receive_batch_size(std::size_t size);
+    IO_DLL_PUBLIC std::size_t receive_batch_size() const;
+
     // TODO: r-value std::string for send data
     IO_DLL_PUBLIC void send_data(std::shared_ptr<const char> buffer, std::uint32_t size, EndSendCallback callback = nullptr);
     IO_DLL_PUBLIC void send_data(const std::string& message, EndSendCallback callback = nullptr);
 
+    // Datagrams are queued and sent together with all other queued ones right before the loop waits for I/O.
+    // On Linux this is done by sendmmsg, many datagrams per system call. Batch callback is called when all
+    // datagrams are processed and receives the first error if any.
+    IO_DLL_PUBLIC void send_batch(std::vector<OutgoingDatagram> datagrams, EndSendCallback callback = nullptr);
+
     IO_DLL_PUBLIC void schedule_removal() override;
 
 protected:
@@ -24,9 +24,15 @@ public:
 
     const detail::PeerId& id() const;
 
+    bool is_recyclable() const;
+    void set_recyclable(bool recyclable);
+
+    void reset(const void* address, const detail::PeerId& id);
+
 private:
     UdpServer* m_server = nullptr;
-    const detail::PeerId m_id;
+    detail::PeerId m_id;
+    bool m_recyclable = false;
 };
 
 UdpPeer::Impl::Impl(EventLoop& loop, UdpServer& server, void* udp_handle, const Endpoint& endpoint, const detail::PeerId& id, UdpPeer& parent) :
@@ -54,6 +60,20 @@ const detail::PeerId& UdpPeer::Impl::id() const {
     return m_id;
 }
 
+bool UdpPeer::Impl::is_recyclable() const {
+    return m_recyclable;
+}
+
+void UdpPeer::Impl::set_recyclable(bool recyclable) {
+    m_recyclable = recyclable;
+}
+
+void UdpPeer::Impl::reset(const void* address, const detail::PeerId& id) {
+    m_destination_endpoint.assign(address);
+    m_id = id;
+    set_last_packet_time(::uv_hrtime());
+}
+
 /////////////////////////////////////////// interface ///////////////////////////////////////////
 
 UdpPeer::UdpPeer(EventLoop& loop, UdpServer& server, void* udp_handle, const Endpoint& endpoint, const detail::PeerId& id) :
@@ -104,4 +124,30 @@ const Endpoint& UdpPeer::endpoint() const {
     return m_impl->endpoint();
 }
 
+void UdpPeer::set_on_schedule_removal(OnScheduleRemovalCallback callback) {
+    m_impl->set_recyclable(false);
+    Removable::set_on_schedule_removal(callback);
+}
+
+void UdpPeer::schedule_removal() {
+    if (m_impl->is_recyclable()) {
+        m_impl->server().recycle_peer(*this);
+        return;
+    }
+
+    remove();
+}
+
+void UdpPeer::set_recyclable(bool recyclable) {
+    m_impl->set_recyclable(recyclable);
+}
+
+void UdpPeer::reset(const void* address, const detail::PeerId& id) {
+    m_impl->reset(address, id);
+}
+
+void UdpPeer::remove() {
+    Removable::schedule_removal();
+}
+
 } // namespace io
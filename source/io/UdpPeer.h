@@ -36,7 +36,9 @@ public:
 
     IO_DLL_PUBLIC bool is_open() const;
 
-    using Removable::set_on_schedule_removal;
+    // Untracked peers are recycled by the server when the last reference is released,
+    // peers with this callback set are removed instead.
+    IO_DLL_PUBLIC void set_on_schedule_removal(OnScheduleRemovalCallback callback);
 
     IO_DLL_PUBLIC UdpServer& server();
     IO_DLL_PUBLIC const UdpServer& server() const;
@@ -55,6 +57,12 @@ private:
     IO_DLL_PUBLIC void set_last_packet_time(std::uint64_t time);
     const detail::PeerId& id() const;
 
+    // Interface for UdpServer to pool untracked peers
+    void schedule_removal() override;
+    void set_recyclable(bool recyclable);
+    void reset(const void* address, const detail::PeerId& id);
+    void remove();
+
     class Impl;
     std::unique_ptr<Impl> m_impl;
 };
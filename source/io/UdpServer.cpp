@@ -7,11 +7,16 @@
 
 #include "detail/Common.h"
 #include "detail/PeerId.h"
+#include "detail/PeerTable.h"
+#include "detail/ReceiveBufferPool.h"
+#include "detail/UdpBatchReceiver.h"
+#include "detail/UdpBatchSender.h"
 #include "detail/UdpImplBase.h"
 
+#include <algorithm>
 #include <iostream>
 #include <assert.h>
-#include <unordered_map>
+#include <vector>
 
 namespace io {
 
@@ -23,33 +28,115 @@ public:
     Error start_receive(const Endpoint& endpoint, DataReceivedCallback data_receive_callback);
     Error start_receive(const Endpoint& endpoint, NewPeerCallback new_peer_callback, DataReceivedCallback receive_callback, std::size_t timeout_ms, PeerTimeoutCallback timeout_callback);
 
+    Error start_receive_batch(const Endpoint& endpoint, DataBatchReceivedCallback receive_callback);
+    Error start_receive_batch(const Endpoint& endpoint, NewPeerCallback new_peer_callback, DataBatchReceivedCallback receive_callback, std::size_t timeout_ms, PeerTimeoutCallback timeout_callback);
+
+    void send_batch(std::vector<OutgoingDatagram> datagrams, EndSendBatchCallback callback);
+
     void close(CloseServerCallback close_callback);
     bool close_with_removal();
 
     bool peer_bookkeeping_enabled() const;
 
     void close_peer(UdpPeer& peer, std::size_t inactivity_timeout_ms);
+    void recycle_peer(UdpPeer& peer);
+
+    std::size_t allocated_untracked_peers_count() const;
+    std::size_t reused_untracked_peers_count() const;
 
     bool schedule_removal();
 
+    Error set_max_datagram_size(std::size_t size);
+    std::size_t max_datagram_size() const;
+
+    std::size_t receive_buffer_pool_hits() const;
+    std::size_t receive_buffer_pool_misses() const;
+
+    Error set_receive_batch_size(std::size_t size);
+    std::size_t receive_batch_size() const;
+
+    Error set_read_buffer_allocator(const ReadBufferAllocator& allocator);
+
 protected:
+    Error start_receive_impl();
+    void enable_peer_bookkeeping(NewPeerCallback new_peer_callback, std::size_t timeout_ms, PeerTimeoutCallback timeout_callback);
+
+    // Returns referenced peer (caller should unref it) or nullptr if datagram should be ignored
+    UdpPeer* acquire_peer(const struct sockaddr* addr);
+
+    void free_untracked_peers();
+    void clear_peers();
+
+    bool is_peer_inactive(const detail::PeerId& peer_id);
+    void expire_inactive_peers();
+    void schedule_inactive_peers_expiration();
+
+    void on_datagrams_received(detail::UdpBatchReceiver::Datagram* datagrams, std::size_t count);
+    void on_receive_error(const Error& error);
+
     // statics
+    static void on_alloc_buffer(uv_handle_t* handle, std::size_t suggested_size, uv_buf_t* buf);
     static void on_data_received(
         uv_udp_t* handle, ssize_t nread, const uv_buf_t* uv_buf, const struct sockaddr* addr, unsigned flags);
     static void on_close(uv_handle_t* handle);
 
-    static void free_udp_peer(UdpPeer* peer);
-
 private:
     NewPeerCallback m_new_peer_callback = nullptr;
     DataReceivedCallback m_data_receive_callback = nullptr;
+    DataBatchReceivedCallback m_data_batch_receive_callback = nullptr;
     PeerTimeoutCallback m_peer_timeout_callback = nullptr;
 
     CloseServerCallback m_server_close_callback = nullptr;
 
-    std::unordered_map<detail::PeerId, std::shared_ptr<UdpPeer>> m_peers;
-    std::unordered_map<detail::PeerId, std::unique_ptr<Timer, typename Timer::DefaultDelete>> m_inactive_peers;
-    std::unique_ptr<BacklogWithTimeout<std::shared_ptr<UdpPeer>>> m_peers_backlog;
+    using PeersBacklog = BacklogWithTimeout<UdpPeer*>;
+
+    // Table holds a reference to the peer
+    struct TrackedPeer {
+        UdpPeer* peer = nullptr;
+        PeersBacklog::ItemHandle backlog_handle;
+    };
+
+    detail::PeerTable<TrackedPeer> m_peers;
+
+    // Closed peers are quarantined for the inactivity timeout, datagrams from them are ignored.
+    // Expiration times (uv_hrtime based) are kept in the table and ordered by the min-heap,
+    // single timer fires at the earliest expiration. Heap entries of peers which were removed
+    // from the table or quarantined again are skipped.
+    struct InactivePeer {
+        std::uint64_t expiration_time;
+        detail::PeerId id;
+    };
+
+    struct InactivePeerGreater {
+        bool operator()(const InactivePeer& lhs, const InactivePeer& rhs) const {
+            return lhs.expiration_time > rhs.expiration_time;
+        }
+    };
+
+    detail::PeerTable<std::uint64_t> m_inactive_peers;
+    std::vector<InactivePeer> m_inactive_peers_heap;
+    std::unique_ptr<Timer, typename Timer::DefaultDelete> m_inactive_peers_timer;
+    std::uint64_t m_inactive_peers_timer_expiration_time = 0;
+    std::unique_ptr<PeersBacklog> m_peers_backlog;
+
+    detail::ReceiveBufferPool m_receive_buffer_pool;
+    // Buffer given to libuv in allocation callback and consumed in receive callback
+    std::shared_ptr<char> m_receive_buffer;
+
+    std::size_t m_receive_batch_size = 1;
+    std::unique_ptr<detail::UdpBatchReceiver> m_batch_receiver;
+    std::vector<ReceivedDatagram> m_received_batch;
+
+    struct SendBatch : public detail::UdpBatchSender::Batch {
+        std::vector<OutgoingDatagram> datagrams;
+    };
+
+    std::unique_ptr<detail::UdpBatchSender> m_batch_sender;
+
+    static const std::size_t MAX_FREE_UNTRACKED_PEERS_COUNT = 1024;
+    std::vector<UdpPeer*> m_free_untracked_peers;
+    std::size_t m_allocated_untracked_peers_count = 0;
+    std::size_t m_reused_untracked_peers_count = 0;
 };
 
 UdpServer::Impl::Impl(EventLoop& loop, UdpServer& parent) :
@@ -81,7 +168,50 @@ Error UdpServer::Impl::start_receive(const Endpoint& endpoint, DataReceivedCallb
 
     m_data_receive_callback = data_receive_callback;
 
-    Error receive_start_error = uv_udp_recv_start(m_udp_handle.get(), detail::default_alloc_buffer, on_data_received);
+    return start_receive_impl();
+}
+
+Error UdpServer::Impl::start_receive_batch(const Endpoint& endpoint, DataBatchReceivedCallback receive_callback) {
+    IO_LOG(m_loop, TRACE, m_parent, "");
+
+    Error bind_error = bind(endpoint);
+    if (bind_error) {
+        return bind_error;
+    }
+
+    m_data_batch_receive_callback = receive_callback;
+
+    return start_receive_impl();
+}
+
+Error UdpServer::Impl::start_receive_batch(const Endpoint& endpoint,
+                                           NewPeerCallback new_peer_callback,
+                                           DataBatchReceivedCallback receive_callback,
+                                           std::size_t timeout_ms,
+                                           PeerTimeoutCallback timeout_callback) {
+    enable_peer_bookkeeping(new_peer_callback, timeout_ms, timeout_callback);
+    return start_receive_batch(endpoint, receive_callback);
+}
+
+Error UdpServer::Impl::start_receive_impl() {
+    if (m_receive_batch_size > 1 && detail::UdpBatchReceiver::is_supported()) {
+        if (!m_batch_receiver) {
+            m_batch_receiver.reset(new detail::UdpBatchReceiver(m_receive_buffer_pool));
+        }
+
+        return m_batch_receiver->start(
+            m_udp_handle.get(),
+            m_receive_batch_size,
+            [this](detail::UdpBatchReceiver::Datagram* datagrams, std::size_t count) {
+                this->on_datagrams_received(datagrams, count);
+            },
+            [this](const Error& error) {
+                this->on_receive_error(error);
+            }
+        );
+    }
+
+    Error receive_start_error = uv_udp_recv_start(m_udp_handle.get(), on_alloc_buffer, on_data_received);
     if (receive_start_error) {
         return receive_start_error;
     }
@@ -94,6 +224,13 @@ Error UdpServer::Impl::start_receive(const Endpoint& endpoint,
                                      DataReceivedCallback receive_callback,
                                      std::size_t timeout_ms,
                                      PeerTimeoutCallback timeout_callback) {
+    enable_peer_bookkeeping(new_peer_callback, timeout_ms, timeout_callback);
+    return start_receive(endpoint, receive_callback);
+}
+
+void UdpServer::Impl::enable_peer_bookkeeping(NewPeerCallback new_peer_callback,
+                                              std::size_t timeout_ms,
+                                              PeerTimeoutCallback timeout_callback) {
     if (timeout_ms == 0) {
         // TODO: error
     }
@@ -102,24 +239,76 @@ Error UdpServer::Impl::start_receive(const Endpoint& endpoint,
     m_peer_timeout_callback = timeout_callback;
 
     // TODO: bind instead of lambdas
-    auto on_expired = [this](io::BacklogWithTimeout<std::shared_ptr<UdpPeer>>&, const std::shared_ptr<UdpPeer>& item) {
-        m_peer_timeout_callback(*item, Error(0));
-
-        auto it = m_peers.find(item->id());
-        if (it != m_peers.end()) {
-            m_peers.erase(it);
+    auto on_expired = [this](PeersBacklog&, UdpPeer* const& item) {
+        UdpPeer* peer = item;
+        m_peer_timeout_callback(*peer, Error(0));
+
+        auto tracked_peer = m_peers.find(peer->id());
+        if (tracked_peer && tracked_peer->peer == peer) {
+            m_peers.erase(peer->id());
+            peer->unref();
         } else {
             // TODO: error handling
         }
     };
 
-    auto time_getter = [](const std::shared_ptr<UdpPeer>& item) -> std::uint64_t {
+    auto time_getter = [](UdpPeer* const& item) -> std::uint64_t {
         return item->last_packet_time();
     };
 
-    m_peers_backlog.reset(new BacklogWithTimeout<std::shared_ptr<UdpPeer>>(*m_loop, timeout_ms, on_expired, time_getter, &uv_hrtime));
+    m_peers_backlog.reset(new PeersBacklog(*m_loop, timeout_ms, on_expired, time_getter, &uv_hrtime));
+}
 
-    return start_receive(endpoint, receive_callback);
+void UdpServer::Impl::send_batch(std::vector<OutgoingDatagram> datagrams, EndSendBatchCallback callback) {
+    auto parent = m_parent;
+
+    if (datagrams.empty() || !is_open()) {
+        const Error error = datagrams.empty() ? Error(StatusCode::INVALID_ARGUMENT) : Error(StatusCode::OPERATION_CANCELED);
+        auto shared_datagrams = std::make_shared<std::vector<OutgoingDatagram>>(std::move(datagrams));
+        m_loop->schedule_callback([=]() {
+            for (auto& datagram : *shared_datagrams) {
+                if (datagram.end_send_callback) {
+                    datagram.end_send_callback(*parent, datagram.endpoint, error);
+                }
+            }
+
+            if (callback) {
+                callback(*parent, error);
+            }
+        });
+        return;
+    }
+
+    if (!m_batch_sender) {
+        m_batch_sender.reset(new detail::UdpBatchSender(m_uv_loop, m_udp_handle.get()));
+    }
+
+    auto batch = std::make_shared<SendBatch>();
+    batch->datagrams = std::move(datagrams);
+
+    // Batch owns callbacks, so raw pointer is valid while they are alive
+    auto batch_ptr = batch.get();
+    batch->on_datagram_sent = [batch_ptr, parent](std::size_t index, const Error& error) {
+        auto& datagram = batch_ptr->datagrams[index];
+        if (datagram.end_send_callback) {
+            datagram.end_send_callback(*parent, datagram.endpoint, error);
+        }
+    };
+
+    if (callback) {
+        batch->on_batch_sent = [parent, callback](const Error& error) {
+            callback(*parent, error);
+        };
+    }
+
+    for (std::size_t i = 0; i < batch->datagrams.size(); ++i) {
+        const auto& datagram = batch->datagrams[i];
+        m_batch_sender->enqueue(batch,
+                                i,
+                                reinterpret_cast<const ::sockaddr*>(datagram.endpoint.raw_endpoint()),
+                                datagram.buf,
+                                datagram.size);
+    }
 }
 
 void UdpServer::Impl::close(CloseServerCallback close_callback) {
@@ -128,20 +317,32 @@ void UdpServer::Impl::close(CloseServerCallback close_callback) {
     if (is_open()) {
         m_server_close_callback = close_callback;
         uv_udp_recv_stop(m_udp_handle.get());
+        if (m_batch_receiver) {
+            m_batch_receiver->stop();
+        }
         uv_close(reinterpret_cast<uv_handle_t*>(m_udp_handle.get()), on_close);
+        // After closing, so callbacks could not close server again
+        if (m_batch_sender) {
+            m_batch_sender->cancel();
+        }
     }
 }
 
 bool UdpServer::Impl::close_with_removal() {
     if (is_open()) {
         Error error = uv_udp_recv_stop(m_udp_handle.get());
+        if (m_batch_receiver) {
+            m_batch_receiver->stop();
+        }
         uv_close(reinterpret_cast<uv_handle_t*>(m_udp_handle.get()), on_close_with_removal);
+        if (m_batch_sender) {
+            m_batch_sender->cancel();
+        }
         return false; // not ready to remove
     }
 
-    m_peers.clear();
-    m_inactive_peers.clear();
-    m_peers_backlog.reset();
+    clear_peers();
+    free_untracked_peers();
 
     return true;
 }
@@ -155,33 +356,304 @@ void UdpServer::Impl::close_peer(UdpPeer& peer, std::size_t inactivity_timeout_m
 
     const auto peer_id = peer.id();
 
-    auto it = m_inactive_peers.find(peer_id);
-    if (it != m_inactive_peers.end()) {
+    if (is_peer_inactive(peer_id)) {
         return;
     }
 
-    auto timer = new Timer(*m_loop);
-    m_inactive_peers.insert(std::make_pair(peer_id,
-                                           std::unique_ptr<Timer,
-                                                           typename Timer::DefaultDelete>
-                                                          (timer, Timer::default_delete())));
-    timer->start(inactivity_timeout_ms,
-                 [this, peer_id] (Timer& timer) {
-                     m_inactive_peers.erase(peer_id);
-                 });
+    const std::uint64_t expiration_time = ::uv_hrtime() + std::uint64_t(inactivity_timeout_ms) * 1000000;
+    *m_inactive_peers.insert(peer_id).first = expiration_time;
+
+    m_inactive_peers_heap.push_back({expiration_time, peer_id});
+    std::push_heap(m_inactive_peers_heap.begin(), m_inactive_peers_heap.end(), InactivePeerGreater());
 
-    auto active_it = m_peers.find(peer_id);
-    if (active_it == m_peers.end()) {
+    if (m_inactive_peers_timer_expiration_time == 0 || expiration_time < m_inactive_peers_timer_expiration_time) {
+        schedule_inactive_peers_expiration();
+    }
+
+    auto tracked_peer = m_peers.find(peer_id);
+    if (tracked_peer == nullptr) {
         // TODO: log error
         return;
     }
 
-    m_peers_backlog->remove_item(active_it->second);
-    m_peers.erase(active_it);
+    auto active_peer = tracked_peer->peer;
+    m_peers_backlog->remove_item(tracked_peer->backlog_handle);
+    m_peers.erase(peer_id);
+    active_peer->unref();
+}
+
+void UdpServer::Impl::recycle_peer(UdpPeer& peer) {
+    if (!is_open() || !peer.is_open() || m_free_untracked_peers.size() >= MAX_FREE_UNTRACKED_PEERS_COUNT) {
+        peer.remove();
+        return;
+    }
+
+    peer.set_user_data(nullptr);
+    m_free_untracked_peers.push_back(&peer);
+}
+
+void UdpServer::Impl::free_untracked_peers() {
+    for (auto peer : m_free_untracked_peers) {
+        delete peer;
+    }
+
+    m_free_untracked_peers.clear();
+}
+
+void UdpServer::Impl::clear_peers() {
+    // Backlog does not own peers, so it is reset first
+    m_peers_backlog.reset();
+
+    m_inactive_peers_timer.reset();
+    m_inactive_peers_timer_expiration_time = 0;
+    m_inactive_peers_heap.clear();
+    m_inactive_peers.clear();
+
+    auto peers = std::move(m_peers);
+    peers.for_each([](const detail::PeerId&, TrackedPeer& tracked_peer) {
+        tracked_peer.peer->unref();
+    });
+}
+
+bool UdpServer::Impl::is_peer_inactive(const detail::PeerId& peer_id) {
+    auto expiration_time = m_inactive_peers.find(peer_id);
+    if (expiration_time == nullptr) {
+        return false;
+    }
+
+    // Timer may be late, expiration time is checked here to be exact
+    if (*expiration_time <= ::uv_hrtime()) {
+        m_inactive_peers.erase(peer_id);
+        return false;
+    }
+
+    return true;
+}
+
+void UdpServer::Impl::expire_inactive_peers() {
+    m_inactive_peers_timer_expiration_time = 0;
+
+    const auto current_time = ::uv_hrtime();
+    while (!m_inactive_peers_heap.empty() && m_inactive_peers_heap.front().expiration_time <= current_time) {
+        const auto inactive_peer = m_inactive_peers_heap.front();
+        std::pop_heap(m_inactive_peers_heap.begin(), m_inactive_peers_heap.end(), InactivePeerGreater());
+        m_inactive_peers_heap.pop_back();
+
+        auto expiration_time = m_inactive_peers.find(inactive_peer.id);
+        if (expiration_time && *expiration_time == inactive_peer.expiration_time) {
+            m_inactive_peers.erase(inactive_peer.id);
+        }
+    }
+
+    if (!m_inactive_peers_heap.empty()) {
+        schedule_inactive_peers_expiration();
+    }
+}
+
+void UdpServer::Impl::schedule_inactive_peers_expiration() {
+    if (!m_inactive_peers_timer) {
+        m_inactive_peers_timer = std::unique_ptr<Timer, typename Timer::DefaultDelete>(new Timer(*m_loop),
+                                                                                       Timer::default_delete());
+    }
+
+    const auto expiration_time = m_inactive_peers_heap.front().expiration_time;
+    const auto current_time = ::uv_hrtime();
+    // Rounding up to milliseconds, so peer is expired when timer fires
+    const std::uint64_t timeout_ms = expiration_time > current_time ?
+                                     (expiration_time - current_time + 999999) / 1000000 :
+                                     0;
+
+    m_inactive_peers_timer_expiration_time = expiration_time;
+    m_inactive_peers_timer->start(timeout_ms, [this](Timer&) {
+        expire_inactive_peers();
+    });
+}
+
+std::size_t UdpServer::Impl::allocated_untracked_peers_count() const {
+    return m_allocated_untracked_peers_count;
+}
+
+std::size_t UdpServer::Impl::reused_untracked_peers_count() const {
+    return m_reused_untracked_peers_count;
+}
+
+Error UdpServer::Impl::set_max_datagram_size(std::size_t size) {
+    if (size == 0 || size > detail::ReceiveBufferPool::DEFAULT_BUFFER_SIZE) {
+        return Error(StatusCode::INVALID_ARGUMENT);
+    }
+
+    m_receive_buffer_pool.set_buffer_size(size);
+    return Error(0);
+}
+
+std::size_t UdpServer::Impl::max_datagram_size() const {
+    return m_receive_buffer_pool.buffer_size();
+}
+
+std::size_t UdpServer::Impl::receive_buffer_pool_hits() const {
+    return m_receive_buffer_pool.hits();
+}
+
+std::size_t UdpServer::Impl::receive_buffer_pool_misses() const {
+    return m_receive_buffer_pool.misses();
+}
+
+Error UdpServer::Impl::set_receive_batch_size(std::size_t size) {
+    if (size == 0 || size > detail::UdpBatchReceiver::MAX_BATCH_SIZE) {
+        return Error(StatusCode::INVALID_ARGUMENT);
+    }
+
+    m_receive_batch_size = size;
+
+    // Each datagram of the batch is received to its own buffer which is held until datagram arrives
+    const std::size_t buffers_count = size + detail::ReceiveBufferPool::DEFAULT_MAX_BUFFERS_COUNT;
+    if (m_receive_buffer_pool.max_buffers_count() < buffers_count) {
+        m_receive_buffer_pool.set_max_buffers_count(buffers_count);
+    }
+
+    return Error(0);
+}
+
+std::size_t UdpServer::Impl::receive_batch_size() const {
+    return m_receive_batch_size;
+}
+
+Error UdpServer::Impl::set_read_buffer_allocator(const ReadBufferAllocator& allocator) {
+    if (!allocator.is_valid()) {
+        return Error(StatusCode::INVALID_ARGUMENT);
+    }
+
+    // Buffer which is held for the next datagram belongs to the previous allocator
+    m_receive_buffer.reset();
+    m_receive_buffer_pool.set_allocator(allocator);
+    return Error(0);
+}
+
+UdpPeer* UdpServer::Impl::acquire_peer(const struct sockaddr* addr) {
+    detail::PeerId peer_id{addr};
+
+    if (!peer_bookkeeping_enabled()) {
+        // Ref/Unref semantics here was added to prolong lifetime of oneshot UdpPeer objects
+        // and to allow call send data in receive callback for UdpServer without peers tracking.
+        // When the last reference is released, peer returns to m_free_untracked_peers (see recycle_peer).
+        UdpPeer* peer = nullptr;
+        if (!m_free_untracked_peers.empty()) {
+            peer = m_free_untracked_peers.back();
+            m_free_untracked_peers.pop_back();
+            peer->reset(addr, peer_id);
+            peer->ref();
+            ++m_reused_untracked_peers_count;
+        } else {
+            peer = new UdpPeer(*m_loop,
+                               *m_parent,
+                               m_udp_handle.get(),
+                               {addr},
+                               peer_id); // Ref count is == 1 here
+            peer->set_recyclable(true);
+            ++m_allocated_untracked_peers_count;
+        }
+
+        IO_LOG(m_loop, TRACE, m_parent, "New untracked peer:", peer->endpoint());
+        return peer;
+    }
+
+    if (is_peer_inactive(peer_id)) {
+        const Endpoint e{addr};
+        IO_LOG(m_loop, TRACE, m_parent, "Peer", e, "is inactive, ignoring packet");
+        return nullptr;
+    }
+
+    const auto insert_result = m_peers.insert(peer_id);
+    auto tracked_peer = insert_result.first;
+    const bool is_new_peer = insert_result.second;
+    if (is_new_peer) {
+        tracked_peer->peer = new UdpPeer(*m_loop,
+                                         *m_parent,
+                                         m_udp_handle.get(),
+                                         {addr},
+                                         peer_id); // Ref count is == 1 here
+        IO_LOG(m_loop, TRACE, m_parent, "New tracked peer:", tracked_peer->peer->endpoint());
+
+        tracked_peer->peer->set_last_packet_time(::uv_hrtime());
+        m_peers_backlog->add_item(tracked_peer->peer, &tracked_peer->backlog_handle);
+    }
+
+    // Peer may be closed and removed from the table in callbacks, so additional reference is held.
+    // Table entry is not used after this point, because callbacks may modify the table.
+    auto peer = tracked_peer->peer;
+    peer->ref();
+
+    if (is_new_peer && m_new_peer_callback) {
+        m_new_peer_callback(*peer, Error(0));
+    }
+
+    peer->set_last_packet_time(::uv_hrtime());
+    return peer;
+}
+
+void UdpServer::Impl::on_datagrams_received(detail::UdpBatchReceiver::Datagram* datagrams, std::size_t count) {
+    if (m_data_batch_receive_callback) {
+        m_received_batch.clear();
+
+        for (std::size_t i = 0; i < count && is_open(); ++i) {
+            auto peer = acquire_peer(datagrams[i].address);
+            if (peer) {
+                m_received_batch.push_back({peer, DataChunk(std::move(datagrams[i].buf), datagrams[i].size)});
+            }
+        }
+
+        if (!m_received_batch.empty() && is_open()) {
+            m_data_batch_receive_callback(*m_parent, m_received_batch.data(), m_received_batch.size(), Error(0));
+        }
+
+        for (auto& datagram : m_received_batch) {
+            datagram.peer->unref();
+        }
+
+        m_received_batch.clear();
+    } else if (m_data_receive_callback) {
+        // Server could be closed from the callback while there are still datagrams in the batch
+        for (std::size_t i = 0; i < count && is_open(); ++i) {
+            auto peer = acquire_peer(datagrams[i].address);
+            if (!peer) {
+                continue;
+            }
+
+            DataChunk data_chunk(std::move(datagrams[i].buf), datagrams[i].size);
+            m_data_receive_callback(*peer, data_chunk, Error(0));
+            peer->unref();
+        }
+    }
+}
+
+void UdpServer::Impl::on_receive_error(const Error& error) {
+    IO_LOG(m_loop, ERROR, m_parent, "failed to receive UDP packet", error.string());
+
+    if (m_data_receive_callback) {
+        DataChunk data(nullptr, 0);
+        // TODO: could address be available here???
+        UdpPeer peer(*m_loop, *m_parent, m_udp_handle.get(), Endpoint{0u, 0u}, 0);
+        m_data_receive_callback(peer, data, error);
+    } else if (m_data_batch_receive_callback) {
+        m_data_batch_receive_callback(*m_parent, nullptr, 0, error);
+    }
 }
 
 ///////////////////////////////////////////  static  ////////////////////////////////////////////
 
+void UdpServer::Impl::on_alloc_buffer(uv_handle_t* handle, std::size_t /*suggested_size*/, uv_buf_t* buf) {
+    assert(handle);
+    auto& this_ = *reinterpret_cast<UdpServer::Impl*>(handle->data);
+
+    if (!this_.m_receive_buffer) {
+        this_.m_receive_buffer = this_.m_receive_buffer_pool.acquire();
+    }
+
+    // Null buffer means that user's allocator has no memory, libuv reports ENOBUFS in this case
+    buf->base = this_.m_receive_buffer.get();
+    buf->len = this_.m_receive_buffer ? static_cast<decltype(uv_buf_t::len)>(this_.m_receive_buffer_pool.buffer_size()) : 0;
+}
+
 void UdpServer::Impl::on_data_received(uv_udp_t* handle,
                                        ssize_t nread,
                                        const uv_buf_t* uv_buf,
@@ -189,70 +661,26 @@ void UdpServer::Impl::on_data_received(uv_udp_t* handle,
                                        unsigned flags) {
     assert(handle);
     auto& this_ = *reinterpret_cast<UdpServer::Impl*>(handle->data);
-    auto& parent = *this_.m_parent;
 
-    // TODO: need some mechanism to reuse memory
-    std::shared_ptr<const char> buf(uv_buf->base, std::default_delete<char[]>());
-
-    if (this_.m_data_receive_callback) {
-        Error error(nread);
-
-        if (!error) {
-            if (addr && nread) {
-                detail::PeerId peer_id{addr};
-
-                DataChunk data_chunk(buf, std::size_t(nread));
-                if (this_.peer_bookkeeping_enabled()) {
-                    auto inative_peer_it = this_.m_inactive_peers.find(peer_id);
-                    if (inative_peer_it != this_.m_inactive_peers.end()) {
-                        const Endpoint e{addr};
-                        IO_LOG(this_.m_loop, TRACE, &parent, "Peer", e, "is inactive, ignoring packet");
-                        return;
-                    }
-
-                    auto& peer_ptr = this_.m_peers[peer_id];
-                    if (!peer_ptr.get()) {
-                        peer_ptr.reset(new UdpPeer(*this_.m_loop,
-                                                   *this_.m_parent,
-                                                   this_.m_udp_handle.get(),
-                                                   {addr},
-                                                   peer_id),
-                                       free_udp_peer); // Ref count is == 1 here
-                        IO_LOG(this_.m_loop, TRACE, &parent, "New tracked peer:", peer_ptr->endpoint());
-
-                        peer_ptr->set_last_packet_time(::uv_hrtime());
-                        this_.m_peers_backlog->add_item(peer_ptr);
-
-                        if (this_.m_new_peer_callback) {
-                            this_.m_new_peer_callback(*peer_ptr.get(), Error(0));
-                        }
-                    }
-
-                    peer_ptr->set_last_packet_time(::uv_hrtime());
-
-                    // This should be the last because peer may be reseted in callback
-                    this_.m_data_receive_callback(*peer_ptr, data_chunk, error);
-                } else {
-                    // Ref/Unref semantics here was added to prolong lifetime of oneshot UdpPeer objects
-                    // and to allow call send data in receive callback for UdpServer without peers tracking.
-                    auto peer = new UdpPeer(*this_.m_loop,
-                                 *this_.m_parent,
-                                 this_.m_udp_handle.get(),
-                                 {addr},
-                                 peer_id); // Ref count is == 1 here
-                    IO_LOG(this_.m_loop, TRACE, &parent, "New untracked peer:", peer->endpoint());
-                    this_.m_data_receive_callback(*peer, data_chunk, error);
-                    peer->unref();
-                }
-            }
-        } else {
-            DataChunk data(nullptr, 0);
-            // TODO: could address be available here???
-            UdpPeer peer(*this_.m_loop, *this_.m_parent, this_.m_udp_handle.get(), Endpoint{0u, 0u}, 0);
+    // Buffer returns to the pool when all DataChunk copies are released. If nothing was received,
+    // buffer is kept for the next allocation.
+    std::shared_ptr<const char> buf;
+    if (nread != 0 || addr) {
+        buf = std::move(this_.m_receive_buffer);
+    }
 
-            IO_LOG(this_.m_loop, ERROR, &parent, "failed to receive UDP packet", error.string());
-            this_.m_data_receive_callback(peer, data, error);
-        }
+    Error error(nread);
+    if (error) {
+        this_.on_receive_error(error);
+        return;
+    }
+
+    if (addr && nread) {
+        detail::UdpBatchReceiver::Datagram datagram;
+        datagram.address = addr;
+        datagram.buf = std::move(buf);
+        datagram.size = std::size_t(nread);
+        this_.on_datagrams_received(&datagram, 1);
     }
 }
 
@@ -266,13 +694,8 @@ void UdpServer::Impl::on_close(uv_handle_t* handle) {
         this_.m_server_close_callback(parent, Error(0));
     }
 
-    this_.m_peers.clear();
-    this_.m_inactive_peers.clear();
-    this_.m_peers_backlog.reset();
-}
-
-void UdpServer::Impl::free_udp_peer(UdpPeer* peer) {
-    peer->unref();
+    this_.clear_peers();
+    this_.free_untracked_peers();
 }
 
 /////////////////////////////////////////// interface ///////////////////////////////////////////
@@ -297,6 +720,18 @@ Error UdpServer::start_receive(const Endpoint& endpoint, DataReceivedCallback re
     return m_impl->start_receive(endpoint, nullptr, receive_callback, timeout_ms, timeout_callback);
 }
 
+Error UdpServer::start_receive_batch(const Endpoint& endpoint, DataBatchReceivedCallback receive_callback) {
+    return m_impl->start_receive_batch(endpoint, receive_callback);
+}
+
+Error UdpServer::start_receive_batch(const Endpoint& endpoint, NewPeerCallback new_peer_callback, DataBatchReceivedCallback receive_callback, std::size_t timeout_ms, PeerTimeoutCallback timeout_callback) {
+    return m_impl->start_receive_batch(endpoint, new_peer_callback, receive_callback, timeout_ms, timeout_callback);
+}
+
+void UdpServer::send_batch(std::vector<OutgoingDatagram> datagrams, EndSendBatchCallback callback) {
+    return m_impl->send_batch(std::move(datagrams), callback);
+}
+
 void UdpServer::close(CloseServerCallback close_callback) {
     return m_impl->close(close_callback);
 }
@@ -328,4 +763,44 @@ Error UdpServer::set_send_buffer_size(std::size_t size) {
     return m_impl->set_send_buffer_size(size);
 }
 
+Error UdpServer::set_max_datagram_size(std::size_t size) {
+    return m_impl->set_max_datagram_size(size);
+}
+
+std::size_t UdpServer::max_datagram_size() const {
+    return m_impl->max_datagram_size();
+}
+
+std::size_t UdpServer::receive_buffer_pool_hits() const {
+    return m_impl->receive_buffer_pool_hits();
+}
+
+std::size_t UdpServer::receive_buffer_pool_misses() const {
+    return m_impl->receive_buffer_pool_misses();
+}
+
+void UdpServer::recycle_peer(UdpPeer& peer) {
+    return m_impl->recycle_peer(peer);
+}
+
+std::size_t UdpServer::allocated_untracked_peers_count() const {
+    return m_impl->allocated_untracked_peers_count();
+}
+
+std::size_t UdpServer::reused_untracked_peers_count() const {
+    return m_impl->reused_untracked_peers_count();
+}
+
+Error UdpServer::set_receive_batch_size(std::size_t size) {
+    return m_impl->set_receive_batch_size(size);
+}
+
+std::size_t UdpServer::receive_batch_size() const {
+    return m_impl->receive_batch_size();
+}
+
+Error UdpServer::set_read_buffer_allocator(const ReadBufferAllocator& allocator) {
+    return m_impl->set_read_buffer_allocator(allocator);
+}
+
 } // namespace io
@@ -9,10 +9,13 @@
 #include "DataChunk.h"
 #include "Removable.h"
 #include "Error.h"
+#include "ReadBufferAllocator.h"
 #include "UserDataHolder.h"
 #include "UdpPeer.h"
 
+#include <cstdint>
 #include <memory>
+#include <vector>
 
 namespace io {
 
@@ -23,6 +26,26 @@ public:
     using DataReceivedCallback = std::function<void(UdpPeer&, const DataChunk&, const Error&)>;
     using PeerTimeoutCallback = std::function<void(UdpPeer&, const Error&)>;
 
+    // Datagram of the batch. Peer and data are valid until batch callback returns,
+    // both could be retained (see DataChunk and UdpPeer ref semantics).
+    struct ReceivedDatagram {
+        UdpPeer* peer;
+        DataChunk data;
+    };
+
+    using DataBatchReceivedCallback = std::function<void(UdpServer&, const ReceivedDatagram* datagrams, std::size_t count, const Error&)>;
+
+    using EndSendDatagramCallback = std::function<void(UdpServer&, const Endpoint&, const Error&)>;
+    using EndSendBatchCallback = std::function<void(UdpServer&, const Error&)>;
+
+    // Datagram of outgoing batch, callback is optional
+    struct OutgoingDatagram {
+        Endpoint endpoint;
+        std::shared_ptr<const char> buf;
+        std::uint32_t size;
+        EndSendDatagramCallback end_send_callback;
+    };
+
     using CloseServerCallback = std::function<void(UdpServer&, const Error&)>;
 
     IO_FORBID_COPY(UdpServer);
@@ -46,6 +69,21 @@ public:
                                       std::size_t timeout_ms,
                                       PeerTimeoutCallback timeout_callback);
 
+    // Same as start_receive, but datagrams received by one system call are delivered by a single callback
+    IO_DLL_PUBLIC Error start_receive_batch(const Endpoint& endpoint,
+                                            DataBatchReceivedCallback receive_callback);
+
+    IO_DLL_PUBLIC Error start_receive_batch(const Endpoint& endpoint,
+                                            NewPeerCallback new_peer_callback,
+                                            DataBatchReceivedCallback receive_callback,
+                                            std::size_t timeout_ms,
+                                            PeerTimeoutCallback timeout_callback);
+
+    // Datagrams are queued and sent together with all other queued ones right before the loop waits for I/O.
+    // On Linux this is done by sendmmsg, many datagrams per system call. Batch callback is called when all
+    // datagrams are processed and receives the first error if any.
+    IO_DLL_PUBLIC void send_batch(std::vector<OutgoingDatagram> datagrams, EndSendBatchCallback callback = nullptr);
+
     IO_DLL_PUBLIC void close(CloseServerCallback close_callback = nullptr);
 
     IO_DLL_PUBLIC BufferSizeResult receive_buffer_size() const;
@@ -53,6 +91,32 @@ public:
     IO_DLL_PUBLIC Error set_receive_buffer_size(std::size_t size);
     IO_DLL_PUBLIC Error set_send_buffer_size(std::size_t size);
 
+    // Size of buffers for incoming datagrams, larger datagrams are truncated. Default value is 64 KB.
+    // Setting it to the expected MTU saves memory.
+    IO_DLL_PUBLIC Error set_max_datagram_size(std::size_t size);
+    IO_DLL_PUBLIC std::size_t max_datagram_size() const;
+
+    // Receive buffers are taken from the pool and returned there when the last DataChunk
+    // referencing them is released. Miss means that new buffer was allocated.
+    IO_DLL_PUBLIC std::size_t receive_buffer_pool_hits() const;
+    IO_DLL_PUBLIC std::size_t receive_buffer_pool_misses() const;
+
+    // Max number of datagrams received by a single system call, default is 1. Values greater than 1
+    // enable batch receive via recvmmsg on Linux, on other platforms datagrams are still received one by one.
+    // Each datagram of the batch takes buffer of max_datagram_size(). Should be set before start_receive.
+    IO_DLL_PUBLIC Error set_receive_batch_size(std::size_t size);
+    IO_DLL_PUBLIC std::size_t receive_batch_size() const;
+
+    // Datagrams are received into buffers of max_datagram_size() allocated by user's allocator,
+    // instead of pooled ones. Should be set before start_receive. Default constructed allocator
+    // restores library's buffers.
+    IO_DLL_PUBLIC Error set_read_buffer_allocator(const ReadBufferAllocator& allocator);
+
+    // Peers of servers without peers tracking live for the time of receive callback (or while sending
+    // data to them). Released ones are reused for the next datagrams instead of allocating new objects.
+    IO_DLL_PUBLIC std::size_t allocated_untracked_peers_count() const;
+    IO_DLL_PUBLIC std::size_t reused_untracked_peers_count() const;
+
     // TODO: peers count???
     // TODO: method to iterate on peers???
 
@@ -63,6 +127,7 @@ private:
     friend class UdpPeer;
 
     void close_peer(UdpPeer& peer, std::size_t inactivity_timeout_ms);
+    void recycle_peer(UdpPeer& peer);
 
     class Impl;
     std::unique_ptr<Impl> m_impl;
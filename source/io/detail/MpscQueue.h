@@ -0,0 +1,211 @@
+#pragma once
+
+#include "io/CommonMacros.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace io {
+namespace detail {
+
+// Lock-free unbounded multi-producer single-consumer queue.
+// Based on the algorithm by Dmitry Vyukov: producers are serialized by a single atomic exchange
+// and consumer never contends with them.
+// push methods are thread safe, all other methods should be called only from the consumer thread.
+// Nodes are taken from the fixed pool of the queue while it has free ones, so steady state
+// push does not allocate. Nodes are allocated on heap only when the pool is exhausted.
+template<typename T>
+class MpscQueue {
+public:
+    IO_FORBID_COPY(MpscQueue);
+    IO_FORBID_MOVE(MpscQueue);
+
+    MpscQueue();
+    ~MpscQueue();
+
+    void push(T value);
+    // All values are published with a single atomic operation and will be consumed in the same order.
+    void push(std::vector<T>&& values);
+
+    bool pop(T& value);
+
+    // Invokes consumer for every element which was in the queue at the moment of the call.
+    // Elements pushed by consumer itself are left for the next invocation.
+    template<typename ConsumerType>
+    std::size_t consume_all(ConsumerType consumer);
+
+    // May return true if some producer is in the middle of the push
+    bool empty() const;
+
+    void clear();
+
+private:
+    struct Node {
+        Node() : next(nullptr) {
+        }
+
+        explicit Node(T&& v) : next(nullptr), value(std::move(v)) {
+        }
+
+        std::atomic<Node*> next;
+        T value;
+        bool pooled = false;
+    };
+
+    // One bit per node in the free nodes mask
+    static const std::size_t POOL_SIZE = 64;
+
+    // Producers take free node by clearing its bit, consumer returns it by setting the bit.
+    // Bit operations are not affected by ABA problem of lock-free free lists.
+    Node* allocate_node(T&& value);
+    void release_node(Node* node);
+
+    void push_chain(Node* first, Node* last);
+
+    std::unique_ptr<Node[]> m_pool;
+    std::atomic<std::uint64_t> m_free_pool_nodes;
+
+    std::atomic<Node*> m_head; // last pushed element, accessed by producers
+    Node* m_tail = nullptr;    // stub node, accessed by consumer
+};
+
+///////////////////////////////////////// implementation ///////////////////////////////////////////
+
+template<typename T>
+const std::size_t MpscQueue<T>::POOL_SIZE;
+
+template<typename T>
+MpscQueue<T>::MpscQueue() :
+    m_pool(new Node[POOL_SIZE]),
+    m_free_pool_nodes(~std::uint64_t(0)),
+    m_head(nullptr) {
+    for (std::size_t i = 0; i < POOL_SIZE; ++i) {
+        m_pool[i].pooled = true;
+    }
+
+    m_tail = allocate_node(T());
+    m_head.store(m_tail, std::memory_order_relaxed);
+}
+
+template<typename T>
+MpscQueue<T>::~MpscQueue() {
+    clear();
+    release_node(m_tail);
+}
+
+template<typename T>
+typename MpscQueue<T>::Node* MpscQueue<T>::allocate_node(T&& value) {
+    std::uint64_t free_nodes = m_free_pool_nodes.load(std::memory_order_relaxed);
+    while (free_nodes) {
+        std::size_t index = 0;
+        while ((free_nodes & (std::uint64_t(1) << index)) == 0) {
+            ++index;
+        }
+
+        // On failure free_nodes is reloaded and other node is tried
+        if (m_free_pool_nodes.compare_exchange_weak(free_nodes,
+                                                    free_nodes & ~(std::uint64_t(1) << index),
+                                                    std::memory_order_acquire,
+                                                    std::memory_order_relaxed)) {
+            Node* const node = &m_pool[index];
+            node->value = std::move(value);
+            return node;
+        }
+    }
+
+    return new Node(std::move(value));
+}
+
+template<typename T>
+void MpscQueue<T>::release_node(Node* node) {
+    if (!node->pooled) {
+        delete node;
+        return;
+    }
+
+    node->next.store(nullptr, std::memory_order_relaxed);
+    const auto index = static_cast<std::size_t>(node - m_pool.get());
+    m_free_pool_nodes.fetch_or(std::uint64_t(1) << index, std::memory_order_release);
+}
+
+template<typename T>
+void MpscQueue<T>::push_chain(Node* first, Node* last) {
+    Node* const previous = m_head.exchange(last, std::memory_order_acq_rel);
+    // Between exchange and this store consumer observes queue as empty (it is OK)
+    previous->next.store(first, std::memory_order_release);
+}
+
+template<typename T>
+void MpscQueue<T>::push(T value) {
+    auto node = allocate_node(std::move(value));
+    push_chain(node, node);
+}
+
+template<typename T>
+void MpscQueue<T>::push(std::vector<T>&& values) {
+    if (values.empty()) {
+        return;
+    }
+
+    Node* const first = allocate_node(std::move(values.front()));
+    Node* last = first;
+    for (std::size_t i = 1; i < values.size(); ++i) {
+        auto node = allocate_node(std::move(values[i]));
+        last->next.store(node, std::memory_order_relaxed);
+        last = node;
+    }
+
+    values.clear();
+    push_chain(first, last);
+}
+
+template<typename T>
+bool MpscQueue<T>::pop(T& value) {
+    Node* const tail = m_tail;
+    Node* const next = tail->next.load(std::memory_order_acquire);
+    if (next == nullptr) {
+        return false;
+    }
+
+    value = std::move(next->value);
+    next->value = T();
+    m_tail = next; // next becomes new stub node
+    release_node(tail);
+
+    return true;
+}
+
+template<typename T>
+template<typename ConsumerType>
+std::size_t MpscQueue<T>::consume_all(ConsumerType consumer) {
+    Node* const last = m_head.load(std::memory_order_acquire);
+
+    std::size_t count = 0;
+    T value;
+    while (m_tail != last && pop(value)) {
+        ++count;
+        consumer(value);
+        value = T();
+    }
+
+    return count;
+}
+
+template<typename T>
+bool MpscQueue<T>::empty() const {
+    return m_tail->next.load(std::memory_order_acquire) == nullptr;
+}
+
+template<typename T>
+void MpscQueue<T>::clear() {
+    T value;
+    while (pop(value)) {
+    }
+}
+
+} // namespace detail
+} // namespace io
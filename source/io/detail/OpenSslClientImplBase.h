@@ -10,6 +10,8 @@
 #include <openssl/err.h>
 
 #include <iostream>
+#include <limits>
+#include <vector>
 
 namespace io {
 namespace detail {
@@ -39,6 +41,19 @@ public:
 
     void send_data(std::shared_ptr<const char> buffer, std::uint32_t size, typename ParentType::EndSendCallback callback);
     void send_data(const std::string& message, typename ParentType::EndSendCallback callback);
+    void send_data(const std::vector<DataChunk>& chunks, typename ParentType::EndSendCallback callback);
+
+    // Watermarks are applied to the underlying connection, so encrypted bytes are counted
+    std::size_t pending_write_bytes() const;
+    Error set_write_watermarks(std::size_t low, std::size_t high);
+    bool is_write_buffer_full() const;
+    void set_on_write_buffer_full(std::function<void(ParentType&)> callback);
+    void set_on_write_buffer_drained(std::function<void(ParentType&)> callback);
+
+    // Reading is paused on the underlying connection
+    Error pause_reading();
+    Error resume_reading();
+    bool is_reading_paused() const;
 
     void on_data_receive(const char* buf, std::size_t size);
 
@@ -54,6 +69,12 @@ public:
 protected:
     void internal_read_from_sll_and_send(typename ParentType::UnderlyingClientType::EndSendCallback on_send);
 
+    bool ssl_write(const char* buffer, std::uint32_t size, const typename ParentType::EndSendCallback& callback);
+    void send_encrypted(std::size_t size, typename ParentType::EndSendCallback callback);
+
+    // Should be called when underlying client is created
+    Error apply_write_watermarks();
+
     ParentType* m_parent;
     EventLoop* m_loop;
 
@@ -73,6 +94,11 @@ protected:
 
     bool m_ssl_inited = false;
 
+    std::size_t m_write_low_watermark = 0;
+    std::size_t m_write_high_watermark = 0;
+    std::function<void(ParentType&)> m_write_buffer_full_callback = nullptr;
+    std::function<void(ParentType&)> m_write_buffer_drained_callback = nullptr;
+
 private:
     static void ssl_state_callback(const SSL* ssl, int where, int ret);
 
@@ -333,7 +359,66 @@ void OpenSslClientImplBase<ParentType, ImplType>::send_data(std::shared_ptr<cons
         return;
     }
 
-    const auto write_result = SSL_write(m_ssl.get(), buffer.get(), size);
+    if (!ssl_write(buffer.get(), size, callback)) {
+        return;
+    }
+
+    send_encrypted(size, callback);
+}
+
+template<typename ParentType, typename ImplType>
+void OpenSslClientImplBase<ParentType, ImplType>::send_data(const std::vector<DataChunk>& chunks, typename ParentType::EndSendCallback callback) {
+    if (!is_open()) {
+        if (callback) {
+            callback(*m_parent, Error(StatusCode::NOT_CONNECTED));
+        }
+        return;
+    }
+
+    std::size_t total_size = 0;
+    for (const auto& chunk : chunks) {
+        if (chunk.size && (chunk.buf == nullptr || chunk.size > std::numeric_limits<std::uint32_t>::max())) {
+            total_size = 0;
+            break;
+        }
+
+        total_size += chunk.size;
+    }
+
+    if (total_size == 0) {
+        if (callback) {
+            callback(*m_parent, Error(StatusCode::INVALID_ARGUMENT));
+        }
+        return;
+    }
+
+    // All chunks are encrypted to the write BIO and sent by one write of the underlying client
+    bool has_encrypted_chunks = false;
+    for (const auto& chunk : chunks) {
+        if (chunk.size == 0) {
+            continue;
+        }
+
+        if (!ssl_write(chunk.buf.get(), static_cast<std::uint32_t>(chunk.size), callback)) {
+            if (has_encrypted_chunks) {
+                // Records of previous chunks can not be sent without the rest of data and can not be
+                // dropped without breaking the TLS stream, so connection is failed.
+                IO_LOG(m_loop, ERROR, m_parent, "Closing connection after partially encrypted send");
+                BIO_reset(m_ssl_write_bio);
+                m_client->close();
+            }
+            return;
+        }
+
+        has_encrypted_chunks = true;
+    }
+
+    send_encrypted(total_size, callback);
+}
+
+template<typename ParentType, typename ImplType>
+bool OpenSslClientImplBase<ParentType, ImplType>::ssl_write(const char* buffer, std::uint32_t size, const typename ParentType::EndSendCallback& callback) {
+    const auto write_result = SSL_write(m_ssl.get(), buffer, size);
     if (write_result <= 0) {
         IO_LOG(m_loop, ERROR, m_parent, "Failed to write buf of size", size);
 
@@ -343,9 +428,14 @@ void OpenSslClientImplBase<ParentType, ImplType>::send_data(std::shared_ptr<cons
             callback(*m_parent, Error(StatusCode::OPENSSL_ERROR, str ? str : ""));
         }
 
-        return;
+        return false;
     }
 
+    return true;
+}
+
+template<typename ParentType, typename ImplType>
+void OpenSslClientImplBase<ParentType, ImplType>::send_encrypted(std::size_t size, typename ParentType::EndSendCallback callback) {
     const std::size_t SIZE = BIO_pending(m_ssl_write_bio);
     std::shared_ptr<char> ptr(new char[SIZE], [](const char* p) { delete[] p;});
 
@@ -450,5 +540,80 @@ const Endpoint& OpenSslClientImplBase<ParentType, ImplType>::endpoint() const {
     return m_client->endpoint();
 }
 
+template<typename ParentType, typename ImplType>
+std::size_t OpenSslClientImplBase<ParentType, ImplType>::pending_write_bytes() const {
+    return m_client ? m_client->pending_write_bytes() : 0;
+}
+
+template<typename ParentType, typename ImplType>
+Error OpenSslClientImplBase<ParentType, ImplType>::set_write_watermarks(std::size_t low, std::size_t high) {
+    if (low > high) {
+        return Error(StatusCode::INVALID_ARGUMENT);
+    }
+
+    m_write_low_watermark = low;
+    m_write_high_watermark = high;
+
+    if (m_client) {
+        return apply_write_watermarks();
+    }
+
+    return Error(0);
+}
+
+template<typename ParentType, typename ImplType>
+bool OpenSslClientImplBase<ParentType, ImplType>::is_write_buffer_full() const {
+    return m_client && m_client->is_write_buffer_full();
+}
+
+template<typename ParentType, typename ImplType>
+void OpenSslClientImplBase<ParentType, ImplType>::set_on_write_buffer_full(std::function<void(ParentType&)> callback) {
+    m_write_buffer_full_callback = callback;
+}
+
+template<typename ParentType, typename ImplType>
+void OpenSslClientImplBase<ParentType, ImplType>::set_on_write_buffer_drained(std::function<void(ParentType&)> callback) {
+    m_write_buffer_drained_callback = callback;
+}
+
+template<typename ParentType, typename ImplType>
+Error OpenSslClientImplBase<ParentType, ImplType>::pause_reading() {
+    if (!m_client) {
+        return Error(StatusCode::NOT_CONNECTED);
+    }
+
+    return m_client->pause_reading();
+}
+
+template<typename ParentType, typename ImplType>
+Error OpenSslClientImplBase<ParentType, ImplType>::resume_reading() {
+    if (!m_client) {
+        return Error(StatusCode::NOT_CONNECTED);
+    }
+
+    return m_client->resume_reading();
+}
+
+template<typename ParentType, typename ImplType>
+bool OpenSslClientImplBase<ParentType, ImplType>::is_reading_paused() const {
+    return m_client && m_client->is_reading_paused();
+}
+
+template<typename ParentType, typename ImplType>
+Error OpenSslClientImplBase<ParentType, ImplType>::apply_write_watermarks() {
+    m_client->set_on_write_buffer_full([this](typename ParentType::UnderlyingClientType&) {
+        if (m_write_buffer_full_callback) {
+            m_write_buffer_full_callback(*m_parent);
+        }
+    });
+    m_client->set_on_write_buffer_drained([this](typename ParentType::UnderlyingClientType&) {
+        if (m_write_buffer_drained_callback) {
+            m_write_buffer_drained_callback(*m_parent);
+        }
+    });
+
+    return m_client->set_write_watermarks(m_write_low_watermark, m_write_high_watermark);
+}
+
 } // namespace detail
 } // namespace io
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 
@@ -7,8 +8,15 @@ namespace io {
 namespace detail {
 
 struct PeerId {
+    PeerId() = default;
     PeerId(const void* address);
 
+    PeerId(std::uint64_t high, std::uint64_t low, std::uint16_t port) :
+        address_high(high),
+        address_low(low),
+        port(port) {
+    }
+
     std::uint64_t address_high = 0;
     std::uint64_t address_low = 0;
     std::uint16_t port = 0;
@@ -20,6 +28,26 @@ inline bool operator==(const PeerId& lhs, const PeerId& rhs) {
            lhs.port == rhs.port;
 }
 
+inline bool operator!=(const PeerId& lhs, const PeerId& rhs) {
+    return !(lhs == rhs);
+}
+
+// Finalizer of MurmurHash3, every input bit affects every output bit
+inline std::uint64_t mix_bits(std::uint64_t value) {
+    value ^= value >> 33;
+    value *= 0xFF51AFD7ED558CCDull;
+    value ^= value >> 33;
+    value *= 0xC4CEB9FE1A85EC53ull;
+    value ^= value >> 33;
+    return value;
+}
+
+// Port is mixed in before the address, so peers which differ only by swapped
+// values of address parts and port do not collide (XOR of fields hashes did this).
+inline std::uint64_t hash_value(const PeerId& id) {
+    return mix_bits(id.address_low ^ mix_bits(id.address_high ^ (std::uint64_t(id.port) << 48)));
+}
+
 } // namespace detail
 } // namespace io
 
@@ -27,9 +55,7 @@ namespace std {
 template <>
 struct hash<io::detail::PeerId> {
     std::size_t operator()(const io::detail::PeerId& id) const {
-        return hash<std::uint64_t>()(id.address_high) ^
-               hash<std::uint64_t>()(id.address_low) ^
-               hash<std::uint16_t>()(id.port);
+        return static_cast<std::size_t>(io::detail::hash_value(id));
     }
 };
 
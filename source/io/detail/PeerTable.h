@@ -0,0 +1,269 @@
+#pragma once
+
+#include "io/CommonMacros.h"
+
+#include "PeerId.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <assert.h>
+
+namespace io {
+namespace detail {
+
+// Hash table of values keyed by PeerId with open addressing and linear probing. Keys and values are
+// stored inline in a single array, so lookup usually touches one or two cache lines and insertion
+// does not allocate until table grows. Removal is done by shifting subsequent entries backward
+// instead of leaving tombstones, so lookups do not degrade after many insertions and removals.
+// Pointers to values are invalidated by insertion and removal.
+template<typename ValueType>
+class PeerTable {
+public:
+    IO_FORBID_COPY(PeerTable);
+
+    PeerTable(std::size_t capacity = 0);
+
+    PeerTable(PeerTable&& other);
+    PeerTable& operator=(PeerTable&& other);
+
+    // Returns nullptr if there is no such key
+    ValueType* find(const PeerId& id);
+    const ValueType* find(const PeerId& id) const;
+
+    // Value is default constructed if key is new, second member is true in this case
+    std::pair<ValueType*, bool> insert(const PeerId& id);
+
+    bool erase(const PeerId& id);
+
+    template<typename FunctionType>
+    void for_each(FunctionType function);
+
+    void clear();
+
+    // Grows table, so it could hold 'count' entries without rehashing
+    void reserve(std::size_t count);
+
+    std::size_t size() const;
+    bool empty() const;
+    std::size_t capacity() const;
+
+private:
+    static const std::size_t MIN_SLOTS_COUNT = 16;
+
+    struct Slot {
+        PeerId id;
+        bool occupied = false;
+        ValueType value = ValueType();
+    };
+
+    std::size_t ideal_index(const PeerId& id) const;
+    std::size_t find_index(const PeerId& id) const;
+    void rehash(std::size_t slots_count);
+
+    static std::size_t slots_count_for(std::size_t count);
+
+    std::vector<Slot> m_slots;
+    std::size_t m_size = 0;
+};
+
+///////////////////////////////////////// implementation ///////////////////////////////////////////
+
+template<typename ValueType>
+PeerTable<ValueType>::PeerTable(std::size_t capacity) {
+    if (capacity) {
+        reserve(capacity);
+    }
+}
+
+template<typename ValueType>
+PeerTable<ValueType>::PeerTable(PeerTable&& other) :
+    m_slots(std::move(other.m_slots)),
+    m_size(other.m_size) {
+    other.m_slots.clear();
+    other.m_size = 0;
+}
+
+template<typename ValueType>
+PeerTable<ValueType>& PeerTable<ValueType>::operator=(PeerTable&& other) {
+    m_slots = std::move(other.m_slots);
+    m_size = other.m_size;
+    other.m_slots.clear();
+    other.m_size = 0;
+    return *this;
+}
+
+template<typename ValueType>
+std::size_t PeerTable<ValueType>::ideal_index(const PeerId& id) const {
+    // Slots count is power of 2
+    return static_cast<std::size_t>(hash_value(id)) & (m_slots.size() - 1);
+}
+
+template<typename ValueType>
+std::size_t PeerTable<ValueType>::find_index(const PeerId& id) const {
+    if (m_size == 0) {
+        return m_slots.size();
+    }
+
+    const std::size_t mask = m_slots.size() - 1;
+    // There is always at least one free slot, so the loop terminates
+    for (std::size_t i = ideal_index(id); ; i = (i + 1) & mask) {
+        const auto& slot = m_slots[i];
+        if (!slot.occupied) {
+            return m_slots.size();
+        }
+
+        if (slot.id == id) {
+            return i;
+        }
+    }
+}
+
+template<typename ValueType>
+ValueType* PeerTable<ValueType>::find(const PeerId& id) {
+    const std::size_t index = find_index(id);
+    return index < m_slots.size() ? &m_slots[index].value : nullptr;
+}
+
+template<typename ValueType>
+const ValueType* PeerTable<ValueType>::find(const PeerId& id) const {
+    const std::size_t index = find_index(id);
+    return index < m_slots.size() ? &m_slots[index].value : nullptr;
+}
+
+template<typename ValueType>
+std::pair<ValueType*, bool> PeerTable<ValueType>::insert(const PeerId& id) {
+    // Max load factor is 3/4
+    if ((m_size + 1) * 4 > m_slots.size() * 3) {
+        rehash(slots_count_for(m_size + 1));
+    }
+
+    const std::size_t mask = m_slots.size() - 1;
+    for (std::size_t i = ideal_index(id); ; i = (i + 1) & mask) {
+        auto& slot = m_slots[i];
+        if (!slot.occupied) {
+            slot.id = id;
+            slot.occupied = true;
+            ++m_size;
+            return {&slot.value, true};
+        }
+
+        if (slot.id == id) {
+            return {&slot.value, false};
+        }
+    }
+}
+
+template<typename ValueType>
+bool PeerTable<ValueType>::erase(const PeerId& id) {
+    std::size_t hole = find_index(id);
+    if (hole == m_slots.size()) {
+        return false;
+    }
+
+    const std::size_t mask = m_slots.size() - 1;
+    for (std::size_t i = (hole + 1) & mask; m_slots[i].occupied; i = (i + 1) & mask) {
+        // Entry could be moved to the hole only if its probe sequence passes through the hole,
+        // i.e. ideal position is not within (hole, i] cyclically.
+        const std::size_t ideal = ideal_index(m_slots[i].id);
+        const bool stays = hole <= i ? (hole < ideal && ideal <= i) : (hole < ideal || ideal <= i);
+        if (stays) {
+            continue;
+        }
+
+        m_slots[hole].id = m_slots[i].id;
+        m_slots[hole].value = std::move(m_slots[i].value);
+        hole = i;
+    }
+
+    m_slots[hole].id = PeerId();
+    m_slots[hole].occupied = false;
+    m_slots[hole].value = ValueType();
+    --m_size;
+
+    return true;
+}
+
+template<typename ValueType>
+template<typename FunctionType>
+void PeerTable<ValueType>::for_each(FunctionType function) {
+    for (auto& slot : m_slots) {
+        if (slot.occupied) {
+            function(static_cast<const PeerId&>(slot.id), slot.value);
+        }
+    }
+}
+
+template<typename ValueType>
+void PeerTable<ValueType>::clear() {
+    // Keeping memory, table is likely to be filled again
+    for (auto& slot : m_slots) {
+        if (slot.occupied) {
+            slot = Slot();
+        }
+    }
+
+    m_size = 0;
+}
+
+template<typename ValueType>
+void PeerTable<ValueType>::reserve(std::size_t count) {
+    const std::size_t slots_count = slots_count_for(count);
+    if (slots_count > m_slots.size()) {
+        rehash(slots_count);
+    }
+}
+
+template<typename ValueType>
+std::size_t PeerTable<ValueType>::size() const {
+    return m_size;
+}
+
+template<typename ValueType>
+bool PeerTable<ValueType>::empty() const {
+    return m_size == 0;
+}
+
+template<typename ValueType>
+std::size_t PeerTable<ValueType>::capacity() const {
+    return m_slots.size() / 4 * 3;
+}
+
+template<typename ValueType>
+void PeerTable<ValueType>::rehash(std::size_t slots_count) {
+    assert(slots_count && (slots_count & (slots_count - 1)) == 0);
+
+    std::vector<Slot> old_slots(slots_count);
+    old_slots.swap(m_slots);
+
+    const std::size_t mask = m_slots.size() - 1;
+    for (auto& old_slot : old_slots) {
+        if (!old_slot.occupied) {
+            continue;
+        }
+
+        std::size_t i = ideal_index(old_slot.id);
+        while (m_slots[i].occupied) {
+            i = (i + 1) & mask;
+        }
+
+        m_slots[i].id = old_slot.id;
+        m_slots[i].occupied = true;
+        m_slots[i].value = std::move(old_slot.value);
+    }
+}
+
+template<typename ValueType>
+std::size_t PeerTable<ValueType>::slots_count_for(std::size_t count) {
+    std::size_t slots_count = MIN_SLOTS_COUNT;
+    while (slots_count / 4 * 3 < count) {
+        slots_count *= 2;
+    }
+
+    return slots_count;
+}
+
+} // namespace detail
+} // namespace io
@@ -0,0 +1,62 @@
+#include "ReadBufferPool.h"
+
+#include <assert.h>
+
+namespace io {
+namespace detail {
+
+ReadBufferPool::ReadBufferPool() {
+    for (std::size_t i = 0; i < SIZE_CLASSES_COUNT; ++i) {
+        m_pools[i].reset(new ReceiveBufferPool(buffer_size(i)));
+    }
+}
+
+std::shared_ptr<char> ReadBufferPool::acquire(std::size_t size_class) {
+    assert(size_class < SIZE_CLASSES_COUNT);
+    return m_pools[size_class]->acquire();
+}
+
+std::size_t ReadBufferPool::buffer_size(std::size_t size_class) {
+    // Each class is 4 times larger than previous one
+    return MIN_BUFFER_SIZE << (2 * size_class);
+}
+
+std::size_t ReadBufferPool::next_size_class(std::size_t size_class, std::size_t read_size, std::size_t& small_reads_count) {
+    if (read_size >= buffer_size(size_class)) {
+        small_reads_count = 0;
+        return size_class + 1 < SIZE_CLASSES_COUNT ? size_class + 1 : size_class;
+    }
+
+    if (size_class == 0 || read_size > buffer_size(size_class - 1) / 2) {
+        small_reads_count = 0;
+        return size_class;
+    }
+
+    if (++small_reads_count < SHRINK_READS_COUNT) {
+        return size_class;
+    }
+
+    small_reads_count = 0;
+    return size_class - 1;
+}
+
+std::size_t ReadBufferPool::hits() const {
+    std::size_t result = 0;
+    for (std::size_t i = 0; i < SIZE_CLASSES_COUNT; ++i) {
+        result += m_pools[i]->hits();
+    }
+
+    return result;
+}
+
+std::size_t ReadBufferPool::misses() const {
+    std::size_t result = 0;
+    for (std::size_t i = 0; i < SIZE_CLASSES_COUNT; ++i) {
+        result += m_pools[i]->misses();
+    }
+
+    return result;
+}
+
+} // namespace detail
+} // namespace io
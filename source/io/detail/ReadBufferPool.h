@@ -0,0 +1,48 @@
+#pragma once
+
+#include "io/CommonMacros.h"
+
+#include "ReceiveBufferPool.h"
+
+#include <cstddef>
+#include <memory>
+
+namespace io {
+namespace detail {
+
+// Read buffers of stream connections shared by all connections of the loop. Connection takes
+// a buffer only for the time of a single read and releases it after data receive callback,
+// so idle connections do not hold memory. Buffers of each size class are kept in own
+// ReceiveBufferPool, buffers retained by users return to the pool when released.
+class ReadBufferPool {
+public:
+    // Classes are 4 KB, 16 KB and 64 KB
+    static const std::size_t SIZE_CLASSES_COUNT = 3;
+    static const std::size_t MIN_BUFFER_SIZE = 4 * 1024;
+
+    // Number of successive reads which would fit into smaller buffer before buffer is shrunk
+    static const std::size_t SHRINK_READS_COUNT = 8;
+
+    IO_FORBID_COPY(ReadBufferPool);
+    IO_FORBID_MOVE(ReadBufferPool);
+
+    ReadBufferPool();
+
+    std::shared_ptr<char> acquire(std::size_t size_class);
+
+    static std::size_t buffer_size(std::size_t size_class);
+
+    // Adaptive size of connection's buffer. Buffer grows when read fills it completely and shrinks
+    // after SHRINK_READS_COUNT successive reads which fit into half of the smaller class.
+    // 'small_reads_count' is per connection state.
+    static std::size_t next_size_class(std::size_t size_class, std::size_t read_size, std::size_t& small_reads_count);
+
+    std::size_t hits() const;
+    std::size_t misses() const;
+
+private:
+    std::unique_ptr<ReceiveBufferPool> m_pools[SIZE_CLASSES_COUNT];
+};
+
+} // namespace detail
+} // namespace io
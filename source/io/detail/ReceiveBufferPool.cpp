@@ -0,0 +1,101 @@
+#include "ReceiveBufferPool.h"
+
+#include <atomic>
+
+namespace io {
+namespace detail {
+
+ReceiveBufferPool::ReceiveBufferPool(std::size_t buffer_size, std::size_t max_buffers_count) :
+    m_buffer_size(buffer_size),
+    m_max_buffers_count(max_buffers_count) {
+    m_buffers.reserve(max_buffers_count);
+}
+
+std::shared_ptr<char> ReceiveBufferPool::acquire() {
+    if (m_allocator.is_set()) {
+        return allocate(m_allocator, m_buffer_size);
+    }
+
+    // Starting from the next to the last acquired buffer, the oldest ones are the most likely released
+    for (std::size_t i = 0; i < m_buffers.size(); ++i) {
+        const std::size_t index = (m_next_index + i) % m_buffers.size();
+        auto& buffer = m_buffers[index];
+        if (buffer.use_count() == 1) {
+            // Synchronizing with the thread which released the last external reference
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            m_next_index = index + 1;
+            ++m_hits;
+            return buffer;
+        }
+    }
+
+    ++m_misses;
+
+    std::shared_ptr<char> buffer(new char[m_buffer_size], std::default_delete<char[]>());
+    if (m_buffers.size() < m_max_buffers_count) {
+        m_buffers.push_back(buffer);
+        m_next_index = m_buffers.size();
+    }
+
+    return buffer;
+}
+
+void ReceiveBufferPool::set_buffer_size(std::size_t size) {
+    if (size == m_buffer_size) {
+        return;
+    }
+
+    m_buffer_size = size;
+    m_buffers.clear();
+    m_next_index = 0;
+}
+
+std::size_t ReceiveBufferPool::buffer_size() const {
+    return m_buffer_size;
+}
+
+void ReceiveBufferPool::set_max_buffers_count(std::size_t count) {
+    m_max_buffers_count = count;
+    m_buffers.reserve(count);
+}
+
+std::size_t ReceiveBufferPool::max_buffers_count() const {
+    return m_max_buffers_count;
+}
+
+std::size_t ReceiveBufferPool::buffers_count() const {
+    return m_buffers.size();
+}
+
+std::size_t ReceiveBufferPool::hits() const {
+    return m_hits;
+}
+
+std::size_t ReceiveBufferPool::misses() const {
+    return m_misses;
+}
+
+void ReceiveBufferPool::set_allocator(const ReadBufferAllocator& allocator) {
+    m_allocator = allocator;
+    m_buffers.clear();
+    m_next_index = 0;
+}
+
+const ReadBufferAllocator& ReceiveBufferPool::allocator() const {
+    return m_allocator;
+}
+
+std::shared_ptr<char> ReceiveBufferPool::allocate(const ReadBufferAllocator& allocator, std::size_t size) {
+    char* buffer = allocator.allocate(size);
+    if (buffer == nullptr) {
+        return nullptr;
+    }
+
+    // Copy of function is captured, so buffer could outlive the allocator's owner
+    const auto release = allocator.release;
+    return std::shared_ptr<char>(buffer, [release](char* p) { release(p); });
+}
+
+} // namespace detail
+} // namespace io
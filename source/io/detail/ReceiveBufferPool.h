@@ -0,0 +1,65 @@
+#pragma once
+
+#include "io/CommonMacros.h"
+#include "io/ReadBufferAllocator.h"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace io {
+namespace detail {
+
+// Ring of receive buffers of the same size. Buffer is handed out again when the pool holds
+// the only reference to it, so buffers retained by users (via DataChunk) are skipped.
+// Buffers are shared pointers with preallocated control blocks, so acquiring a buffer from the pool
+// does not allocate memory. Should be accessed from a single thread, buffers themselves
+// could be released from any thread.
+class ReceiveBufferPool {
+public:
+    static const std::size_t DEFAULT_BUFFER_SIZE = 65536;
+    static const std::size_t DEFAULT_MAX_BUFFERS_COUNT = 64;
+
+    IO_FORBID_COPY(ReceiveBufferPool);
+    IO_FORBID_MOVE(ReceiveBufferPool);
+
+    explicit ReceiveBufferPool(std::size_t buffer_size = DEFAULT_BUFFER_SIZE,
+                               std::size_t max_buffers_count = DEFAULT_MAX_BUFFERS_COUNT);
+
+    std::shared_ptr<char> acquire();
+
+    // Drops buffers owned by the pool, those which are used outside remain valid
+    void set_buffer_size(std::size_t size);
+    std::size_t buffer_size() const;
+
+    // Does not release buffers which are above the new limit, they are dropped on next set_buffer_size()
+    void set_max_buffers_count(std::size_t count);
+    std::size_t max_buffers_count() const;
+
+    std::size_t buffers_count() const;
+
+    std::size_t hits() const;
+    std::size_t misses() const;
+
+    // When allocator is set, buffers are not pooled and every acquire() allocates new buffer by it.
+    // Returns nullptr if allocator has no memory.
+    void set_allocator(const ReadBufferAllocator& allocator);
+    const ReadBufferAllocator& allocator() const;
+
+    static std::shared_ptr<char> allocate(const ReadBufferAllocator& allocator, std::size_t size);
+
+private:
+    std::vector<std::shared_ptr<char>> m_buffers;
+    std::size_t m_next_index = 0;
+
+    std::size_t m_buffer_size = 0;
+    std::size_t m_max_buffers_count = 0;
+
+    std::size_t m_hits = 0;
+    std::size_t m_misses = 0;
+
+    ReadBufferAllocator m_allocator;
+};
+
+} // namespace detail
+} // namespace io
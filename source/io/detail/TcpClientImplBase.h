@@ -1,8 +1,17 @@
 #pragma once
 
+#include "io/DataChunk.h"
 #include "io/EventLoop.h"
+#include "io/File.h"
+#include "ReadBufferPool.h"
+#include "TcpFileSender.h"
+#include "TcpRelayHooks.h"
+#include "TcpZeroCopySender.h"
 
+#include <limits>
 #include <memory>
+#include <string>
+#include <vector>
 #include <assert.h>
 
 namespace io {
@@ -19,8 +28,16 @@ public:
     void send_data(std::shared_ptr<const char> buffer, std::uint32_t size, typename ParentType::EndSendCallback callback);
     void send_data(const std::string& message, typename ParentType::EndSendCallback callback);
     void send_data(std::string&& message, typename ParentType::EndSendCallback callback);
+    void send_data(std::vector<DataChunk> chunks, typename ParentType::EndSendCallback callback);
+    void send_file(File& file, std::uint64_t offset, std::size_t length, typename ParentType::SendFileCallback callback);
 
     std::size_t pending_write_requests() const;
+    std::size_t pending_write_bytes() const;
+
+    Error set_write_watermarks(std::size_t low, std::size_t high);
+    bool is_write_buffer_full() const;
+    void set_on_write_buffer_full(typename ParentType::WriteBufferFullCallback callback);
+    void set_on_write_buffer_drained(typename ParentType::WriteBufferDrainedCallback callback);
 
     Error init_stream();
 
@@ -29,17 +46,78 @@ public:
     void delay_send(bool enabled);
     bool is_delay_send() const;
 
+    void cork_send(bool enabled);
+    bool is_cork_send() const;
+
+    // Resuming needs read callback of the concrete client, so it is implemented by ImplType
+    Error pause_reading();
+    bool is_reading_paused() const;
+
+    Error set_read_buffer_allocator(const ReadBufferAllocator& allocator);
+
+    // Interface for TcpRelay. While hooks are set, received data is passed to them instead of
+    // user's callbacks. In zero copy mode data is not read at all, hooks are notified about readability.
+    void set_relay_hooks(TcpRelayHooks* hooks, bool zero_copy);
+    int native_handle() const;
+    // Sends FIN after pending data, unlike shutdown() connection stays open for reading
+    Error shutdown_write();
+
+    Error set_zero_copy_send_threshold(std::size_t size);
+    std::size_t zero_copy_send_threshold() const;
+    std::size_t zero_copy_sends_count() const;
+
 protected:
+    // Corked data is written when any of these limits is reached even if loop iteration is not finished
+    static const std::size_t CORK_MAX_BYTES = 256 * 1024;
+    static const std::size_t CORK_MAX_BUFFERS = 256;
+
     const char* raw_buffer_getter(const std::string& s) const;
     const char* raw_buffer_getter(const std::shared_ptr<const char>& p) const;
 
+    static std::shared_ptr<const char> to_shared_buffer(std::string&& s);
+    static std::shared_ptr<const char> to_shared_buffer(std::shared_ptr<const char>&& p);
+
+    void cork_buffer(std::shared_ptr<const char> buffer,
+                     const char* data,
+                     std::uint32_t size,
+                     typename ParentType::EndSendCallback callback,
+                     bool end_of_send);
+    void flush_corked_sends();
+
+    // File is sent when previous writes reached the socket
+    void continue_file_send();
+    void finish_file_send(const Error& error);
+    // Completes file send on connection close, sendfile which is in progress is awaited
+    void cancel_file_send();
+
+    // Notifies user when pending bytes cross watermarks
+    void update_write_buffer_state();
+
+    // Connection does not own read buffer between reads, it is returned to the loop's pool when
+    // the caller releases result (unless user retained it). Adjusts buffer size for the next read.
+    std::shared_ptr<char> take_read_buffer(ssize_t nread);
+
+    // Returns true if read result was consumed by relay
+    bool relay_read(ssize_t nread);
+
+    // Returns false if buffer should be sent by regular write
+    bool try_zero_copy_send(const std::shared_ptr<const char>& buffer, std::uint32_t size, typename ParentType::EndSendCallback callback);
+    // Socket error queue with kernel notifications makes socket readable, called on socket events
+    void process_zero_copy_completions();
+    // Notifications are not available after socket is closed
+    void close_zero_copy_sends();
+
     template<typename T>
     void send_data_impl(T buffer, std::uint32_t size, typename ParentType::EndSendCallback callback);
 
     // statics
-    template<typename T>
+    template<typename RequestType>
     static void after_write(uv_write_t* req, int status);
     static void alloc_read_buffer(uv_handle_t* handle, size_t suggested_size, uv_buf_t* buf);
+    static void after_corked_write(uv_write_t* req, int status);
+    static void on_cork_prepare(uv_prepare_t* handle);
+    static void on_cork_prepare_close(uv_handle_t* handle);
+    static void on_shutdown_write(uv_shutdown_t* req, int status);
 
     // data
     EventLoop* m_loop;
@@ -50,9 +128,23 @@ protected:
 
     uv_tcp_t* m_tcp_stream = nullptr;
     std::size_t m_pending_write_requests = 0;
+    std::size_t m_pending_write_bytes = 0;
+
+    std::size_t m_write_low_watermark = 0;
+    std::size_t m_write_high_watermark = 0;
+    bool m_write_buffer_full = false;
+    typename ParentType::WriteBufferFullCallback m_write_buffer_full_callback = nullptr;
+    typename ParentType::WriteBufferDrainedCallback m_write_buffer_drained_callback = nullptr;
+
+    bool m_read_paused = false;
 
     std::shared_ptr<char> m_read_buf;
-    std::size_t m_read_buf_size = 0;
+    std::size_t m_read_buf_size_class = 0;
+    std::size_t m_small_reads_count = 0;
+    ReadBufferAllocator m_read_buffer_allocator;
+
+    TcpRelayHooks* m_relay_hooks = nullptr;
+    bool m_relay_zero_copy = false;
 
     std::size_t m_data_offset = 0;
 
@@ -64,11 +156,45 @@ protected:
     typename ParentType::CloseCallback m_close_callback = nullptr;
 
 private:
+    // Buffer of corked send, callback is called only by the last buffer of the send
+    struct CorkedBuffer {
+        uv_buf_t uv_buf;
+        std::shared_ptr<const char> buf;
+        typename ParentType::EndSendCallback end_send_callback;
+        bool end_of_send = false;
+    };
+
+    struct CorkedWriteRequest : public uv_write_t {
+        std::vector<uv_buf_t> uv_bufs;
+        std::vector<CorkedBuffer> buffers;
+    };
+
+    bool m_cork_send = false;
+    uv_prepare_t* m_cork_prepare = nullptr;
+    std::vector<CorkedBuffer> m_corked_buffers;
+    std::size_t m_corked_bytes = 0;
+
+    // Sends made during file send are held in corked buffers and written after the file.
+    // Bytes left to send are counted as pending until the file send is finished.
+    std::unique_ptr<TcpFileSender> m_file_sender;
+    typename ParentType::SendFileCallback m_file_send_callback = nullptr;
+
+    std::size_t m_zero_copy_threshold = 0;
+    TcpZeroCopySender m_zero_copy_sender;
+
     template<typename T>
     struct WriteRequest : public uv_write_t {
         uv_buf_t uv_buf;
         typename ParentType::EndSendCallback end_send_callback;
         T buf;
+        std::size_t size = 0;
+    };
+
+    struct VectoredWriteRequest : public uv_write_t {
+        std::vector<uv_buf_t> uv_bufs;
+        std::size_t size = 0;
+        typename ParentType::EndSendCallback end_send_callback;
+        std::vector<DataChunk> chunks;
     };
 };
 
@@ -78,12 +204,27 @@ template<typename ParentType, typename ImplType>
 TcpClientImplBase<ParentType, ImplType>::TcpClientImplBase(EventLoop& loop, ParentType& parent) :
     m_loop(&loop),
     m_uv_loop(reinterpret_cast<uv_loop_t*>(loop.raw_loop())),
-    m_parent(&parent) {
+    m_parent(&parent),
+    m_zero_copy_sender(m_uv_loop) {
 }
 
 template<typename ParentType, typename ImplType>
 TcpClientImplBase<ParentType, ImplType>::~TcpClientImplBase() {
     m_read_buf.reset();
+
+    if (m_relay_hooks) {
+        m_relay_hooks->on_relay_connection_destroyed();
+    }
+
+    // Corked data is flushed before connection is closed, so nothing could be lost here
+    if (m_cork_prepare) {
+        m_cork_prepare->data = nullptr;
+        uv_close(reinterpret_cast<uv_handle_t*>(m_cork_prepare), on_cork_prepare_close);
+    }
+
+    // Connection is closed before removal, so file sender could remain only if sendfile is still
+    // in progress. It is abandoned without the callback.
+    m_file_sender.reset();
 }
 
 template<typename ParentType, typename ImplType>
@@ -97,6 +238,7 @@ Error TcpClientImplBase<ParentType, ImplType>::init_stream() {
 
     m_tcp_stream = new uv_tcp_t;
     m_tcp_stream->data = this;
+    m_read_paused = false;
 
     Error init_error = uv_tcp_init(m_uv_loop, m_tcp_stream);
     if (init_error) {
@@ -133,14 +275,22 @@ void TcpClientImplBase<ParentType, ImplType>::send_data_impl(T buffer, std::uint
         return;
     }
 
+    if (m_cork_send || m_file_sender) {
+        auto buf = to_shared_buffer(std::move(buffer));
+        const char* data = buf.get();
+        cork_buffer(std::move(buf), data, size, callback, true);
+        return;
+    }
+
     auto req = new WriteRequest<T>;
     req->end_send_callback = callback;
     req->data = this;
     req->buf = std::move(buffer);
     // const_cast is a workaround for lack of constness support in uv_buf_t
     req->uv_buf = uv_buf_init(const_cast<char*>(raw_buffer_getter(req->buf)), size);
+    req->size = size;
 
-    const Error write_error = uv_write(req, reinterpret_cast<uv_stream_t*>(m_tcp_stream), &req->uv_buf, 1, after_write<T>);
+    const Error write_error = uv_write(req, reinterpret_cast<uv_stream_t*>(m_tcp_stream), &req->uv_buf, 1, after_write<WriteRequest<T>>);
     if (write_error) {
         IO_LOG(m_loop, ERROR, m_parent, "Error:", write_error.string());
         if (callback) {
@@ -151,10 +301,15 @@ void TcpClientImplBase<ParentType, ImplType>::send_data_impl(T buffer, std::uint
     }
 
     ++m_pending_write_requests;
+    m_pending_write_bytes += size;
+    update_write_buffer_state();
 }
 
 template<typename ParentType, typename ImplType>
 void TcpClientImplBase<ParentType, ImplType>::send_data(std::shared_ptr<const char> buffer, std::uint32_t size, typename ParentType::EndSendCallback callback) {
+    if (try_zero_copy_send(buffer, size, callback)) {
+        return;
+    }
 
     send_data_impl(buffer, size, callback);
 }
@@ -172,11 +327,256 @@ void TcpClientImplBase<ParentType, ImplType>::send_data(std::string&& message, t
     send_data_impl(std::move(message), size, callback);
 }
 
+template<typename ParentType, typename ImplType>
+void TcpClientImplBase<ParentType, ImplType>::send_data(std::vector<DataChunk> chunks, typename ParentType::EndSendCallback callback) {
+    if (!is_open()) {
+        if (callback) {
+            callback(*m_parent, io::Error(StatusCode::NOT_CONNECTED));
+        }
+        return;
+    }
+
+    std::size_t last_chunk_index = chunks.size();
+    for (std::size_t i = 0; i < chunks.size(); ++i) {
+        if (chunks[i].size) {
+            last_chunk_index = i;
+        }
+    }
+
+    if ((m_cork_send || m_file_sender) && last_chunk_index < chunks.size()) {
+        for (std::size_t i = 0; i <= last_chunk_index; ++i) {
+            const auto& chunk = chunks[i];
+            if (chunk.size && (chunk.buf == nullptr || chunk.size > std::numeric_limits<std::uint32_t>::max())) {
+                if (callback) {
+                    callback(*m_parent, io::Error(StatusCode::INVALID_ARGUMENT));
+                }
+                return;
+            }
+        }
+
+        for (std::size_t i = 0; i <= last_chunk_index; ++i) {
+            auto& chunk = chunks[i];
+            if (chunk.size == 0) {
+                continue;
+            }
+
+            const char* data = chunk.buf.get();
+            cork_buffer(std::move(chunk.buf),
+                        data,
+                        static_cast<std::uint32_t>(chunk.size),
+                        i == last_chunk_index ? callback : nullptr,
+                        i == last_chunk_index);
+        }
+        return;
+    }
+
+    auto req = new VectoredWriteRequest;
+    req->uv_bufs.reserve(chunks.size());
+
+    for (const auto& chunk : chunks) {
+        if (chunk.size == 0) {
+            continue;
+        }
+
+        if (chunk.buf == nullptr || chunk.size > std::numeric_limits<std::uint32_t>::max()) {
+            delete req;
+            if (callback) {
+                callback(*m_parent, io::Error(StatusCode::INVALID_ARGUMENT));
+            }
+            return;
+        }
+
+        // const_cast is a workaround for lack of constness support in uv_buf_t
+        req->uv_bufs.push_back(uv_buf_init(const_cast<char*>(chunk.buf.get()),
+                                           static_cast<unsigned int>(chunk.size)));
+        req->size += chunk.size;
+    }
+
+    if (req->uv_bufs.empty()) {
+        delete req;
+        if (callback) {
+            callback(*m_parent, io::Error(StatusCode::INVALID_ARGUMENT));
+        }
+        return;
+    }
+
+    req->end_send_callback = callback;
+    req->data = this;
+    // Chunks are held by request until write is done, buffers addresses do not change on move
+    req->chunks = std::move(chunks);
+
+    const Error write_error = uv_write(req,
+                                       reinterpret_cast<uv_stream_t*>(m_tcp_stream),
+                                       req->uv_bufs.data(),
+                                       static_cast<unsigned int>(req->uv_bufs.size()),
+                                       after_write<VectoredWriteRequest>);
+    if (write_error) {
+        IO_LOG(m_loop, ERROR, m_parent, "Error:", write_error.string());
+        if (callback) {
+            callback(*m_parent, write_error);
+        }
+        delete req;
+        return;
+    }
+
+    ++m_pending_write_requests;
+    m_pending_write_bytes += req->size;
+    update_write_buffer_state();
+}
+
+template<typename ParentType, typename ImplType>
+void TcpClientImplBase<ParentType, ImplType>::send_file(File& file,
+                                                        std::uint64_t offset,
+                                                        std::size_t length,
+                                                        typename ParentType::SendFileCallback callback) {
+    if (!is_open()) {
+        if (callback) {
+            callback(*m_parent, 0, io::Error(StatusCode::NOT_CONNECTED));
+        }
+        return;
+    }
+
+    if (!file.is_open() || length == 0) {
+        if (callback) {
+            callback(*m_parent, 0, io::Error(StatusCode::INVALID_ARGUMENT));
+        }
+        return;
+    }
+
+    if (m_file_sender) {
+        if (callback) {
+            callback(*m_parent, 0, io::Error(StatusCode::RESOURCE_BUSY_OR_LOCKED));
+        }
+        return;
+    }
+
+    // Data sent before the file goes first
+    flush_corked_sends();
+
+    m_file_sender.reset(new TcpFileSender(m_uv_loop,
+                                          file.native_handle(),
+                                          offset,
+                                          length,
+                                          [this]() {
+                                              update_write_buffer_state();
+                                          },
+                                          [this](const Error& error) {
+                                              finish_file_send(error);
+                                          }));
+    m_file_send_callback = callback;
+
+    ++m_pending_write_requests;
+    update_write_buffer_state();
+
+    continue_file_send();
+}
+
+template<typename ParentType, typename ImplType>
+void TcpClientImplBase<ParentType, ImplType>::continue_file_send() {
+    if (!m_file_sender || m_file_sender->is_busy()) {
+        return;
+    }
+
+    if (!is_open() || m_tcp_stream == nullptr || uv_is_closing(reinterpret_cast<uv_handle_t*>(m_tcp_stream))) {
+        m_file_sender->cancel();
+        return;
+    }
+
+    // Previous writes should reach the socket first, called again when they are done
+    if (m_tcp_stream->write_queue_size) {
+        return;
+    }
+
+    m_file_sender->send(native_handle());
+}
+
+template<typename ParentType, typename ImplType>
+void TcpClientImplBase<ParentType, ImplType>::cancel_file_send() {
+    if (m_file_sender) {
+        m_file_sender->cancel();
+    }
+}
+
+template<typename ParentType, typename ImplType>
+void TcpClientImplBase<ParentType, ImplType>::finish_file_send(const Error& error) {
+    // Sender is destroyed after the callback, because it may start the next file send
+    std::unique_ptr<TcpFileSender> file_sender(std::move(m_file_sender));
+    auto callback = std::move(m_file_send_callback);
+    m_file_send_callback = nullptr;
+
+    assert(m_pending_write_requests >= 1);
+    --m_pending_write_requests;
+
+    if (error) {
+        IO_LOG(m_loop, ERROR, m_parent, "Error:", error.string());
+    }
+
+    // Sends which were held during the file send
+    flush_corked_sends();
+
+    if (callback) {
+        callback(*m_parent, file_sender->bytes_sent(), error);
+    }
+
+    update_write_buffer_state();
+}
+
 template<typename ParentType, typename ImplType>
 std::size_t TcpClientImplBase<ParentType, ImplType>::pending_write_requests() const {
     return m_pending_write_requests;
 }
 
+template<typename ParentType, typename ImplType>
+std::size_t TcpClientImplBase<ParentType, ImplType>::pending_write_bytes() const {
+    return m_pending_write_bytes + (m_file_sender ? m_file_sender->bytes_left() : 0);
+}
+
+template<typename ParentType, typename ImplType>
+Error TcpClientImplBase<ParentType, ImplType>::set_write_watermarks(std::size_t low, std::size_t high) {
+    if (low > high) {
+        return Error(StatusCode::INVALID_ARGUMENT);
+    }
+
+    m_write_low_watermark = low;
+    m_write_high_watermark = high;
+    update_write_buffer_state();
+
+    return Error(0);
+}
+
+template<typename ParentType, typename ImplType>
+bool TcpClientImplBase<ParentType, ImplType>::is_write_buffer_full() const {
+    return m_write_buffer_full;
+}
+
+template<typename ParentType, typename ImplType>
+void TcpClientImplBase<ParentType, ImplType>::set_on_write_buffer_full(typename ParentType::WriteBufferFullCallback callback) {
+    m_write_buffer_full_callback = callback;
+}
+
+template<typename ParentType, typename ImplType>
+void TcpClientImplBase<ParentType, ImplType>::set_on_write_buffer_drained(typename ParentType::WriteBufferDrainedCallback callback) {
+    m_write_buffer_drained_callback = callback;
+}
+
+template<typename ParentType, typename ImplType>
+void TcpClientImplBase<ParentType, ImplType>::update_write_buffer_state() {
+    if (!m_write_buffer_full) {
+        // Zero high watermark disables notifications
+        if (m_write_high_watermark && pending_write_bytes() >= m_write_high_watermark) {
+            m_write_buffer_full = true;
+            if (m_write_buffer_full_callback) {
+                m_write_buffer_full_callback(*m_parent);
+            }
+        }
+    } else if (m_write_high_watermark == 0 || pending_write_bytes() <= m_write_low_watermark) {
+        m_write_buffer_full = false;
+        if (m_write_buffer_drained_callback) {
+            m_write_buffer_drained_callback(*m_parent);
+        }
+    }
+}
+
 template<typename ParentType, typename ImplType>
 bool TcpClientImplBase<ParentType, ImplType>::is_open() const {
     return m_is_open;
@@ -193,17 +593,295 @@ bool TcpClientImplBase<ParentType, ImplType>::is_delay_send() const {
     return m_delay_send;
 }
 
+template<typename ParentType, typename ImplType>
+void TcpClientImplBase<ParentType, ImplType>::cork_send(bool enabled) {
+    m_cork_send = enabled;
+
+    if (!enabled) {
+        flush_corked_sends();
+    }
+}
+
+template<typename ParentType, typename ImplType>
+bool TcpClientImplBase<ParentType, ImplType>::is_cork_send() const {
+    return m_cork_send;
+}
+
+template<typename ParentType, typename ImplType>
+Error TcpClientImplBase<ParentType, ImplType>::pause_reading() {
+    if (!is_open()) {
+        return Error(StatusCode::NOT_CONNECTED);
+    }
+
+    if (m_read_paused) {
+        return Error(0);
+    }
+
+    const Error error = uv_read_stop(reinterpret_cast<uv_stream_t*>(m_tcp_stream));
+    if (error) {
+        return error;
+    }
+
+    m_read_paused = true;
+    return Error(0);
+}
+
+template<typename ParentType, typename ImplType>
+bool TcpClientImplBase<ParentType, ImplType>::is_reading_paused() const {
+    return m_read_paused;
+}
+
+template<typename ParentType, typename ImplType>
+Error TcpClientImplBase<ParentType, ImplType>::set_read_buffer_allocator(const ReadBufferAllocator& allocator) {
+    if (!allocator.is_valid()) {
+        return Error(StatusCode::INVALID_ARGUMENT);
+    }
+
+    m_read_buffer_allocator = allocator;
+    return Error(0);
+}
+
+template<typename ParentType, typename ImplType>
+void TcpClientImplBase<ParentType, ImplType>::set_relay_hooks(TcpRelayHooks* hooks, bool zero_copy) {
+    m_relay_hooks = hooks;
+    m_relay_zero_copy = hooks && zero_copy;
+}
+
+template<typename ParentType, typename ImplType>
+int TcpClientImplBase<ParentType, ImplType>::native_handle() const {
+#if defined(_WIN32)
+    return -1;
+#else
+    uv_os_fd_t handle = -1;
+    if (m_tcp_stream == nullptr || uv_fileno(reinterpret_cast<const uv_handle_t*>(m_tcp_stream), &handle) != 0) {
+        return -1;
+    }
+
+    return handle;
+#endif
+}
+
+template<typename ParentType, typename ImplType>
+Error TcpClientImplBase<ParentType, ImplType>::shutdown_write() {
+    if (!is_open()) {
+        return Error(StatusCode::NOT_CONNECTED);
+    }
+
+    flush_corked_sends();
+
+    auto shutdown_req = new uv_shutdown_t;
+    const Error error = uv_shutdown(shutdown_req, reinterpret_cast<uv_stream_t*>(m_tcp_stream), on_shutdown_write);
+    if (error) {
+        delete shutdown_req;
+    }
+
+    return error;
+}
+
+template<typename ParentType, typename ImplType>
+Error TcpClientImplBase<ParentType, ImplType>::set_zero_copy_send_threshold(std::size_t size) {
+    if (!TcpZeroCopySender::is_supported()) {
+        return Error(StatusCode::FUNCTION_NOT_IMPLEMENTED);
+    }
+
+    m_zero_copy_threshold = size;
+    return Error(0);
+}
+
+template<typename ParentType, typename ImplType>
+std::size_t TcpClientImplBase<ParentType, ImplType>::zero_copy_send_threshold() const {
+    return m_zero_copy_threshold;
+}
+
+template<typename ParentType, typename ImplType>
+std::size_t TcpClientImplBase<ParentType, ImplType>::zero_copy_sends_count() const {
+    return m_zero_copy_sender.sends_count();
+}
+
+template<typename ParentType, typename ImplType>
+bool TcpClientImplBase<ParentType, ImplType>::try_zero_copy_send(const std::shared_ptr<const char>& buffer,
+                                                                 std::uint32_t size,
+                                                                 typename ParentType::EndSendCallback callback) {
+    if (m_zero_copy_threshold == 0 || size < m_zero_copy_threshold || buffer == nullptr || !is_open()) {
+        return false;
+    }
+
+    // Data should not overtake the one which is queued in libuv or held by cork and file sends
+    if (m_cork_send || m_file_sender || m_tcp_stream->write_queue_size) {
+        return false;
+    }
+
+    const bool sent = m_zero_copy_sender.send(m_tcp_stream, buffer, size, [this, size, callback](const Error& error) {
+        assert(m_pending_write_requests >= 1);
+        --m_pending_write_requests;
+        assert(m_pending_write_bytes >= size);
+        m_pending_write_bytes -= size;
+
+        if (error) {
+            IO_LOG(m_loop, ERROR, m_parent, "Error:", error.string());
+        }
+
+        if (callback) {
+            callback(*m_parent, error);
+        }
+
+        update_write_buffer_state();
+    });
+    if (!sent) {
+        return false;
+    }
+
+    ++m_pending_write_requests;
+    m_pending_write_bytes += size;
+    update_write_buffer_state();
+    return true;
+}
+
+template<typename ParentType, typename ImplType>
+void TcpClientImplBase<ParentType, ImplType>::process_zero_copy_completions() {
+    m_zero_copy_sender.process_completions();
+}
+
+template<typename ParentType, typename ImplType>
+void TcpClientImplBase<ParentType, ImplType>::close_zero_copy_sends() {
+    m_zero_copy_sender.close();
+}
+
+template<typename ParentType, typename ImplType>
+bool TcpClientImplBase<ParentType, ImplType>::relay_read(ssize_t nread) {
+    if (m_relay_hooks == nullptr) {
+        return false;
+    }
+
+    // Zero size buffer was provided, libuv reports this without reading data
+    if (m_relay_zero_copy && nread == UV_ENOBUFS) {
+        m_relay_hooks->on_relay_read(DataChunk(), Error(0));
+        return true;
+    }
+
+    const auto read_buf = take_read_buffer(nread);
+
+    if (nread < 0) {
+        m_relay_hooks->on_relay_read(DataChunk(), Error(static_cast<int>(nread)));
+    } else if (nread > 0) {
+        const std::size_t offset = m_data_offset;
+        m_data_offset += static_cast<std::size_t>(nread);
+        m_relay_hooks->on_relay_read({read_buf, std::size_t(nread), offset}, Error(0));
+    }
+
+    return true;
+}
+
+template<typename ParentType, typename ImplType>
+std::shared_ptr<const char> TcpClientImplBase<ParentType, ImplType>::to_shared_buffer(std::string&& s) {
+    auto str = std::make_shared<std::string>(std::move(s));
+    // Aliasing constructor, string is owned by the result
+    return std::shared_ptr<const char>(str, str->c_str());
+}
+
+template<typename ParentType, typename ImplType>
+std::shared_ptr<const char> TcpClientImplBase<ParentType, ImplType>::to_shared_buffer(std::shared_ptr<const char>&& p) {
+    return std::move(p);
+}
+
+template<typename ParentType, typename ImplType>
+void TcpClientImplBase<ParentType, ImplType>::cork_buffer(std::shared_ptr<const char> buffer,
+                                                          const char* data,
+                                                          std::uint32_t size,
+                                                          typename ParentType::EndSendCallback callback,
+                                                          bool end_of_send) {
+    if (m_cork_prepare == nullptr) {
+        auto cork_prepare = new uv_prepare_t;
+        const Error init_error = uv_prepare_init(m_uv_loop, cork_prepare);
+        if (init_error) {
+            // Buffer is flushed right away then, next send makes one more attempt
+            IO_LOG(m_loop, ERROR, m_parent, "Error:", init_error.string());
+            delete cork_prepare;
+        } else {
+            cork_prepare->data = this;
+            m_cork_prepare = cork_prepare;
+        }
+    }
+
+    if (m_cork_prepare && !uv_is_active(reinterpret_cast<uv_handle_t*>(m_cork_prepare))) {
+        uv_prepare_start(m_cork_prepare, on_cork_prepare);
+    }
+
+    m_corked_buffers.emplace_back();
+    auto& corked_buffer = m_corked_buffers.back();
+    // const_cast is a workaround for lack of constness support in uv_buf_t
+    corked_buffer.uv_buf = uv_buf_init(const_cast<char*>(data), size);
+    corked_buffer.buf = std::move(buffer);
+    corked_buffer.end_send_callback = callback;
+    corked_buffer.end_of_send = end_of_send;
+
+    m_corked_bytes += size;
+    m_pending_write_bytes += size;
+    if (end_of_send) {
+        ++m_pending_write_requests;
+    }
+
+    update_write_buffer_state();
+
+    if (m_cork_prepare == nullptr || m_corked_bytes >= CORK_MAX_BYTES || m_corked_buffers.size() >= CORK_MAX_BUFFERS) {
+        flush_corked_sends();
+    }
+}
+
+template<typename ParentType, typename ImplType>
+void TcpClientImplBase<ParentType, ImplType>::flush_corked_sends() {
+    if (m_corked_buffers.empty()) {
+        return;
+    }
+
+    if (m_cork_prepare) {
+        uv_prepare_stop(m_cork_prepare);
+    }
+
+    // Held until file is sent, but connection which is being closed completes them right away
+    if (m_file_sender && is_open()) {
+        return;
+    }
+
+    auto req = new CorkedWriteRequest;
+    req->data = this;
+    req->buffers.swap(m_corked_buffers);
+    m_corked_bytes = 0;
+
+    req->uv_bufs.reserve(req->buffers.size());
+    for (auto& buffer : req->buffers) {
+        req->uv_bufs.push_back(buffer.uv_buf);
+    }
+
+    int uv_status = UV_ENOTCONN;
+    if (m_tcp_stream) {
+        uv_status = uv_write(req,
+                             reinterpret_cast<uv_stream_t*>(m_tcp_stream),
+                             req->uv_bufs.data(),
+                             static_cast<unsigned int>(req->uv_bufs.size()),
+                             after_corked_write);
+    }
+
+    if (uv_status < 0) {
+        // Completing all sends with the error right away, same as for not corked ones
+        after_corked_write(req, uv_status);
+    }
+}
+
 ////////////////////////////////////////////// static //////////////////////////////////////////////
 template<typename ParentType, typename ImplType>
-template<typename T>
+template<typename RequestType>
 void TcpClientImplBase<ParentType, ImplType>::after_write(uv_write_t* req, int uv_status) {
     auto& this_ = *reinterpret_cast<ImplType*>(req->data);
 
     assert(this_.m_pending_write_requests >= 1);
     --this_.m_pending_write_requests;
 
-    auto request = reinterpret_cast<WriteRequest<T>*>(req);
-    std::unique_ptr<WriteRequest<T>> guard(request);
+    auto request = reinterpret_cast<RequestType*>(req);
+    std::unique_ptr<RequestType> guard(request);
+
+    assert(this_.m_pending_write_bytes >= request->size);
+    this_.m_pending_write_bytes -= request->size;
 
     Error error(uv_status);
     if (error) {
@@ -213,21 +891,100 @@ void TcpClientImplBase<ParentType, ImplType>::after_write(uv_write_t* req, int u
     if (request->end_send_callback) {
         request->end_send_callback(*this_.m_parent, error);
     }
+
+    // After the callback, because it may send more data
+    this_.update_write_buffer_state();
+
+    this_.continue_file_send();
+}
+
+template<typename ParentType, typename ImplType>
+void TcpClientImplBase<ParentType, ImplType>::after_corked_write(uv_write_t* req, int uv_status) {
+    auto& this_ = *reinterpret_cast<TcpClientImplBase*>(req->data);
+
+    auto request = reinterpret_cast<CorkedWriteRequest*>(req);
+    std::unique_ptr<CorkedWriteRequest> guard(request);
+
+    for (auto& buffer : request->buffers) {
+        assert(this_.m_pending_write_bytes >= buffer.uv_buf.len);
+        this_.m_pending_write_bytes -= buffer.uv_buf.len;
+    }
+
+    Error error(uv_status);
+    if (error) {
+        IO_LOG(this_.m_loop, ERROR, this_.m_parent, "Error:", uv_strerror(uv_status));
+    }
+
+    for (auto& buffer : request->buffers) {
+        if (!buffer.end_of_send) {
+            continue;
+        }
+
+        assert(this_.m_pending_write_requests >= 1);
+        --this_.m_pending_write_requests;
+
+        if (buffer.end_send_callback) {
+            buffer.end_send_callback(*this_.m_parent, error);
+        }
+    }
+
+    this_.update_write_buffer_state();
+
+    this_.continue_file_send();
 }
 
 template<typename ParentType, typename ImplType>
-void TcpClientImplBase<ParentType, ImplType>::alloc_read_buffer(uv_handle_t* handle, size_t suggested_size, uv_buf_t* buf) {
+void TcpClientImplBase<ParentType, ImplType>::on_cork_prepare(uv_prepare_t* handle) {
+    if (handle->data == nullptr) {
+        return;
+    }
+
+    auto& this_ = *reinterpret_cast<TcpClientImplBase*>(handle->data);
+    this_.flush_corked_sends();
+}
+
+template<typename ParentType, typename ImplType>
+void TcpClientImplBase<ParentType, ImplType>::on_cork_prepare_close(uv_handle_t* handle) {
+    delete reinterpret_cast<uv_prepare_t*>(handle);
+}
+
+template<typename ParentType, typename ImplType>
+void TcpClientImplBase<ParentType, ImplType>::on_shutdown_write(uv_shutdown_t* req, int /*status*/) {
+    delete req;
+}
+
+template<typename ParentType, typename ImplType>
+void TcpClientImplBase<ParentType, ImplType>::alloc_read_buffer(uv_handle_t* handle, size_t /*suggested_size*/, uv_buf_t* buf) {
     auto& this_ = *reinterpret_cast<ImplType*>(handle->data);
 
-    if (this_.m_read_buf == nullptr) {
-        default_alloc_buffer(handle, suggested_size, buf);
+    if (this_.m_relay_zero_copy) {
+        buf->base = nullptr;
+        buf->len = 0;
+        return;
+    }
 
-        this_.m_read_buf.reset(buf->base, std::default_delete<char[]>());
-        this_.m_read_buf_size = buf->len;
+    // Suggested size is ignored, buffer size adapts to the amount of data received by previous reads
+    const std::size_t size = ReadBufferPool::buffer_size(this_.m_read_buf_size_class);
+    if (this_.m_read_buffer_allocator.is_set()) {
+        this_.m_read_buf = ReceiveBufferPool::allocate(this_.m_read_buffer_allocator, size);
     } else {
-        buf->base =  this_.m_read_buf.get();
-        buf->len = static_cast<decltype(uv_buf_t::len)>(this_.m_read_buf_size);
+        this_.m_read_buf = this_.m_loop->read_buffer_pool().acquire(this_.m_read_buf_size_class);
+    }
+
+    // Null buffer means that user's allocator has no memory, libuv reports ENOBUFS in this case
+    buf->base = this_.m_read_buf.get();
+    buf->len = this_.m_read_buf ? static_cast<decltype(uv_buf_t::len)>(size) : 0;
+}
+
+template<typename ParentType, typename ImplType>
+std::shared_ptr<char> TcpClientImplBase<ParentType, ImplType>::take_read_buffer(ssize_t nread) {
+    if (nread > 0) {
+        m_read_buf_size_class = ReadBufferPool::next_size_class(m_read_buf_size_class,
+                                                                static_cast<std::size_t>(nread),
+                                                                m_small_reads_count);
     }
+
+    return std::move(m_read_buf);
 }
 
 } // namespace detail
@@ -0,0 +1,229 @@
+#include "TcpFileSender.h"
+
+#include <memory>
+
+#include <assert.h>
+
+#if !defined(_WIN32)
+    #include <cerrno>
+    #include <unistd.h>
+#endif
+
+namespace io {
+namespace detail {
+
+TcpFileSender::TcpFileSender(uv_loop_t* loop,
+                             int file_handle,
+                             std::uint64_t offset,
+                             std::size_t length,
+                             WaitWritableCallback wait_writable_callback,
+                             EndSendCallback end_send_callback) :
+    m_loop(loop),
+    m_file_handle(file_handle),
+    m_offset(offset),
+    m_bytes_left(length),
+    m_wait_writable_callback(wait_writable_callback),
+    m_end_send_callback(end_send_callback) {
+}
+
+TcpFileSender::~TcpFileSender() {
+    release_handles();
+}
+
+bool TcpFileSender::is_busy() const {
+    return m_request != nullptr || m_waiting_writable;
+}
+
+std::size_t TcpFileSender::bytes_sent() const {
+    return m_bytes_sent;
+}
+
+std::size_t TcpFileSender::bytes_left() const {
+    return m_bytes_left;
+}
+
+void TcpFileSender::send(int socket_handle) {
+    if (is_busy()) {
+        return;
+    }
+
+#if defined(_WIN32)
+    (void)socket_handle;
+    finish(Error(StatusCode::FUNCTION_NOT_IMPLEMENTED));
+#else
+    if (m_socket_handle == -1) {
+        m_socket_handle = ::dup(socket_handle);
+        if (m_socket_handle == -1) {
+            finish(Error(-errno));
+            return;
+        }
+    }
+
+    // Socket is non-blocking, sendfile in thread pool takes time only to read file data which
+    // is not in page cache.
+    auto request = new SendfileRequest;
+    request->data = this;
+    request->socket_handle = m_socket_handle;
+    const Error sendfile_error = uv_fs_sendfile(m_loop,
+                                                request,
+                                                static_cast<uv_file>(m_socket_handle),
+                                                m_file_handle,
+                                                static_cast<std::int64_t>(m_offset),
+                                                m_bytes_left,
+                                                on_sendfile);
+    if (sendfile_error) {
+        delete request;
+        finish(sendfile_error);
+        return;
+    }
+
+    m_request = request;
+#endif
+}
+
+void TcpFileSender::cancel() {
+    if (m_request) {
+        m_canceled = true;
+        uv_cancel(reinterpret_cast<uv_req_t*>(m_request));
+        return;
+    }
+
+    finish(Error(StatusCode::OPERATION_CANCELED));
+}
+
+void TcpFileSender::release_handles() {
+    // Closing handle stops polling immediately, so descriptor could be closed right away
+    if (m_poll_handle) {
+        m_poll_handle->data = nullptr;
+        uv_close(reinterpret_cast<uv_handle_t*>(m_poll_handle), on_poll_close);
+        m_poll_handle = nullptr;
+    }
+
+    m_waiting_writable = false;
+
+    // Request closes descriptor on completion
+    if (m_request) {
+        m_request->data = nullptr;
+        m_request = nullptr;
+    } else if (m_socket_handle != -1) {
+#if !defined(_WIN32)
+        ::close(m_socket_handle);
+#endif
+    }
+
+    m_socket_handle = -1;
+}
+
+void TcpFileSender::finish(const Error& error) {
+    assert(m_request == nullptr);
+    release_handles();
+
+    // Sender may be destroyed by the callback
+    auto end_send_callback = std::move(m_end_send_callback);
+    m_end_send_callback = nullptr;
+    if (end_send_callback) {
+        end_send_callback(error);
+    }
+}
+
+////////////////////////////////////////////// static //////////////////////////////////////////////
+void TcpFileSender::on_sendfile(uv_fs_t* req) {
+    auto request = reinterpret_cast<SendfileRequest*>(req);
+    std::unique_ptr<SendfileRequest> guard(request);
+
+    const auto result = req->result;
+    uv_fs_req_cleanup(req);
+
+    if (req->data == nullptr) {
+#if !defined(_WIN32)
+        ::close(request->socket_handle);
+#endif
+        return;
+    }
+
+    auto& this_ = *reinterpret_cast<TcpFileSender*>(req->data);
+
+    assert(this_.m_request == request);
+    this_.m_request = nullptr;
+
+    if (result > 0) {
+        assert(this_.m_bytes_left >= static_cast<std::size_t>(result));
+        this_.m_offset += static_cast<std::size_t>(result);
+        this_.m_bytes_left -= static_cast<std::size_t>(result);
+        this_.m_bytes_sent += static_cast<std::size_t>(result);
+    }
+
+    if (this_.m_canceled) {
+        this_.finish(Error(StatusCode::OPERATION_CANCELED));
+        return;
+    }
+
+    if (result > 0) {
+        if (this_.m_bytes_left == 0) {
+            this_.finish(Error(0));
+        } else {
+            this_.send(this_.m_socket_handle);
+        }
+        return;
+    }
+
+    if (result == 0) {
+        // File is shorter than requested
+        this_.finish(Error(StatusCode::END_OF_FILE));
+        return;
+    }
+
+    if (result != UV_EAGAIN) {
+        this_.finish(Error(static_cast<int>(result)));
+        return;
+    }
+
+    if (this_.m_poll_handle == nullptr) {
+        this_.m_poll_handle = new uv_poll_t;
+        const Error init_error = uv_poll_init(this_.m_loop, this_.m_poll_handle, this_.m_socket_handle);
+        if (init_error) {
+            delete this_.m_poll_handle;
+            this_.m_poll_handle = nullptr;
+            this_.finish(init_error);
+            return;
+        }
+        this_.m_poll_handle->data = &this_;
+    }
+
+    const Error start_error = uv_poll_start(this_.m_poll_handle, UV_WRITABLE, on_writable);
+    if (start_error) {
+        this_.finish(start_error);
+        return;
+    }
+
+    this_.m_waiting_writable = true;
+
+    if (this_.m_wait_writable_callback) {
+        this_.m_wait_writable_callback();
+    }
+}
+
+void TcpFileSender::on_writable(uv_poll_t* handle, int status, int /*events*/) {
+    if (handle->data == nullptr) {
+        return;
+    }
+
+    auto& this_ = *reinterpret_cast<TcpFileSender*>(handle->data);
+
+    uv_poll_stop(handle);
+    this_.m_waiting_writable = false;
+
+    if (status < 0) {
+        this_.finish(Error(status));
+        return;
+    }
+
+    this_.send(this_.m_socket_handle);
+}
+
+void TcpFileSender::on_poll_close(uv_handle_t* handle) {
+    delete reinterpret_cast<uv_poll_t*>(handle);
+}
+
+} // namespace detail
+} // namespace io
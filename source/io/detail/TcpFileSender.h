@@ -0,0 +1,84 @@
+#pragma once
+
+#include "io/CommonMacros.h"
+#include "io/Error.h"
+
+#include "Common.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace io {
+namespace detail {
+
+// Sends part of a file to TCP socket by sendfile in thread pool. Socket is non-blocking, so sendfile
+// is repeated until socket is full, after that duplicate of the socket descriptor is polled for
+// writability (libuv has no such notification for TCP stream). Owner should not write to the socket
+// while file is being sent. Not supported on Windows, where sockets are not CRT file descriptors.
+class TcpFileSender {
+public:
+    // Sender is idle during callbacks, so it could be canceled or destroyed from them
+    using WaitWritableCallback = std::function<void()>;
+    using EndSendCallback = std::function<void(const Error& error)>;
+
+    IO_FORBID_COPY(TcpFileSender);
+    IO_FORBID_MOVE(TcpFileSender);
+
+    TcpFileSender(uv_loop_t* loop,
+                  int file_handle,
+                  std::uint64_t offset,
+                  std::size_t length,
+                  WaitWritableCallback wait_writable_callback,
+                  EndSendCallback end_send_callback);
+    ~TcpFileSender();
+
+    // Does nothing if sendfile is in progress or socket is not writable yet.
+    // Socket is duplicated on the first call, descriptor is not used after the call returns.
+    void send(int socket_handle);
+
+    // Sendfile which is in progress could not be abandoned, because file should stay open until
+    // it is done, so end callback may be called later.
+    void cancel();
+
+    bool is_busy() const;
+
+    std::size_t bytes_sent() const;
+    std::size_t bytes_left() const;
+
+protected:
+    void finish(const Error& error);
+    void release_handles();
+
+    // statics
+    static void on_sendfile(uv_fs_t* req);
+    static void on_writable(uv_poll_t* handle, int status, int events);
+    static void on_poll_close(uv_handle_t* handle);
+
+private:
+    // Request owns duplicate of the socket descriptor until completion, so descriptor could not be
+    // reused by other socket while sendfile is in progress. Data is null if sender was destroyed.
+    struct SendfileRequest : public uv_fs_t {
+        int socket_handle = -1;
+    };
+
+    uv_loop_t* m_loop = nullptr;
+
+    int m_file_handle = -1;
+    std::uint64_t m_offset = 0;
+    std::size_t m_bytes_left = 0;
+    std::size_t m_bytes_sent = 0;
+
+    // libuv does not allow to have 2 handles for the same descriptor
+    int m_socket_handle = -1;
+    SendfileRequest* m_request = nullptr;
+    uv_poll_t* m_poll_handle = nullptr;
+    bool m_waiting_writable = false;
+    bool m_canceled = false;
+
+    WaitWritableCallback m_wait_writable_callback = nullptr;
+    EndSendCallback m_end_send_callback = nullptr;
+};
+
+} // namespace detail
+} // namespace io
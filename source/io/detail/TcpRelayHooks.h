@@ -0,0 +1,22 @@
+#pragma once
+
+#include "io/DataChunk.h"
+#include "io/Error.h"
+
+namespace io {
+namespace detail {
+
+// Receiver of events of the relayed connection, see TcpRelay
+class TcpRelayHooks {
+public:
+    virtual ~TcpRelayHooks() = default;
+
+    // Received data or error (END_OF_FILE when peer finished sending). In zero copy mode data is
+    // left in the socket and empty chunk only means that socket is readable.
+    virtual void on_relay_read(const DataChunk& chunk, const Error& error) = 0;
+
+    virtual void on_relay_connection_destroyed() = 0;
+};
+
+} // namespace detail
+} // namespace io
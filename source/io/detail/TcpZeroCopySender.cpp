@@ -0,0 +1,375 @@
+#include "TcpZeroCopySender.h"
+
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include <assert.h>
+
+#if defined(__linux__)
+    #include <cerrno>
+    #include <linux/errqueue.h>
+    #include <netinet/in.h>
+    #include <sys/socket.h>
+    #include <unistd.h>
+#endif
+
+namespace io {
+namespace detail {
+
+// Completed by kernel notification and by the write of the rest of data if it was needed
+struct TcpZeroCopySender::Send {
+    std::shared_ptr<const char> buf;
+    std::uint32_t id = 0;
+    std::size_t pending_parts = 1;
+    Error error = Error(0);
+    EndSendCallback end_send_callback;
+};
+
+struct TcpZeroCopySender::RestWriteRequest : public uv_write_t {
+    uv_buf_t uv_buf;
+    std::shared_ptr<Send> send;
+};
+
+// Owns itself, deleted when all buffers are released
+struct TcpZeroCopySender::BuffersHolder : public uv_timer_t {
+    int socket_handle = -1;
+    std::uint64_t deadline_ms = 0;
+    std::deque<std::pair<std::uint32_t, std::shared_ptr<const char>>> buffers;
+};
+
+namespace {
+
+#if defined(__linux__)
+
+// Calls callback for each range of completed sends [first_id, last_id] reported via socket error queue
+template<typename CallbackType>
+void read_completions(int socket_handle, CallbackType callback) {
+    for (;;) {
+        char control[CMSG_SPACE(sizeof(::sock_extended_err)) + CMSG_SPACE(sizeof(::sockaddr_in6))];
+        ::msghdr message;
+        std::memset(&message, 0, sizeof(message));
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+
+        if (::recvmsg(socket_handle, &message, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+
+        for (auto cmsg = CMSG_FIRSTHDR(&message); cmsg != nullptr; cmsg = CMSG_NXTHDR(&message, cmsg)) {
+            const bool is_error_message = (cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) ||
+                                          (cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR);
+            if (!is_error_message) {
+                continue;
+            }
+
+            ::sock_extended_err extended_error;
+            std::memcpy(&extended_error, CMSG_DATA(cmsg), sizeof(extended_error));
+            if (extended_error.ee_origin != SO_EE_ORIGIN_ZEROCOPY || extended_error.ee_errno != 0) {
+                continue;
+            }
+
+            callback(extended_error.ee_info, extended_error.ee_data);
+        }
+    }
+}
+
+#endif
+
+// Numbers of sends may wrap around
+bool is_in_range(std::uint32_t id, std::uint32_t first_id, std::uint32_t last_id) {
+    return id - first_id <= last_id - first_id;
+}
+
+} // namespace
+
+TcpZeroCopySender::TcpZeroCopySender(uv_loop_t* loop) :
+    m_loop(loop) {
+}
+
+TcpZeroCopySender::~TcpZeroCopySender() {
+    if (m_timer) {
+        m_timer->data = nullptr;
+        uv_close(reinterpret_cast<uv_handle_t*>(m_timer), on_timer_close);
+    }
+}
+
+bool TcpZeroCopySender::is_supported() {
+#if defined(__linux__)
+    return true;
+#else
+    return false;
+#endif
+}
+
+std::size_t TcpZeroCopySender::sends_count() const {
+    return m_sends_count;
+}
+
+bool TcpZeroCopySender::send(uv_tcp_t* tcp_stream,
+                             const std::shared_ptr<const char>& buffer,
+                             std::uint32_t size,
+                             EndSendCallback callback) {
+#if defined(__linux__)
+    if (m_socket_failed || buffer == nullptr || size == 0) {
+        return false;
+    }
+
+    assert(m_tcp_stream == nullptr || m_tcp_stream == tcp_stream);
+
+    uv_os_fd_t handle = -1;
+    if (uv_fileno(reinterpret_cast<const uv_handle_t*>(tcp_stream), &handle) != 0) {
+        return false;
+    }
+
+    if (!m_socket_enabled) {
+        const int enabled = 1;
+        if (::setsockopt(handle, SOL_SOCKET, SO_ZEROCOPY, &enabled, sizeof(enabled)) != 0) {
+            m_socket_failed = true;
+            return false;
+        }
+
+        m_socket_enabled = true;
+    }
+
+    // Completions could not be received without polling, so timer is created before anything is sent
+    if (m_timer == nullptr) {
+        m_timer = new uv_timer_t;
+        const Error init_error = uv_timer_init(m_loop, m_timer);
+        if (init_error) {
+            delete m_timer;
+            m_timer = nullptr;
+            return false;
+        }
+        m_timer->data = this;
+    }
+
+    ssize_t sent_size = -1;
+    do {
+        sent_size = ::send(handle, buffer.get(), size, MSG_ZEROCOPY | MSG_DONTWAIT | MSG_NOSIGNAL);
+    } while (sent_size < 0 && errno == EINTR);
+
+    // Socket is full or kernel has no memory for zero copy (ENOBUFS), errors are reported by regular write
+    if (sent_size <= 0) {
+        return false;
+    }
+
+    m_tcp_stream = tcp_stream;
+
+    auto send = std::make_shared<Send>();
+    send->buf = buffer;
+    send->id = m_next_id++;
+    send->end_send_callback = callback;
+    m_sends.push_back(send);
+    ++m_sends_count;
+
+    if (static_cast<std::size_t>(sent_size) < size) {
+        auto req = new RestWriteRequest;
+        req->data = this;
+        req->send = send;
+        // const_cast is a workaround for lack of constness support in uv_buf_t
+        req->uv_buf = uv_buf_init(const_cast<char*>(buffer.get()) + sent_size, size - static_cast<std::uint32_t>(sent_size));
+
+        const Error write_error = uv_write(req, reinterpret_cast<uv_stream_t*>(tcp_stream), &req->uv_buf, 1, after_rest_write);
+        if (write_error) {
+            send->error = write_error;
+            delete req;
+        } else {
+            ++send->pending_parts;
+        }
+    }
+
+    if (!uv_is_active(reinterpret_cast<uv_handle_t*>(m_timer))) {
+        uv_timer_start(m_timer, on_timer, POLL_INTERVAL_MS, POLL_INTERVAL_MS);
+    }
+
+    return true;
+#else
+    (void)tcp_stream;
+    (void)buffer;
+    (void)size;
+    (void)callback;
+    return false;
+#endif
+}
+
+void TcpZeroCopySender::process_completions() {
+#if defined(__linux__)
+    if (m_sends.empty()) {
+        return;
+    }
+
+    uv_os_fd_t handle = -1;
+    if (m_tcp_stream == nullptr || uv_fileno(reinterpret_cast<const uv_handle_t*>(m_tcp_stream), &handle) != 0) {
+        return;
+    }
+
+    std::vector<std::shared_ptr<Send>> completed_sends;
+
+    read_completions(handle, [this, &completed_sends](std::uint32_t first_id, std::uint32_t last_id) {
+        for (auto it = m_sends.begin(); it != m_sends.end();) {
+            if (is_in_range((*it)->id, first_id, last_id)) {
+                completed_sends.push_back(std::move(*it));
+                it = m_sends.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    });
+
+    if (m_sends.empty() && m_timer) {
+        uv_timer_stop(m_timer);
+    }
+
+    // Callbacks are called after the queue is updated, because they may send more data or close connection
+    for (auto& send : completed_sends) {
+        complete_send_part(*send, Error(0));
+    }
+#endif
+}
+
+void TcpZeroCopySender::close() {
+    process_completions();
+
+    if (m_timer) {
+        uv_timer_stop(m_timer);
+    }
+
+    uv_os_fd_t handle = -1;
+    if (!m_sends.empty() && uv_fileno(reinterpret_cast<const uv_handle_t*>(m_tcp_stream), &handle) == 0) {
+        hold_buffers(handle);
+    }
+
+    m_tcp_stream = nullptr;
+    m_socket_enabled = false;
+    m_socket_failed = false;
+    m_next_id = 0;
+
+    // Data was accepted by kernel, as for the regular writes which are completed before it is delivered
+    std::deque<std::shared_ptr<Send>> sends;
+    sends.swap(m_sends);
+    for (auto& send : sends) {
+        complete_send_part(*send, Error(0));
+    }
+}
+
+void TcpZeroCopySender::hold_buffers(int socket_handle) {
+#if defined(__linux__)
+    // If notifications could not be awaited, connection is reset when the socket is closed,
+    // so kernel releases the buffers right away
+    const ::linger reset_on_close = {1, 0};
+
+    std::unique_ptr<BuffersHolder> holder(new BuffersHolder);
+
+    holder->socket_handle = ::dup(socket_handle);
+    if (holder->socket_handle == -1) {
+        ::setsockopt(socket_handle, SOL_SOCKET, SO_LINGER, &reset_on_close, sizeof(reset_on_close));
+        return;
+    }
+
+    const Error init_error = uv_timer_init(m_loop, holder.get());
+    if (init_error) {
+        ::close(holder->socket_handle);
+        ::setsockopt(socket_handle, SOL_SOCKET, SO_LINGER, &reset_on_close, sizeof(reset_on_close));
+        return;
+    }
+
+    // Duplicate keeps the connection open, so it is shut down as close would do
+    ::shutdown(holder->socket_handle, SHUT_RDWR);
+
+    for (auto& send : m_sends) {
+        holder->buffers.emplace_back(send->id, send->buf);
+    }
+
+    holder->deadline_ms = uv_now(m_loop) + CLOSE_TIMEOUT_MS;
+    uv_timer_start(holder.get(), on_holder_timer, POLL_INTERVAL_MS, POLL_INTERVAL_MS);
+    holder.release();
+#else
+    (void)socket_handle;
+#endif
+}
+
+void TcpZeroCopySender::complete_send_part(Send& send, const Error& error) {
+    if (error && !send.error) {
+        send.error = error;
+    }
+
+    assert(send.pending_parts >= 1);
+    if (--send.pending_parts) {
+        return;
+    }
+
+    // Buffer is released only when kernel does not need it anymore
+    send.buf.reset();
+
+    auto end_send_callback = std::move(send.end_send_callback);
+    send.end_send_callback = nullptr;
+    if (end_send_callback) {
+        end_send_callback(send.error);
+    }
+}
+
+////////////////////////////////////////////// static //////////////////////////////////////////////
+void TcpZeroCopySender::after_rest_write(uv_write_t* req, int uv_status) {
+    auto& this_ = *reinterpret_cast<TcpZeroCopySender*>(req->data);
+
+    std::unique_ptr<RestWriteRequest> guard(reinterpret_cast<RestWriteRequest*>(req));
+    this_.complete_send_part(*guard->send, Error(uv_status));
+}
+
+void TcpZeroCopySender::on_timer(uv_timer_t* handle) {
+    if (handle->data == nullptr) {
+        return;
+    }
+
+    auto& this_ = *reinterpret_cast<TcpZeroCopySender*>(handle->data);
+    this_.process_completions();
+}
+
+void TcpZeroCopySender::on_timer_close(uv_handle_t* handle) {
+    delete reinterpret_cast<uv_timer_t*>(handle);
+}
+
+void TcpZeroCopySender::on_holder_timer(uv_timer_t* handle) {
+#if defined(__linux__)
+    auto& holder = *reinterpret_cast<BuffersHolder*>(handle);
+
+    read_completions(holder.socket_handle, [&holder](std::uint32_t first_id, std::uint32_t last_id) {
+        for (auto it = holder.buffers.begin(); it != holder.buffers.end();) {
+            if (is_in_range(it->first, first_id, last_id)) {
+                it = holder.buffers.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    });
+
+    if (!holder.buffers.empty() && uv_now(handle->loop) < holder.deadline_ms) {
+        return;
+    }
+
+    if (!holder.buffers.empty()) {
+        // Reset drops not acknowledged data, so kernel releases the buffers
+        const ::linger linger_option = {1, 0};
+        ::setsockopt(holder.socket_handle, SOL_SOCKET, SO_LINGER, &linger_option, sizeof(linger_option));
+    }
+
+    ::close(holder.socket_handle);
+    holder.socket_handle = -1;
+
+    uv_timer_stop(handle);
+    uv_close(reinterpret_cast<uv_handle_t*>(handle), on_holder_close);
+#else
+    (void)handle;
+#endif
+}
+
+void TcpZeroCopySender::on_holder_close(uv_handle_t* handle) {
+    delete reinterpret_cast<BuffersHolder*>(handle);
+}
+
+} // namespace detail
+} // namespace io
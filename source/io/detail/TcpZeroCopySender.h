@@ -0,0 +1,87 @@
+#pragma once
+
+#include "io/CommonMacros.h"
+#include "io/Error.h"
+
+#include "Common.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+
+namespace io {
+namespace detail {
+
+// Sends buffers of TCP stream with MSG_ZEROCOPY. Kernel takes pages of the buffer instead of copying
+// them, so send is completed only when kernel reports via socket error queue that buffer is not used
+// anymore. Data which did not fit into the socket buffer is written by libuv. Notifications usually
+// arrive with socket events (owner calls process_completions()), but they are polled by timer too,
+// because reading could be paused. Supported on Linux only.
+class TcpZeroCopySender {
+public:
+    using EndSendCallback = std::function<void(const Error& error)>;
+
+    IO_FORBID_COPY(TcpZeroCopySender);
+    IO_FORBID_MOVE(TcpZeroCopySender);
+
+    TcpZeroCopySender(uv_loop_t* loop);
+    ~TcpZeroCopySender();
+
+    static bool is_supported();
+
+    // Returns false if nothing was sent and buffer should be sent by regular write.
+    // Owner should not have data queued in libuv, because zero copy send goes to the socket directly.
+    bool send(uv_tcp_t* tcp_stream, const std::shared_ptr<const char>& buffer, std::uint32_t size, EndSendCallback callback);
+
+    void process_completions();
+
+    // Called before the socket is closed. Data of not completed sends is already in the kernel, so they
+    // are completed successfully (except ones with the rest of data still queued in libuv, which are
+    // completed with error by libuv). But buffers are held until kernel releases them: socket is kept by
+    // a duplicate descriptor to receive notifications, if they do not arrive in CLOSE_TIMEOUT_MS
+    // connection is reset, after that kernel does not use the buffers. Loop does not exit until then.
+    // Next socket starts numbering of sends from the beginning.
+    void close();
+
+    std::size_t sends_count() const;
+
+protected:
+    struct Send;
+    struct RestWriteRequest;
+    struct BuffersHolder;
+
+    void hold_buffers(int socket_handle);
+
+    void complete_send_part(Send& send, const Error& error);
+
+    // statics
+    static void after_rest_write(uv_write_t* req, int status);
+    static void on_timer(uv_timer_t* handle);
+    static void on_timer_close(uv_handle_t* handle);
+    static void on_holder_timer(uv_timer_t* handle);
+    static void on_holder_close(uv_handle_t* handle);
+
+private:
+    // Notifications usually arrive with socket events, timer is needed when reading is paused
+    static const std::uint64_t POLL_INTERVAL_MS = 10;
+    static const std::uint64_t CLOSE_TIMEOUT_MS = 10000;
+
+    uv_loop_t* m_loop = nullptr;
+    // Stream of the last send, sender is bound to it until close
+    uv_tcp_t* m_tcp_stream = nullptr;
+
+    // SO_ZEROCOPY is enabled for the socket on the first send
+    bool m_socket_enabled = false;
+    bool m_socket_failed = false;
+    // Kernel numbers zero copy sends of the socket sequentially starting from 0
+    std::uint32_t m_next_id = 0;
+    std::deque<std::shared_ptr<Send>> m_sends;
+    std::size_t m_sends_count = 0;
+
+    uv_timer_t* m_timer = nullptr;
+};
+
+} // namespace detail
+} // namespace io
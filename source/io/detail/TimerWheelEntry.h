@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+
+namespace io {
+namespace detail {
+
+// Intrusive node of TimerWheel's slot list. Owned by a user of the wheel (Timer).
+struct TimerWheelEntry {
+    using Callback = void (*)(TimerWheelEntry& entry);
+
+    TimerWheelEntry* prev = nullptr;
+    TimerWheelEntry* next = nullptr;
+
+    std::uint64_t expiration_tick = 0;
+
+    Callback callback = nullptr;
+    void* data = nullptr;
+
+    bool is_linked() const {
+        return next != nullptr;
+    }
+
+    void unlink() {
+        prev->next = next;
+        next->prev = prev;
+        prev = nullptr;
+        next = nullptr;
+    }
+
+    // For list heads only
+    void make_empty_list() {
+        prev = this;
+        next = this;
+    }
+
+    bool is_empty_list() const {
+        return next == this;
+    }
+
+    void push_back(TimerWheelEntry& entry) {
+        entry.prev = prev;
+        entry.next = this;
+        prev->next = &entry;
+        prev = &entry;
+    }
+
+    // Moves all elements of this list to the empty list 'other'
+    void move_to(TimerWheelEntry& other) {
+        if (is_empty_list()) {
+            return;
+        }
+
+        other.next = next;
+        other.prev = prev;
+        next->prev = &other;
+        prev->next = &other;
+        make_empty_list();
+    }
+};
+
+} // namespace detail
+} // namespace io
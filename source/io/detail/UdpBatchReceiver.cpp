@@ -0,0 +1,249 @@
+#include "UdpBatchReceiver.h"
+
+#include <assert.h>
+
+#if defined(__linux__)
+    #include <cerrno>
+    #include <sys/socket.h>
+    #include <unistd.h>
+#endif
+
+namespace io {
+namespace detail {
+
+#if defined(__linux__)
+
+struct UdpBatchReceiver::Slots {
+    std::vector<::mmsghdr> headers;
+    std::vector<::iovec> iovecs;
+    std::vector<::sockaddr_storage> addresses;
+};
+
+#else
+
+struct UdpBatchReceiver::Slots {
+};
+
+#endif
+
+UdpBatchReceiver::UdpBatchReceiver(ReceiveBufferPool& buffer_pool) :
+    m_buffer_pool(&buffer_pool),
+    m_slots(new Slots) {
+}
+
+UdpBatchReceiver::~UdpBatchReceiver() {
+    stop();
+}
+
+bool UdpBatchReceiver::is_supported() {
+#if defined(__linux__)
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool UdpBatchReceiver::is_active() const {
+    return m_poll_handle != nullptr;
+}
+
+Error UdpBatchReceiver::start(uv_udp_t* udp_handle,
+                              std::size_t batch_size,
+                              ReceiveCallback receive_callback,
+                              ErrorCallback error_callback) {
+#if defined(__linux__)
+    if (batch_size == 0 || batch_size > MAX_BATCH_SIZE) {
+        return Error(StatusCode::INVALID_ARGUMENT);
+    }
+
+    if (is_active()) {
+        return Error(StatusCode::CONNECTION_ALREADY_IN_PROGRESS);
+    }
+
+    uv_os_fd_t fd = -1;
+    const Error fileno_error = uv_fileno(reinterpret_cast<uv_handle_t*>(udp_handle), &fd);
+    if (fileno_error) {
+        return fileno_error;
+    }
+
+    // libuv does not allow to have 2 handles for the same descriptor
+    m_fd = ::dup(fd);
+    if (m_fd == -1) {
+        return Error(-errno);
+    }
+
+    m_poll_handle = new uv_poll_t;
+    const Error init_error = uv_poll_init(udp_handle->loop, m_poll_handle, m_fd);
+    if (init_error) {
+        delete m_poll_handle;
+        m_poll_handle = nullptr;
+        ::close(m_fd);
+        m_fd = -1;
+        return init_error;
+    }
+
+    m_poll_handle->data = this;
+    m_receive_callback = receive_callback;
+    m_error_callback = error_callback;
+
+    m_slots->headers.resize(batch_size);
+    m_slots->iovecs.resize(batch_size);
+    m_slots->addresses.resize(batch_size);
+    m_buffers.resize(batch_size);
+    m_datagrams.resize(batch_size);
+
+    const Error start_error = uv_poll_start(m_poll_handle, UV_READABLE, on_poll);
+    if (start_error) {
+        stop();
+        return start_error;
+    }
+
+    return Error(0);
+#else
+    return Error(StatusCode::FUNCTION_NOT_IMPLEMENTED);
+#endif
+}
+
+void UdpBatchReceiver::stop() {
+#if defined(__linux__)
+    if (!is_active()) {
+        return;
+    }
+
+    // Closing handle stops polling immediately, so descriptor could be closed right away
+    m_poll_handle->data = nullptr;
+    uv_close(reinterpret_cast<uv_handle_t*>(m_poll_handle), on_poll_close);
+    m_poll_handle = nullptr;
+
+    ::close(m_fd);
+    m_fd = -1;
+#endif
+}
+
+std::size_t UdpBatchReceiver::prepare_slots() {
+#if defined(__linux__)
+    const std::size_t buffer_size = m_buffer_pool->buffer_size();
+    if (buffer_size != m_buffers_size) {
+        // Pool buffers size was changed, all buffers held by the slots are obsolete
+        for (auto& buffer : m_buffers) {
+            buffer.reset();
+        }
+        m_buffers_size = buffer_size;
+    }
+
+    for (std::size_t i = 0; i < m_buffers.size(); ++i) {
+        // Only slots which were consumed by the previous batch need new buffers
+        if (!m_buffers[i]) {
+            m_buffers[i] = m_buffer_pool->acquire();
+            if (!m_buffers[i]) {
+                return i;
+            }
+        }
+
+        auto& iovec = m_slots->iovecs[i];
+        iovec.iov_base = m_buffers[i].get();
+        iovec.iov_len = m_buffers_size;
+
+        auto& header = m_slots->headers[i].msg_hdr;
+        header.msg_name = &m_slots->addresses[i];
+        header.msg_namelen = sizeof(::sockaddr_storage);
+        header.msg_iov = &iovec;
+        header.msg_iovlen = 1;
+        header.msg_control = nullptr;
+        header.msg_controllen = 0;
+        header.msg_flags = 0;
+        m_slots->headers[i].msg_len = 0;
+    }
+
+    return m_buffers.size();
+#else
+    return 0;
+#endif
+}
+
+void UdpBatchReceiver::receive() {
+#if defined(__linux__)
+    // Limiting amount of work per loop iteration, similar to what libuv does for a single datagrams
+    for (std::size_t iterations_left = 32; iterations_left > 0 && is_active(); --iterations_left) {
+        const std::size_t slots_count = prepare_slots();
+        if (slots_count == 0) {
+            if (m_error_callback) {
+                m_error_callback(Error(StatusCode::NO_BUFFER_SPACE_AVAILABLE));
+            }
+            return;
+        }
+
+        int received_count = 0;
+        do {
+            received_count = ::recvmmsg(m_fd,
+                                        m_slots->headers.data(),
+                                        static_cast<unsigned int>(slots_count),
+                                        0,
+                                        nullptr);
+        } while (received_count == -1 && errno == EINTR);
+
+        if (received_count == -1) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && m_error_callback) {
+                m_error_callback(Error(-errno));
+            }
+            return;
+        }
+
+        const std::size_t received_slots_count = static_cast<std::size_t>(received_count);
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < received_slots_count; ++i) {
+            // Empty datagrams are dropped as in uv_udp_recv_start path, buffer of the slot is reused
+            if (m_slots->headers[i].msg_len == 0) {
+                continue;
+            }
+
+            auto& datagram = m_datagrams[count++];
+            datagram.address = reinterpret_cast<const ::sockaddr*>(&m_slots->addresses[i]);
+            datagram.buf = std::move(m_buffers[i]);
+            datagram.size = m_slots->headers[i].msg_len;
+        }
+
+        if (count && m_receive_callback) {
+            m_receive_callback(m_datagrams.data(), count);
+        }
+
+        // Releasing references, so buffers not retained by user could be reused by the pool
+        for (std::size_t i = 0; i < count; ++i) {
+            m_datagrams[i].buf.reset();
+        }
+
+        if (received_slots_count < slots_count) {
+            // Socket is drained
+            return;
+        }
+    }
+#endif
+}
+
+///////////////////////////////////////////  static  ////////////////////////////////////////////
+
+void UdpBatchReceiver::on_poll(uv_poll_t* handle, int status, int events) {
+    if (handle->data == nullptr) {
+        return;
+    }
+
+    auto& this_ = *reinterpret_cast<UdpBatchReceiver*>(handle->data);
+
+    if (status < 0) {
+        if (this_.m_error_callback) {
+            this_.m_error_callback(Error(status));
+        }
+        return;
+    }
+
+    if (events & UV_READABLE) {
+        this_.receive();
+    }
+}
+
+void UdpBatchReceiver::on_poll_close(uv_handle_t* handle) {
+    delete reinterpret_cast<uv_poll_t*>(handle);
+}
+
+} // namespace detail
+} // namespace io
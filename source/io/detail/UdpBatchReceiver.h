@@ -0,0 +1,78 @@
+#pragma once
+
+#include "io/CommonMacros.h"
+#include "io/Error.h"
+
+#include "Common.h"
+#include "ReceiveBufferPool.h"
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace io {
+namespace detail {
+
+// Receives up to batch size datagrams per system call (recvmmsg) instead of one recvmsg per datagram
+// which is done by uv_udp_recv_start. Socket of UDP handle is polled via duplicated descriptor, so libuv
+// may still use the original one for sending. Buffers are taken from the pool, one per datagram.
+// Supported on Linux only, on other platforms owner should fall back to uv_udp_recv_start.
+class UdpBatchReceiver {
+public:
+    static const std::size_t MAX_BATCH_SIZE = 1024;
+
+    struct Datagram {
+        const ::sockaddr* address = nullptr;
+        std::shared_ptr<const char> buf;
+        std::size_t size = 0;
+    };
+
+    // Datagrams are valid until callback returns, buffers could be retained by copying
+    using ReceiveCallback = std::function<void(Datagram* datagrams, std::size_t count)>;
+    using ErrorCallback = std::function<void(const Error&)>;
+
+    IO_FORBID_COPY(UdpBatchReceiver);
+    IO_FORBID_MOVE(UdpBatchReceiver);
+
+    UdpBatchReceiver(ReceiveBufferPool& buffer_pool);
+    ~UdpBatchReceiver();
+
+    static bool is_supported();
+
+    Error start(uv_udp_t* udp_handle, std::size_t batch_size, ReceiveCallback receive_callback, ErrorCallback error_callback);
+    void stop();
+
+    bool is_active() const;
+
+protected:
+    void receive();
+    // Returns number of slots which have buffers, it could be less than batch size
+    // if buffers allocator has no memory
+    std::size_t prepare_slots();
+
+    // statics
+    static void on_poll(uv_poll_t* handle, int status, int events);
+    static void on_poll_close(uv_handle_t* handle);
+
+private:
+    ReceiveBufferPool* m_buffer_pool = nullptr;
+
+    uv_poll_t* m_poll_handle = nullptr;
+    int m_fd = -1;
+
+    ReceiveCallback m_receive_callback = nullptr;
+    ErrorCallback m_error_callback = nullptr;
+
+    // Platform-specific message headers
+    struct Slots;
+    std::unique_ptr<Slots> m_slots;
+
+    std::vector<std::shared_ptr<char>> m_buffers;
+    std::size_t m_buffers_size = 0;
+
+    std::vector<Datagram> m_datagrams;
+};
+
+} // namespace detail
+} // namespace io
@@ -0,0 +1,313 @@
+#include "UdpBatchSender.h"
+
+#include <cstring>
+#include <assert.h>
+
+#if defined(__linux__)
+    #include <cerrno>
+    #include <sys/socket.h>
+#endif
+
+namespace io {
+namespace detail {
+
+#if defined(__linux__)
+
+struct UdpBatchSender::Headers {
+    std::vector<::mmsghdr> headers;
+    std::vector<::iovec> iovecs;
+    // Positions of entries which are currently being sent
+    std::vector<std::size_t> indexes;
+};
+
+#else
+
+struct UdpBatchSender::Headers {
+};
+
+#endif
+
+namespace {
+
+::socklen_t address_length(const ::sockaddr_storage& address) {
+    switch (address.ss_family) {
+        case AF_INET:
+            return sizeof(::sockaddr_in);
+        case AF_INET6:
+            return sizeof(::sockaddr_in6);
+        default:
+            return 0;
+    }
+}
+
+} // namespace
+
+UdpBatchSender::UdpBatchSender(uv_loop_t* loop, uv_udp_t* udp_handle) :
+    m_uv_loop(loop),
+    m_udp_handle(udp_handle),
+    m_headers(new Headers) {
+}
+
+UdpBatchSender::~UdpBatchSender() {
+    if (m_prepare_handle) {
+        m_prepare_handle->data = nullptr;
+        uv_close(reinterpret_cast<uv_handle_t*>(m_prepare_handle), on_prepare_close);
+    }
+}
+
+void UdpBatchSender::enqueue(const std::shared_ptr<Batch>& batch,
+                             std::size_t index,
+                             const ::sockaddr* address,
+                             std::shared_ptr<const char> buf,
+                             std::uint32_t size) {
+    if (m_prepare_handle == nullptr) {
+        auto prepare_handle = new uv_prepare_t;
+        const Error init_error = uv_prepare_init(m_uv_loop, prepare_handle);
+        if (init_error) {
+            delete prepare_handle;
+        } else {
+            prepare_handle->data = this;
+            m_prepare_handle = prepare_handle;
+        }
+    }
+
+    ++batch->pending_count;
+
+    Entry entry;
+    std::memset(&entry.address, 0, sizeof(entry.address));
+    if (address) {
+        if (address->sa_family == AF_INET) {
+            std::memcpy(&entry.address, address, sizeof(::sockaddr_in));
+        } else if (address->sa_family == AF_INET6) {
+            std::memcpy(&entry.address, address, sizeof(::sockaddr_in6));
+        }
+    }
+    entry.buf = std::move(buf);
+    entry.size = size;
+    entry.batch = batch;
+    entry.index = index;
+
+    if (m_prepare_handle) {
+        if (m_queue.empty()) {
+            uv_prepare_start(m_prepare_handle, on_prepare);
+        }
+
+        m_queue.push_back(std::move(entry));
+        return;
+    }
+
+    // Datagram could not wait for the flush, so it is handed to libuv one by one, next datagram makes
+    // one more attempt to create the handle
+    if (uv_is_closing(reinterpret_cast<uv_handle_t*>(m_udp_handle))) {
+        entry.status = Error(StatusCode::OPERATION_CANCELED);
+    } else if (size == 0 || address_length(entry.address) == 0) {
+        entry.status = Error(StatusCode::INVALID_ARGUMENT);
+    } else {
+        send_via_libuv(entry);
+    }
+
+    if (entry.batch) {
+        complete(*entry.batch, entry.index, entry.status);
+    }
+}
+
+void UdpBatchSender::cancel() {
+    if (m_prepare_handle) {
+        uv_prepare_stop(m_prepare_handle);
+    }
+
+    std::vector<Entry> entries;
+    entries.swap(m_queue);
+
+    for (auto& entry : entries) {
+        complete(*entry.batch, entry.index, Error(StatusCode::OPERATION_CANCELED));
+    }
+}
+
+std::size_t UdpBatchSender::queued_count() const {
+    return m_queue.size();
+}
+
+void UdpBatchSender::flush() {
+    uv_prepare_stop(m_prepare_handle);
+
+    assert(m_flushing.empty());
+    m_flushing.swap(m_queue);
+
+    if (uv_is_closing(reinterpret_cast<uv_handle_t*>(m_udp_handle))) {
+        for (auto& entry : m_flushing) {
+            entry.status = Error(StatusCode::OPERATION_CANCELED);
+        }
+    } else {
+        for (auto& entry : m_flushing) {
+            if (entry.size == 0 || address_length(entry.address) == 0) {
+                entry.status = Error(StatusCode::INVALID_ARGUMENT);
+            }
+        }
+
+        // Datagrams which were not sent here are handed to libuv, it waits for socket to become writable
+        const std::size_t not_sent_index = send_immediately();
+        for (std::size_t i = not_sent_index; i < m_flushing.size(); ++i) {
+            if (!m_flushing[i].status) {
+                send_via_libuv(m_flushing[i]);
+            }
+        }
+    }
+
+    // Callbacks are called after all sends are done, because they may close the handle or enqueue new datagrams
+    for (auto& entry : m_flushing) {
+        // Batch was moved to the libuv request if datagram is sent by libuv
+        if (entry.batch) {
+            complete(*entry.batch, entry.index, entry.status);
+        }
+    }
+
+    m_flushing.clear();
+}
+
+// Returns index of the first entry which was not sent
+std::size_t UdpBatchSender::send_immediately() {
+#if defined(__linux__)
+    // Sending directly only if libuv has no own queued datagrams, to preserve the order of sending
+    if (m_udp_handle->send_queue_count) {
+        return 0;
+    }
+
+    uv_os_fd_t fd = -1;
+    if (uv_fileno(reinterpret_cast<uv_handle_t*>(m_udp_handle), &fd) != 0) {
+        return 0;
+    }
+
+    auto& headers = m_headers->headers;
+    auto& iovecs = m_headers->iovecs;
+    auto& indexes = m_headers->indexes;
+
+    std::size_t next = 0;
+    while (next < m_flushing.size()) {
+        headers.clear();
+        iovecs.clear();
+        indexes.clear();
+
+        std::size_t end = next;
+        for (; end < m_flushing.size() && indexes.size() < MAX_BATCH_SIZE; ++end) {
+            auto& entry = m_flushing[end];
+            if (entry.status) {
+                continue;
+            }
+
+            ::iovec iovec;
+            // const_cast is a workaround for lack of constness support in iovec
+            iovec.iov_base = const_cast<char*>(entry.buf.get());
+            iovec.iov_len = entry.size;
+            iovecs.push_back(iovec);
+            indexes.push_back(end);
+        }
+
+        if (indexes.empty()) {
+            return m_flushing.size();
+        }
+
+        headers.resize(indexes.size());
+        for (std::size_t i = 0; i < indexes.size(); ++i) {
+            auto& entry = m_flushing[indexes[i]];
+            auto& header = headers[i].msg_hdr;
+            std::memset(&headers[i], 0, sizeof(::mmsghdr));
+            header.msg_name = &entry.address;
+            header.msg_namelen = address_length(entry.address);
+            header.msg_iov = &iovecs[i];
+            header.msg_iovlen = 1;
+        }
+
+        const int sent_count = ::sendmmsg(fd, headers.data(), static_cast<unsigned int>(headers.size()), 0);
+        if (sent_count == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS) {
+                return indexes.front();
+            }
+
+            // Error is related to the first datagram, the rest could be sent
+            m_flushing[indexes.front()].status = Error(-errno);
+            next = indexes.front() + 1;
+            continue;
+        }
+
+        if (sent_count == 0) {
+            return indexes.front();
+        }
+
+        if (static_cast<std::size_t>(sent_count) < indexes.size()) {
+            next = indexes[sent_count];
+        } else {
+            next = end;
+        }
+    }
+
+    return m_flushing.size();
+#else
+    return 0;
+#endif
+}
+
+void UdpBatchSender::send_via_libuv(Entry& entry) {
+    auto req = new SendRequest;
+    req->buf = std::move(entry.buf);
+    req->batch = std::move(entry.batch);
+    req->index = entry.index;
+    // const_cast is a workaround for lack of constness support in uv_buf_t
+    req->uv_buf = uv_buf_init(const_cast<char*>(req->buf.get()), entry.size);
+
+    const int uv_status = uv_udp_send(req,
+                                      m_udp_handle,
+                                      &req->uv_buf,
+                                      1,
+                                      reinterpret_cast<const ::sockaddr*>(&entry.address),
+                                      on_send);
+    if (uv_status < 0) {
+        // Completing later with the other entries
+        entry.batch = std::move(req->batch);
+        entry.status = Error(uv_status);
+        delete req;
+    }
+}
+
+void UdpBatchSender::complete(Batch& batch, std::size_t index, const Error& error) {
+    if (error && !batch.error) {
+        batch.error = error;
+    }
+
+    if (batch.on_datagram_sent) {
+        batch.on_datagram_sent(index, error);
+    }
+
+    assert(batch.pending_count);
+    if (--batch.pending_count == 0 && batch.on_batch_sent) {
+        batch.on_batch_sent(batch.error);
+    }
+}
+
+///////////////////////////////////////////  static  ////////////////////////////////////////////
+
+void UdpBatchSender::on_prepare(uv_prepare_t* handle) {
+    if (handle->data == nullptr) {
+        return;
+    }
+
+    auto& this_ = *reinterpret_cast<UdpBatchSender*>(handle->data);
+    this_.flush();
+}
+
+void UdpBatchSender::on_prepare_close(uv_handle_t* handle) {
+    delete reinterpret_cast<uv_prepare_t*>(handle);
+}
+
+void UdpBatchSender::on_send(uv_udp_send_t* req, int status) {
+    auto& request = *reinterpret_cast<SendRequest*>(req);
+    complete(*request.batch, request.index, Error(status));
+    delete &request;
+}
+
+} // namespace detail
+} // namespace io
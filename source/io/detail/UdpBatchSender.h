@@ -0,0 +1,101 @@
+#pragma once
+
+#include "io/CommonMacros.h"
+#include "io/Error.h"
+
+#include "Common.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace io {
+namespace detail {
+
+// Queues datagrams during loop iteration and sends all of them right before the loop blocks for I/O.
+// On Linux queued datagrams are sent by sendmmsg, many datagrams per system call. Datagrams which
+// could not be sent immediately (socket buffer is full) and all datagrams on other platforms are sent
+// via uv_udp_send. Completion callbacks are called from the loop, never from enqueue().
+class UdpBatchSender {
+public:
+    static const std::size_t MAX_BATCH_SIZE = 1024;
+
+    // Group of datagrams with shared completion handlers. Index is a position of datagram in the group.
+    struct Batch {
+        using DatagramSentCallback = std::function<void(std::size_t index, const Error& error)>;
+        using BatchSentCallback = std::function<void(const Error& error)>;
+
+        DatagramSentCallback on_datagram_sent = nullptr;
+        // Receives the first error of the datagrams if any
+        BatchSentCallback on_batch_sent = nullptr;
+
+        std::size_t pending_count = 0;
+        Error error = Error(0);
+    };
+
+    IO_FORBID_COPY(UdpBatchSender);
+    IO_FORBID_MOVE(UdpBatchSender);
+
+    // Handle should be inited (socket created) before the first datagram is enqueued
+    UdpBatchSender(uv_loop_t* loop, uv_udp_t* udp_handle);
+    ~UdpBatchSender();
+
+    void enqueue(const std::shared_ptr<Batch>& batch,
+                 std::size_t index,
+                 const ::sockaddr* address,
+                 std::shared_ptr<const char> buf,
+                 std::uint32_t size);
+
+    // Completes queued datagrams with OPERATION_CANCELED, should be called when UDP handle is closed
+    void cancel();
+
+    std::size_t queued_count() const;
+
+protected:
+    struct Entry {
+        ::sockaddr_storage address;
+        std::shared_ptr<const char> buf;
+        std::uint32_t size = 0;
+
+        std::shared_ptr<Batch> batch;
+        std::size_t index = 0;
+
+        Error status = Error(0);
+    };
+
+    struct SendRequest : public uv_udp_send_t {
+        uv_buf_t uv_buf;
+        std::shared_ptr<const char> buf;
+        std::shared_ptr<Batch> batch;
+        std::size_t index = 0;
+    };
+
+    void flush();
+    std::size_t send_immediately();
+    void send_via_libuv(Entry& entry);
+
+    static void complete(Batch& batch, std::size_t index, const Error& error);
+
+    // statics
+    static void on_prepare(uv_prepare_t* handle);
+    static void on_prepare_close(uv_handle_t* handle);
+    static void on_send(uv_udp_send_t* req, int status);
+
+private:
+    uv_loop_t* m_uv_loop = nullptr;
+    uv_udp_t* m_udp_handle = nullptr;
+    uv_prepare_t* m_prepare_handle = nullptr;
+
+    std::vector<Entry> m_queue;
+    // Entries which are being sent, m_queue accepts new ones from completion callbacks meanwhile
+    std::vector<Entry> m_flushing;
+
+    // Platform-specific message headers
+    struct Headers;
+    std::unique_ptr<Headers> m_headers;
+};
+
+} // namespace detail
+} // namespace io
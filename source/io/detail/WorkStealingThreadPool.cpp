@@ -0,0 +1,133 @@
+#include "WorkStealingThreadPool.h"
+
+namespace io {
+namespace detail {
+
+namespace {
+
+// Identifies worker on its own thread to place nested tasks into the local deque
+thread_local const WorkStealingThreadPool* current_pool = nullptr;
+thread_local std::size_t current_worker_index = 0;
+
+} // namespace
+
+WorkStealingThreadPool::WorkStealingThreadPool(std::size_t threads_count) :
+    m_next_worker(0),
+    m_queued_tasks_count(0) {
+    if (threads_count == 0) {
+        threads_count = std::thread::hardware_concurrency();
+    }
+
+    if (threads_count == 0) {
+        threads_count = 1;
+    }
+
+    m_workers.reserve(threads_count);
+    for (std::size_t i = 0; i < threads_count; ++i) {
+        m_workers.emplace_back(new Worker);
+    }
+
+    m_threads.reserve(threads_count);
+    for (std::size_t i = 0; i < threads_count; ++i) {
+        m_threads.emplace_back(&WorkStealingThreadPool::worker_loop, this, i);
+    }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+    {
+        std::lock_guard<std::mutex> guard(m_sleep_mutex);
+        m_stop = true;
+    }
+    m_sleep_condition.notify_all();
+
+    for (auto& thread : m_threads) {
+        thread.join();
+    }
+}
+
+std::size_t WorkStealingThreadPool::threads_count() const {
+    return m_workers.size();
+}
+
+void WorkStealingThreadPool::submit(Task task) {
+    if (task == nullptr) {
+        return;
+    }
+
+    const std::size_t index = current_pool == this ?
+                              current_worker_index :
+                              m_next_worker.fetch_add(1, std::memory_order_relaxed) % m_workers.size();
+
+    // Counter is incremented before the task is pushed, so a worker which takes the task right away
+    // could not decrement it below zero. It is modified under the lock to not miss wake up of the worker
+    // which is going to sleep.
+    {
+        std::lock_guard<std::mutex> guard(m_sleep_mutex);
+        ++m_queued_tasks_count;
+    }
+
+    {
+        auto& worker = *m_workers[index];
+        std::lock_guard<std::mutex> guard(worker.mutex);
+        worker.tasks.push_back(std::move(task));
+    }
+
+    m_sleep_condition.notify_one();
+}
+
+bool WorkStealingThreadPool::pop_own_task(std::size_t index, Task& task) {
+    auto& worker = *m_workers[index];
+    std::lock_guard<std::mutex> guard(worker.mutex);
+    if (worker.tasks.empty()) {
+        return false;
+    }
+
+    task = std::move(worker.tasks.back());
+    worker.tasks.pop_back();
+    return true;
+}
+
+bool WorkStealingThreadPool::steal_task(std::size_t index, Task& task) {
+    for (std::size_t i = 1; i < m_workers.size(); ++i) {
+        auto& victim = *m_workers[(index + i) % m_workers.size()];
+        std::lock_guard<std::mutex> guard(victim.mutex);
+        if (victim.tasks.empty()) {
+            continue;
+        }
+
+        task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        return true;
+    }
+
+    return false;
+}
+
+void WorkStealingThreadPool::worker_loop(std::size_t index) {
+    current_pool = this;
+    current_worker_index = index;
+
+    Task task;
+    while (true) {
+        if (pop_own_task(index, task) || steal_task(index, task)) {
+            --m_queued_tasks_count;
+            task();
+            task = nullptr;
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_sleep_mutex);
+        if (m_stop && m_queued_tasks_count == 0) {
+            break;
+        }
+
+        m_sleep_condition.wait(lock, [this]() {
+            return m_stop || m_queued_tasks_count != 0;
+        });
+    }
+
+    current_pool = nullptr;
+}
+
+} // namespace detail
+} // namespace io
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "io/CommonMacros.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace io {
+namespace detail {
+
+// Thread pool where each worker owns a deque of tasks. Worker takes tasks from the back of its own
+// deque (most recent first) and when it runs out of them, steals from the front of other workers' deques.
+// Tasks submitted from outside of the pool are distributed between workers in round robin manner,
+// tasks submitted from the worker thread are placed into that worker's deque.
+// On destruction all already submitted tasks are executed before threads are joined.
+class WorkStealingThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    IO_FORBID_COPY(WorkStealingThreadPool);
+    IO_FORBID_MOVE(WorkStealingThreadPool);
+
+    // 0 means number of hardware threads
+    explicit WorkStealingThreadPool(std::size_t threads_count);
+    ~WorkStealingThreadPool();
+
+    // Note: this method is thread safe
+    void submit(Task task);
+
+    std::size_t threads_count() const;
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void worker_loop(std::size_t index);
+    bool pop_own_task(std::size_t index, Task& task);
+    bool steal_task(std::size_t index, Task& task);
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::vector<std::thread> m_threads;
+
+    std::atomic<std::size_t> m_next_worker;
+
+    // Number of tasks which were submitted but not taken by any worker yet
+    std::atomic<std::size_t> m_queued_tasks_count;
+
+    std::mutex m_sleep_mutex;
+    std::condition_variable m_sleep_condition;
+    bool m_stop = false;
+};
+
+} // namespace detail
+} // namespace io
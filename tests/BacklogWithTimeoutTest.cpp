@@ -5,6 +5,7 @@
 #include <uv.h>
 
 #include <memory>
+#include <vector>
 
 class FakeTimer;
 
@@ -482,6 +483,179 @@ TEST_F(BacklogWithTimeoutTest, remove_multiple_items) {
     EXPECT_EQ(ELEMENTS_COUNT / 2, expired_counter);
 }
 
+TEST_F(BacklogWithTimeoutTest, remove_by_handle) {
+    const std::size_t ELEMENTS_COUNT = 1000;
+
+    const std::uint64_t START_TIME = 250 * 1000000;
+    reset_fake_monothonic_clock(START_TIME);
+
+    std::size_t expired_counter = 0;
+    auto on_expired = [&](io::BacklogWithTimeout<TestItem, FakeLoop, FakeTimer>&, const TestItem& item) {
+        ++expired_counter;
+        EXPECT_NE(0, item.id % 2);
+    };
+
+    using BacklogType = io::BacklogWithTimeout<TestItem, FakeLoop, FakeTimer>;
+
+    FakeLoop loop;
+    loop.set_user_data(this);
+    BacklogType backlog(loop, 250, on_expired, &TestItem::time_getter, &BacklogWithTimeoutTest::fake_monothonic_clock);
+
+    std::vector<BacklogType::ItemHandle> handles(ELEMENTS_COUNT);
+    for (std::size_t i = 0; i < ELEMENTS_COUNT; ++i) {
+        TestItem item(i);
+        item.time = START_TIME - i * 1000000 / 4;
+        ASSERT_TRUE(backlog.add_item(item, &handles[i])) << i;
+        ASSERT_TRUE(handles[i].is_valid());
+    }
+
+    EXPECT_EQ(ELEMENTS_COUNT, backlog.size());
+
+    for (std::size_t i = 0; i < ELEMENTS_COUNT; i += 2) {
+        EXPECT_TRUE(backlog.remove_item(handles[i]));
+        EXPECT_FALSE(backlog.remove_item(handles[i])); // second removal has no effect
+    }
+
+    EXPECT_EQ(ELEMENTS_COUNT / 2, backlog.size());
+    EXPECT_EQ(0, expired_counter);
+
+    advance_clock(500);
+
+    EXPECT_EQ(ELEMENTS_COUNT / 2, expired_counter);
+    EXPECT_EQ(0, backlog.size());
+
+    // Handles of expired items are not valid anymore
+    for (std::size_t i = 1; i < ELEMENTS_COUNT; i += 2) {
+        EXPECT_FALSE(backlog.remove_item(handles[i]));
+    }
+}
+
+TEST_F(BacklogWithTimeoutTest, stale_handle_does_not_affect_new_item) {
+    using BacklogType = io::BacklogWithTimeout<TestItem, FakeLoop, FakeTimer>;
+
+    std::size_t expired_counter = 0;
+    auto on_expired = [&](BacklogType&, const TestItem& item) {
+        EXPECT_EQ(1, item.id);
+        ++expired_counter;
+    };
+
+    FakeLoop loop;
+    loop.set_user_data(this);
+    BacklogType backlog(loop, 100, on_expired, &TestItem::time_getter, &BacklogWithTimeoutTest::fake_monothonic_clock);
+
+    BacklogType::ItemHandle handle_1;
+    EXPECT_TRUE(backlog.add_item(TestItem(0), &handle_1));
+    EXPECT_TRUE(backlog.remove_item(handle_1));
+
+    // Storage of the removed item is reused here
+    BacklogType::ItemHandle handle_2;
+    EXPECT_TRUE(backlog.add_item(TestItem(1), &handle_2));
+
+    EXPECT_FALSE(backlog.remove_item(handle_1));
+    EXPECT_FALSE(backlog.touch(handle_1));
+    EXPECT_EQ(1, backlog.size());
+
+    advance_clock(100);
+
+    EXPECT_EQ(1, expired_counter);
+}
+
+TEST_F(BacklogWithTimeoutTest, invalid_handle) {
+    using BacklogType = io::BacklogWithTimeout<TestItem, FakeLoop, FakeTimer>;
+
+    auto on_expired = [&](BacklogType&, const TestItem& item) {
+    };
+
+    const std::uint64_t START_TIME = 200 * 1000000;
+    reset_fake_monothonic_clock(START_TIME);
+
+    FakeLoop loop;
+    loop.set_user_data(this);
+    BacklogType backlog(loop, 100, on_expired, &TestItem::time_getter, &BacklogWithTimeoutTest::fake_monothonic_clock);
+
+    BacklogType::ItemHandle handle;
+    EXPECT_FALSE(handle.is_valid());
+    EXPECT_FALSE(backlog.remove_item(handle));
+    EXPECT_FALSE(backlog.touch(handle));
+
+    // Item which expires right away is not stored
+    TestItem item(0);
+    item.time = START_TIME - 150 * 1000000;
+    EXPECT_TRUE(backlog.add_item(item, &handle));
+    EXPECT_FALSE(handle.is_valid());
+    EXPECT_EQ(0, backlog.size());
+}
+
+TEST_F(BacklogWithTimeoutTest, touch) {
+    using BacklogType = io::BacklogWithTimeout<std::shared_ptr<TestItem>, FakeLoop, FakeTimer>;
+
+    std::size_t expired_counter = 0;
+    auto on_expired = [&](BacklogType&, const std::shared_ptr<TestItem>& item) {
+        ++expired_counter;
+    };
+
+    FakeLoop loop;
+    loop.set_user_data(this);
+    BacklogType backlog(loop, 100, on_expired, &TestItem::time_getter, &BacklogWithTimeoutTest::fake_monothonic_clock);
+
+    auto item = std::make_shared<TestItem>(0);
+    BacklogType::ItemHandle handle;
+    EXPECT_TRUE(backlog.add_item(item, &handle));
+
+    advance_clock(90);
+
+    item->time = 90 * 1000000;
+    const auto time_getter_count_before_touch = time_getter_count();
+    EXPECT_TRUE(backlog.touch(handle));
+    EXPECT_EQ(time_getter_count_before_touch + 1, time_getter_count());
+
+    advance_clock(90);
+    EXPECT_EQ(0, expired_counter);
+
+    // Expiration is detected with granularity of buckets' timers
+    advance_clock(20);
+    EXPECT_EQ(1, expired_counter);
+    EXPECT_FALSE(backlog.touch(handle));
+}
+
+TEST_F(BacklogWithTimeoutTest, remove_items_in_expired_callback) {
+    using BacklogType = io::BacklogWithTimeout<std::shared_ptr<TestItem>, FakeLoop, FakeTimer>;
+
+    const std::size_t ELEMENTS_COUNT = 10;
+
+    std::vector<BacklogType::ItemHandle> handles(ELEMENTS_COUNT);
+
+    std::size_t expired_counter = 0;
+    auto on_expired = [&](BacklogType& backlog, const std::shared_ptr<TestItem>& item) {
+        ++expired_counter;
+        // Removing all remaining items, including ones from the same bucket which is being processed
+        for (auto& handle : handles) {
+            backlog.remove_item(handle);
+        }
+    };
+
+    FakeLoop loop;
+    loop.set_user_data(this);
+    BacklogType backlog(loop, 100, on_expired, &TestItem::time_getter, &BacklogWithTimeoutTest::fake_monothonic_clock);
+
+    std::vector<std::weak_ptr<TestItem>> weak_items;
+    for (std::size_t i = 0; i < ELEMENTS_COUNT; ++i) {
+        auto item = std::make_shared<TestItem>(i);
+        weak_items.push_back(item);
+        EXPECT_TRUE(backlog.add_item(item, &handles[i]));
+    }
+
+    advance_clock(100);
+
+    EXPECT_EQ(1, expired_counter);
+    EXPECT_EQ(0, backlog.size());
+
+    // Removed items are released by the backlog
+    for (auto& weak_item : weak_items) {
+        EXPECT_TRUE(weak_item.expired());
+    }
+}
+
 TEST_F(BacklogWithTimeoutTest, move_constructor) {
     using BacklogType = io::BacklogWithTimeout<TestItem, FakeLoop, FakeTimer>;
 
@@ -0,0 +1,164 @@
+#include "UTCommon.h"
+
+#include "io/ByteScan.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct ByteScanTest : public testing::Test,
+                      public LogRedirector {
+
+protected:
+    const std::vector<io::ByteScanMode> m_modes = {io::ByteScanMode::SCALAR, io::ByteScanMode::SSE2, io::ByteScanMode::AVX2};
+
+    static const char* mode_name(io::ByteScanMode mode) {
+        switch (mode) {
+            case io::ByteScanMode::SSE2:
+                return "SSE2";
+            case io::ByteScanMode::AVX2:
+                return "AVX2";
+            default:
+                return "scalar";
+        }
+    }
+
+    // Text of lines of 1..160 bytes
+    static std::string lines_text(std::size_t size) {
+        std::string text(size, 0);
+        std::size_t next_line_end = 0;
+        for (std::size_t i = 0; i < size; ++i) {
+            if (i == next_line_end) {
+                text[i] = '\n';
+                next_line_end = i + 1 + (i * 7919) % 160;
+            } else {
+                text[i] = static_cast<char>('a' + i % 26);
+            }
+        }
+        return text;
+    }
+};
+
+TEST_F(ByteScanTest, scalar_is_always_supported) {
+    EXPECT_TRUE(io::is_byte_scan_mode_supported(io::ByteScanMode::SCALAR));
+    EXPECT_TRUE(io::is_byte_scan_mode_supported(io::best_byte_scan_mode()));
+}
+
+TEST_F(ByteScanTest, empty_range) {
+    const char data[] = "abc";
+    for (auto mode : m_modes) {
+        EXPECT_EQ(data, io::find_byte(data, data, 'a', mode));
+    }
+    EXPECT_EQ(data, io::find_byte(data, data, 'a'));
+}
+
+TEST_F(ByteScanTest, all_positions_and_alignments) {
+    // Values are checked at every position of blocks of various sizes and misalignments,
+    // bytes after the end of the range should not be found.
+    std::vector<char> buffer(256 + 64, 'x');
+
+    for (auto mode : m_modes) {
+        for (std::size_t alignment = 0; alignment < 32; ++alignment) {
+            for (std::size_t size = 0; size <= 200; size += (size < 70 ? 1 : 13)) {
+                const char* begin = buffer.data() + alignment;
+                const char* end = begin + size;
+
+                buffer[alignment + size] = '\n';
+                EXPECT_EQ(end, io::find_byte(begin, end, '\n', mode)) << mode_name(mode) << " " << size;
+                buffer[alignment + size] = 'x';
+
+                for (std::size_t position = 0; position < size; ++position) {
+                    buffer[alignment + position] = '\n';
+                    ASSERT_EQ(begin + position, io::find_byte(begin, end, '\n', mode))
+                        << mode_name(mode) << " " << alignment << " " << size << " " << position;
+                    buffer[alignment + position] = 'x';
+                }
+            }
+        }
+    }
+}
+
+TEST_F(ByteScanTest, first_of_many_and_high_bytes) {
+    std::string data(100, 'a');
+    data[70] = '\xFF';
+    data[40] = '\xFF';
+    data[90] = '\0';
+
+    for (auto mode : m_modes) {
+        EXPECT_EQ(data.data() + 40, io::find_byte(data.data(), data.data() + data.size(), '\xFF', mode)) << mode_name(mode);
+        EXPECT_EQ(data.data() + 90, io::find_byte(data.data(), data.data() + data.size(), '\0', mode)) << mode_name(mode);
+        EXPECT_EQ(data.data() + data.size(), io::find_byte(data.data(), data.data() + data.size(), 'b', mode)) << mode_name(mode);
+    }
+}
+
+TEST_F(ByteScanTest, lines_scan_matches_memchr) {
+    const std::string text = lines_text(64 * 1024);
+    const char* const begin = text.data();
+    const char* const end = text.data() + text.size();
+
+    std::vector<const char*> expected_lines_ends;
+    for (const char* current = begin; ; ++current) {
+        current = static_cast<const char*>(std::memchr(current, '\n', static_cast<std::size_t>(end - current)));
+        if (current == nullptr) {
+            break;
+        }
+        expected_lines_ends.push_back(current);
+    }
+    ASSERT_LT(100u, expected_lines_ends.size());
+
+    for (auto mode : m_modes) {
+        std::vector<const char*> lines_ends;
+        for (const char* current = io::find_byte(begin, end, '\n', mode); current != end; current = io::find_byte(current + 1, end, '\n', mode)) {
+            lines_ends.push_back(current);
+        }
+        EXPECT_TRUE(expected_lines_ends == lines_ends) << mode_name(mode);
+    }
+}
+
+// Timing comparison with memchr, not a part of the regular run
+TEST_F(ByteScanTest, DISABLED_lines_scan_vs_memchr_benchmark) {
+    // 64 MB are scanned by every method
+    const std::size_t SIZE = 4 * 1024 * 1024;
+    const std::size_t ITERATIONS = 16;
+
+    const std::string text = lines_text(SIZE);
+    const char* const begin = text.data();
+    const char* const end = text.data() + text.size();
+
+    auto count_lines = [&](const std::function<const char*(const char*)>& find) {
+        std::size_t count = 0;
+        const auto start = std::chrono::high_resolution_clock::now();
+        for (std::size_t i = 0; i < ITERATIONS; ++i) {
+            for (const char* current = find(begin); current != end; current = find(current + 1)) {
+                ++count;
+            }
+        }
+        const auto finish = std::chrono::high_resolution_clock::now();
+        return std::make_pair(count, std::chrono::duration_cast<std::chrono::milliseconds>(finish - start).count());
+    };
+
+    const auto memchr_result = count_lines([&](const char* current) {
+        auto result = static_cast<const char*>(std::memchr(current, '\n', static_cast<std::size_t>(end - current)));
+        return result ? result : end;
+    });
+    std::cout << "memchr: " << memchr_result.second << " ms";
+
+    for (auto mode : m_modes) {
+        if (!io::is_byte_scan_mode_supported(mode)) {
+            continue;
+        }
+
+        const auto result = count_lines([&](const char* current) {
+            return io::find_byte(current, end, '\n', mode);
+        });
+        EXPECT_EQ(memchr_result.first, result.first) << mode_name(mode);
+        std::cout << ", " << mode_name(mode) << ": " << result.second << " ms";
+    }
+
+    std::cout << " for " << SIZE * ITERATIONS / (1024 * 1024) << " MB of lines" << std::endl;
+}
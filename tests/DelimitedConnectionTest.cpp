@@ -0,0 +1,293 @@
+#include "UTCommon.h"
+#include "FakeConnection.h"
+
+#include "io/DelimitedConnection.h"
+#include "io/TcpClient.h"
+#include "io/TcpServer.h"
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct DelimitedConnectionTest : public testing::Test,
+                                 public LogRedirector {
+
+protected:
+    using Splitter = io::DelimitedConnection<FakeConnection>;
+
+    std::uint16_t m_default_port = 31540;
+    std::string m_default_addr = "127.0.0.1";
+};
+
+TEST_F(DelimitedConnectionTest, default_state) {
+    Splitter splitter(nullptr);
+    EXPECT_EQ(1, splitter.delimiter_size());
+    EXPECT_EQ(Splitter::DEFAULT_MAX_LINE_SIZE, splitter.max_line_size());
+    EXPECT_EQ(0, splitter.zero_copy_lines_count());
+    EXPECT_EQ(0, splitter.reassembled_lines_count());
+
+    Splitter crlf_splitter(nullptr, Splitter::Delimiter::CRLF, 100);
+    EXPECT_EQ(2, crlf_splitter.delimiter_size());
+    EXPECT_EQ(100, crlf_splitter.max_line_size());
+}
+
+TEST_F(DelimitedConnectionTest, lines_in_one_chunk_are_not_copied) {
+    FakeConnection connection;
+
+    std::vector<io::DataChunk> lines;
+    Splitter splitter([&](FakeConnection& conn, const io::DataChunk& line, const io::Error& error) {
+        EXPECT_EQ(&connection, &conn);
+        EXPECT_FALSE(error);
+        lines.push_back(line);
+    });
+
+    const auto chunk = make_chunk("first\n\nsecond\nthi");
+    splitter.on_receive(connection, chunk);
+
+    ASSERT_EQ(3, lines.size());
+
+    EXPECT_EQ(chunk.buf.get(), lines[0].buf.get());
+    EXPECT_EQ(0, lines[0].offset);
+    EXPECT_EQ("first", std::string(lines[0].buf.get(), lines[0].size));
+
+    EXPECT_EQ(0, lines[1].size);
+    EXPECT_EQ(6, lines[1].offset);
+    EXPECT_EQ(nullptr, lines[1].buf);
+
+    EXPECT_EQ(chunk.buf.get() + 7, lines[2].buf.get());
+    EXPECT_EQ(7, lines[2].offset);
+    EXPECT_EQ("second", std::string(lines[2].buf.get(), lines[2].size));
+
+    EXPECT_EQ(2, splitter.zero_copy_lines_count());
+    EXPECT_EQ(0, splitter.reassembled_lines_count());
+
+    splitter.on_receive(connection, make_chunk("rd\n"));
+    ASSERT_EQ(4, lines.size());
+    EXPECT_EQ(14, lines[3].offset);
+    EXPECT_EQ("third", std::string(lines[3].buf.get(), lines[3].size));
+    EXPECT_EQ(1, splitter.reassembled_lines_count());
+}
+
+TEST_F(DelimitedConnectionTest, crlf_split_by_one_byte) {
+    FakeConnection connection;
+
+    std::vector<std::string> lines;
+    Splitter splitter([&](FakeConnection&, const io::DataChunk& line, const io::Error& error) {
+        EXPECT_FALSE(error);
+        lines.emplace_back(line.buf ? line.buf.get() : "", line.size);
+    },
+    Splitter::Delimiter::CRLF);
+
+    const std::string stream = "*2\r\n$3\r\nGET\r\n\r\nmulti\nline\r\n\r\r\n";
+    for (std::size_t i = 0; i < stream.size(); ++i) {
+        splitter.on_receive(connection, make_chunk(stream.substr(i, 1)));
+    }
+
+    const std::vector<std::string> expected = {"*2", "$3", "GET", "", "multi\nline", "\r"};
+    EXPECT_EQ(expected, lines);
+
+    // The same stream in one chunk
+    lines.clear();
+    splitter.on_receive(connection, make_chunk(stream));
+    EXPECT_EQ(expected, lines);
+}
+
+TEST_F(DelimitedConnectionTest, custom_delimiter_byte) {
+    FakeConnection connection;
+
+    std::vector<std::string> lines;
+    Splitter splitter([&](FakeConnection&, const io::DataChunk& line, const io::Error& error) {
+        EXPECT_FALSE(error);
+        lines.emplace_back(line.buf ? line.buf.get() : "", line.size);
+    },
+    '\0');
+
+    splitter.on_receive(connection, make_chunk(std::string("a\nb\0cd\0e", 8)));
+    splitter.on_receive(connection, make_chunk(std::string("f\0", 2)));
+
+    const std::vector<std::string> expected = {"a\nb", "cd", "ef"};
+    EXPECT_EQ(expected, lines);
+}
+
+TEST_F(DelimitedConnectionTest, send_line) {
+    FakeConnection connection;
+
+    Splitter splitter(nullptr, Splitter::Delimiter::CRLF);
+
+    std::size_t send_callback_count = 0;
+    splitter.send_line(connection, "PING", [&](FakeConnection&, const io::Error& error) {
+        EXPECT_FALSE(error);
+        ++send_callback_count;
+    });
+
+    std::shared_ptr<char> buf(new char[4], std::default_delete<char[]>());
+    std::memcpy(buf.get(), "PONG", 4);
+    splitter.send_line(connection, buf, 4, [&](FakeConnection&, const io::Error& error) {
+        EXPECT_FALSE(error);
+        ++send_callback_count;
+    });
+
+    EXPECT_EQ(2, send_callback_count);
+    EXPECT_EQ(2, connection.writes_count);
+    EXPECT_EQ("PING\r\nPONG\r\n", connection.sent);
+}
+
+TEST_F(DelimitedConnectionTest, too_long_line) {
+    FakeConnection connection;
+
+    std::vector<std::string> lines;
+    std::size_t errors_count = 0;
+    Splitter splitter([&](FakeConnection&, const io::DataChunk& line, const io::Error& error) {
+        if (error) {
+            EXPECT_EQ(io::StatusCode::MESSAGE_TOO_LONG, error.code());
+            ++errors_count;
+        } else {
+            lines.emplace_back(line.buf.get(), line.size);
+        }
+    },
+    Splitter::Delimiter::CRLF,
+    4);
+
+    // Line of max size with '\r' in the previous chunk is fine
+    splitter.on_receive(connection, make_chunk("abcd\r"));
+    splitter.on_receive(connection, make_chunk("\n"));
+    ASSERT_EQ(1, lines.size());
+    EXPECT_EQ("abcd", lines[0]);
+    EXPECT_EQ(0, errors_count);
+
+    // Partial line is limited too
+    splitter.on_receive(connection, make_chunk("abc"));
+    splitter.on_receive(connection, make_chunk("def"));
+    EXPECT_EQ(1, errors_count);
+
+    // Rest of the stream is ignored
+    splitter.on_receive(connection, make_chunk("ab\r\n"));
+    EXPECT_EQ(1, lines.size());
+
+    splitter.reset();
+    splitter.on_receive(connection, make_chunk("ab\r\nabcde\r\n"));
+    ASSERT_EQ(2, lines.size());
+    EXPECT_EQ("ab", lines[1]);
+    EXPECT_EQ(2, errors_count);
+}
+
+TEST_F(DelimitedConnectionTest, partial_line_buffer_reuse) {
+    FakeConnection connection;
+
+    std::vector<io::DataChunk> lines;
+    bool retain_lines = false;
+    Splitter splitter([&](FakeConnection&, const io::DataChunk& line, const io::Error& error) {
+        EXPECT_FALSE(error);
+        lines.push_back(retain_lines ? line : io::DataChunk(nullptr, line.size, reinterpret_cast<std::size_t>(line.buf.get())));
+    });
+
+    for (std::size_t i = 0; i < 4; ++i) {
+        retain_lines = i >= 2;
+        splitter.on_receive(connection, make_chunk("ab"));
+        splitter.on_receive(connection, make_chunk("cd\n"));
+    }
+
+    ASSERT_EQ(4, lines.size());
+    EXPECT_EQ(4, splitter.reassembled_lines_count());
+
+    // Not retained lines use the same buffer
+    EXPECT_EQ(lines[0].offset, lines[1].offset);
+    EXPECT_EQ(lines[1].offset, reinterpret_cast<std::size_t>(lines[2].buf.get()));
+
+    // Retained line is not overwritten
+    EXPECT_NE(lines[2].buf.get(), lines[3].buf.get());
+    EXPECT_EQ("abcd", std::string(lines[2].buf.get(), lines[2].size));
+    EXPECT_EQ("abcd", std::string(lines[3].buf.get(), lines[3].size));
+}
+
+TEST_F(DelimitedConnectionTest, reset_from_callback) {
+    FakeConnection connection;
+
+    std::vector<std::string> lines;
+    Splitter* splitter_ptr = nullptr;
+    Splitter splitter([&](FakeConnection&, const io::DataChunk& line, const io::Error& error) {
+        EXPECT_FALSE(error);
+        lines.emplace_back(line.buf.get(), line.size);
+        splitter_ptr->reset();
+    });
+    splitter_ptr = &splitter;
+
+    splitter.on_receive(connection, make_chunk("a\nb\n"));
+    ASSERT_EQ(1, lines.size());
+    EXPECT_EQ("a", lines[0]);
+
+    splitter.on_receive(connection, make_chunk("c\n"));
+    ASSERT_EQ(2, lines.size());
+    EXPECT_EQ("c", lines[1]);
+}
+
+TEST_F(DelimitedConnectionTest, tcp_echo) {
+    // Server sends received lines back without copying, client checks them
+    const std::size_t LINES_COUNT = 5000;
+
+    std::vector<std::string> lines;
+    for (std::size_t i = 0; i < LINES_COUNT; ++i) {
+        lines.emplace_back((i * 7919) % 300, static_cast<char>('a' + i % 26));
+    }
+
+    io::EventLoop loop;
+
+    std::size_t server_lines_count = 0;
+    std::size_t client_lines_count = 0;
+
+    io::DelimitedConnection<io::TcpConnectedClient> server_splitter(
+        [&](io::TcpConnectedClient& client, const io::DataChunk& line, const io::Error& error) {
+            EXPECT_FALSE(error);
+            ++server_lines_count;
+            server_splitter.send_line(client, line.buf, static_cast<std::uint32_t>(line.size));
+        },
+        io::DelimitedConnection<io::TcpConnectedClient>::Delimiter::CRLF);
+
+    auto server = new io::TcpServer(loop);
+    auto listen_error = server->listen({"0.0.0.0", m_default_port},
+        nullptr,
+        [&](io::TcpConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error);
+            server_splitter.on_receive(client, data);
+        },
+        nullptr
+    );
+    ASSERT_FALSE(listen_error);
+
+    io::DelimitedConnection<io::TcpClient> client_splitter(
+        [&](io::TcpClient& client, const io::DataChunk& line, const io::Error& error) {
+            EXPECT_FALSE(error);
+            ASSERT_LT(client_lines_count, LINES_COUNT);
+            EXPECT_TRUE(lines[client_lines_count] == std::string(line.buf ? line.buf.get() : "", line.size)) << client_lines_count;
+            ++client_lines_count;
+
+            if (client_lines_count == LINES_COUNT) {
+                client.schedule_removal();
+                server->schedule_removal();
+            }
+        },
+        io::DelimitedConnection<io::TcpClient>::Delimiter::CRLF);
+
+    auto client = new io::TcpClient(loop);
+    client->connect({m_default_addr, m_default_port},
+        [&](io::TcpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error);
+            for (const auto& line : lines) {
+                client_splitter.send_line(client, line);
+            }
+        },
+        [&](io::TcpClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error);
+            client_splitter.on_receive(client, data);
+        }
+    );
+
+    ASSERT_EQ(0, loop.run());
+
+    EXPECT_EQ(LINES_COUNT, server_lines_count);
+    EXPECT_EQ(LINES_COUNT, client_lines_count);
+    EXPECT_LT(0, server_splitter.zero_copy_lines_count());
+}
@@ -0,0 +1,87 @@
+#include "UTCommon.h"
+
+#include "io/EventLoopGroup.h"
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <thread>
+
+struct EventLoopGroupTest : public testing::Test,
+                            public LogRedirector {
+};
+
+TEST_F(EventLoopGroupTest, default_constructor) {
+    io::EventLoopGroup group;
+    EXPECT_GE(group.size(), 1);
+    ASSERT_EQ(0, group.run());
+}
+
+TEST_F(EventLoopGroupTest, explicit_size) {
+    io::EventLoopGroup group(3);
+    ASSERT_EQ(3, group.size());
+    EXPECT_FALSE(group.is_running());
+    ASSERT_EQ(0, group.run());
+    EXPECT_FALSE(group.is_running());
+}
+
+TEST_F(EventLoopGroupTest, next_loop_round_robin) {
+    io::EventLoopGroup group(3);
+
+    EXPECT_EQ(&group.loop(0), &group.next_loop());
+    EXPECT_EQ(&group.loop(1), &group.next_loop());
+    EXPECT_EQ(&group.loop(2), &group.next_loop());
+    EXPECT_EQ(&group.loop(0), &group.next_loop());
+
+    ASSERT_EQ(0, group.run());
+}
+
+TEST_F(EventLoopGroupTest, execute_on_each_loop_thread) {
+    const std::size_t LOOPS_COUNT = 4;
+
+    io::EventLoopGroup group(LOOPS_COUNT);
+
+    std::mutex mutex;
+    std::set<std::thread::id> thread_ids;
+    std::set<io::EventLoop*> loops;
+
+    group.execute_on_each_loop_thread([&](io::EventLoop& loop) {
+        EXPECT_TRUE(group.is_running());
+
+        std::lock_guard<std::mutex> guard(mutex);
+        thread_ids.insert(std::this_thread::get_id());
+        loops.insert(&loop);
+    });
+
+    ASSERT_EQ(0, group.run());
+
+    EXPECT_EQ(LOOPS_COUNT, thread_ids.size());
+    EXPECT_EQ(LOOPS_COUNT, loops.size());
+}
+
+TEST_F(EventLoopGroupTest, work_on_each_loop) {
+    const std::size_t LOOPS_COUNT = 4;
+    const std::size_t WORKS_PER_LOOP = 10;
+
+    io::EventLoopGroup group(LOOPS_COUNT);
+
+    std::atomic<std::size_t> work_counter(0);
+    std::atomic<std::size_t> work_done_counter(0);
+
+    for (std::size_t i = 0; i < LOOPS_COUNT; ++i) {
+        for (std::size_t k = 0; k < WORKS_PER_LOOP; ++k) {
+            group.loop(i).add_work(
+                [&]() {
+                    ++work_counter;
+                },
+                [&]() {
+                    ++work_done_counter;
+                });
+        }
+    }
+
+    ASSERT_EQ(0, group.run());
+
+    EXPECT_EQ(LOOPS_COUNT * WORKS_PER_LOOP, work_counter);
+    EXPECT_EQ(LOOPS_COUNT * WORKS_PER_LOOP, work_done_counter);
+}
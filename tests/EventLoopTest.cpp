@@ -3,8 +3,15 @@
 #include "io/EventLoop.h"
 #include "io/ScopeExitGuard.h"
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <set>
+#include <string>
 #include <thread>
 #include <mutex>
+#include <vector>
 
 struct EventLoopTest : public testing::Test,
                        public LogRedirector {
@@ -90,6 +97,261 @@ TEST_F(EventLoopTest, work_with_user_data) {
     ASSERT_TRUE(done_executed);
 }
 
+TEST_F(EventLoopTest, work_on_own_thread_pool) {
+    const std::size_t WORKS_COUNT = 1000;
+
+    io::EventLoop event_loop(4);
+
+    auto main_thread_id = std::this_thread::get_id();
+
+    std::mutex mutex;
+    std::set<std::thread::id> work_thread_ids;
+    std::size_t work_done_counter = 0;
+
+    for (std::size_t i = 0; i < WORKS_COUNT; ++i) {
+        event_loop.add_work(
+            [&]() {
+                EXPECT_NE(main_thread_id, std::this_thread::get_id());
+
+                std::lock_guard<std::mutex> guard(mutex);
+                work_thread_ids.insert(std::this_thread::get_id());
+            },
+            [&]() {
+                EXPECT_EQ(main_thread_id, std::this_thread::get_id());
+                ++work_done_counter;
+            });
+    }
+
+    ASSERT_EQ(0, event_loop.run());
+
+    EXPECT_EQ(WORKS_COUNT, work_done_counter);
+    EXPECT_GE(4, work_thread_ids.size());
+}
+
+TEST_F(EventLoopTest, work_with_user_data_on_own_thread_pool) {
+    io::EventLoop event_loop(2);
+
+    void* received_user_data = nullptr;
+
+    event_loop.add_work(
+        []() -> void* {
+            return reinterpret_cast<void*>(42);
+        },
+        [&](void* user_data) {
+            received_user_data = user_data;
+        });
+
+    ASSERT_EQ(0, event_loop.run());
+    EXPECT_EQ(reinterpret_cast<void*>(42), received_user_data);
+}
+
+TEST_F(EventLoopTest, work_stealing) {
+    // Works are distributed between 2 workers in round robin manner: 1 and 3 go to the first worker,
+    // 2 to the second one. The 1st work waits for the 3rd, so if the first worker is busy with the 1st work
+    // the 3rd could be executed only if the second worker steals it.
+    io::EventLoop event_loop(2);
+
+    std::atomic<bool> work_3_executed(false);
+    bool work_1_done = false;
+
+    event_loop.add_work(
+        [&]() {
+            const auto start = std::chrono::steady_clock::now();
+            while (!work_3_executed && std::chrono::steady_clock::now() - start < std::chrono::seconds(5)) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        },
+        [&]() {
+            work_1_done = true;
+        });
+
+    event_loop.add_work([&]() {});
+
+    event_loop.add_work([&]() {
+        work_3_executed = true;
+    });
+
+    ASSERT_EQ(0, event_loop.run());
+
+    EXPECT_TRUE(work_3_executed);
+    EXPECT_TRUE(work_1_done);
+}
+
+TEST_F(EventLoopTest, parallel_for) {
+    const std::size_t BEGIN = 10;
+    const std::size_t END = 100007;
+
+    for (std::size_t work_threads_count : {0, 3}) {
+        io::EventLoop event_loop(work_threads_count);
+
+        auto main_thread_id = std::this_thread::get_id();
+
+        std::vector<char> visited(END, 0);
+        std::atomic<std::size_t> chunks_counter(0);
+        std::size_t done_counter = 0;
+
+        event_loop.parallel_for(BEGIN, END, 1000,
+            [&](std::size_t begin, std::size_t end) {
+                EXPECT_LE(end - begin, 1000);
+                for (std::size_t i = begin; i < end; ++i) {
+                    ++visited[i];
+                }
+                ++chunks_counter;
+            },
+            [&]() {
+                EXPECT_EQ(main_thread_id, std::this_thread::get_id());
+                ++done_counter;
+            });
+
+        ASSERT_EQ(0, event_loop.run());
+
+        EXPECT_EQ(1, done_counter);
+        EXPECT_EQ(100, chunks_counter);
+        for (std::size_t i = 0; i < END; ++i) {
+            ASSERT_EQ(i < BEGIN ? 0 : 1, visited[i]) << "i=" << i;
+        }
+    }
+}
+
+TEST_F(EventLoopTest, parallel_for_empty_range) {
+    io::EventLoop event_loop;
+
+    bool body_called = false;
+    std::size_t done_counter = 0;
+
+    event_loop.parallel_for(5, 5, 0,
+        [&](std::size_t, std::size_t) {
+            body_called = true;
+        },
+        [&]() {
+            ++done_counter;
+        });
+
+    ASSERT_EQ(0, event_loop.run());
+
+    EXPECT_FALSE(body_called);
+    EXPECT_EQ(1, done_counter);
+}
+
+TEST_F(EventLoopTest, map_reduce) {
+    io::EventLoop event_loop(4);
+
+    std::size_t done_counter = 0;
+    std::uint64_t result = 0;
+
+    event_loop.map_reduce<std::uint64_t>(1, 1000001, 777,
+        [](std::size_t begin, std::size_t end) {
+            std::uint64_t sum = 0;
+            for (std::size_t i = begin; i < end; ++i) {
+                sum += i;
+            }
+            return sum;
+        },
+        [](const std::uint64_t& accumulated, const std::uint64_t& value) {
+            return accumulated + value;
+        },
+        0,
+        [&](const std::uint64_t& value) {
+            ++done_counter;
+            result = value;
+        });
+
+    ASSERT_EQ(0, event_loop.run());
+
+    EXPECT_EQ(1, done_counter);
+    EXPECT_EQ(std::uint64_t(1000000) * 1000001 / 2, result);
+}
+
+TEST_F(EventLoopTest, map_reduce_keeps_chunks_order) {
+    io::EventLoop event_loop;
+
+    std::string result;
+
+    event_loop.map_reduce<std::string>(0, 26, 3,
+        [](std::size_t begin, std::size_t end) {
+            std::string chunk;
+            for (std::size_t i = begin; i < end; ++i) {
+                chunk += static_cast<char>('a' + i);
+            }
+            return chunk;
+        },
+        [](const std::string& accumulated, const std::string& value) {
+            return accumulated + value;
+        },
+        std::string(">"),
+        [&](const std::string& value) {
+            result = value;
+        });
+
+    ASSERT_EQ(0, event_loop.run());
+
+    EXPECT_EQ(">abcdefghijklmnopqrstuvwxyz", result);
+}
+
+TEST_F(EventLoopTest, work_requests_reuse) {
+    const std::size_t WORKS_COUNT = 100;
+
+    for (std::size_t work_threads_count : {0, 2}) {
+        io::EventLoop event_loop(work_threads_count);
+
+        std::size_t work_done_counter = 0;
+
+        // Each next work is added from the completion of the previous one
+        std::function<void()> add_next_work = [&]() {
+            event_loop.add_work(
+                []() {},
+                [&]() {
+                    if (++work_done_counter < WORKS_COUNT) {
+                        add_next_work();
+                    }
+                });
+        };
+
+        add_next_work();
+
+        ASSERT_EQ(0, event_loop.run());
+
+        // Request is released after its completion callback, so 2 requests are alternating
+        EXPECT_EQ(WORKS_COUNT, work_done_counter);
+        EXPECT_EQ(2, event_loop.allocated_work_requests_count());
+        EXPECT_EQ(WORKS_COUNT - 2, event_loop.reused_work_requests_count());
+    }
+}
+
+TEST_F(EventLoopTest, work_requests_reuse_after_burst) {
+    const std::size_t WORKS_COUNT = 50;
+
+    io::EventLoop event_loop(2);
+
+    std::size_t work_done_counter = 0;
+
+    auto add_works = [&](std::function<void()> on_last_done) {
+        for (std::size_t i = 0; i < WORKS_COUNT; ++i) {
+            event_loop.add_work(
+                []() -> void* {
+                    return nullptr;
+                },
+                [&, on_last_done](void*) {
+                    if (++work_done_counter % WORKS_COUNT == 0 && on_last_done) {
+                        on_last_done();
+                    }
+                });
+        }
+    };
+
+    add_works([&]() {
+        add_works(nullptr);
+    });
+
+    ASSERT_EQ(0, event_loop.run());
+
+    // Second burst is added from the completion callback of the last work of the first one,
+    // all requests except that one are already released at that moment.
+    EXPECT_EQ(WORKS_COUNT * 2, work_done_counter);
+    EXPECT_EQ(WORKS_COUNT + 1, event_loop.allocated_work_requests_count());
+    EXPECT_EQ(WORKS_COUNT - 1, event_loop.reused_work_requests_count());
+}
+
 TEST_F(EventLoopTest, schedule_on_each_loop_cycle) {
     io::EventLoop loop;
 
@@ -348,6 +610,91 @@ TEST_F(EventLoopTest, run_loop_several_times) {
     EXPECT_EQ(1, counter_3);
 }
 
+TEST_F(EventLoopTest, execute_on_loop_thread_bulk) {
+    io::EventLoop loop;
+
+    std::vector<std::size_t> execution_order;
+
+    std::vector<io::EventLoop::AsyncCallback> callbacks;
+    for (std::size_t i = 0; i < 5; ++i) {
+        callbacks.push_back([&execution_order, i]() {
+            execution_order.push_back(i);
+        });
+    }
+
+    loop.execute_on_loop_thread(std::move(callbacks));
+    loop.execute_on_loop_thread(std::vector<io::EventLoop::AsyncCallback>()); // no effect
+
+    EXPECT_TRUE(execution_order.empty());
+
+    ASSERT_EQ(0, loop.run());
+
+    ASSERT_EQ(5, execution_order.size());
+    for (std::size_t i = 0; i < execution_order.size(); ++i) {
+        EXPECT_EQ(i, execution_order[i]);
+    }
+}
+
+TEST_F(EventLoopTest, execute_on_loop_thread_from_multiple_threads) {
+    const std::size_t THREADS_COUNT = 4;
+    const std::size_t CALLBACKS_PER_THREAD = 20000;
+    const std::size_t BULK_SIZE = 10;
+
+    io::EventLoop loop;
+    loop.start_dummy_idle(); // need to hold loop running
+
+    auto main_thread_id = std::this_thread::get_id();
+
+    // Accessed only from the loop thread
+    std::size_t callbacks_counter = 0;
+    std::vector<std::size_t> last_value_per_thread(THREADS_COUNT, 0);
+    bool order_is_preserved = true;
+
+    auto on_callback = [&](std::size_t thread_index, std::size_t value) {
+        EXPECT_EQ(main_thread_id, std::this_thread::get_id());
+
+        // Callbacks from the same producer are executed in order of posting
+        if (value != last_value_per_thread[thread_index] + 1) {
+            order_is_preserved = false;
+        }
+        last_value_per_thread[thread_index] = value;
+
+        if (++callbacks_counter == THREADS_COUNT * CALLBACKS_PER_THREAD) {
+            loop.stop_dummy_idle();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < THREADS_COUNT; ++i) {
+        threads.emplace_back([&, i]() {
+            std::size_t value = 1;
+            while (value <= CALLBACKS_PER_THREAD) {
+                // Half of threads use bulk version
+                if (i % 2) {
+                    std::vector<io::EventLoop::AsyncCallback> callbacks;
+                    for (std::size_t k = 0; k < BULK_SIZE; ++k, ++value) {
+                        callbacks.push_back(std::bind(on_callback, i, value));
+                    }
+                    loop.execute_on_loop_thread(std::move(callbacks));
+                } else {
+                    loop.execute_on_loop_thread(std::bind(on_callback, i, value++));
+                }
+            }
+        });
+    }
+
+    io::ScopeExitGuard scope_guard([&threads](){
+        for (auto& t : threads) {
+            t.join();
+        }
+    });
+
+    ASSERT_EQ(0, loop.run());
+
+    EXPECT_EQ(THREADS_COUNT * CALLBACKS_PER_THREAD, callbacks_counter);
+    EXPECT_TRUE(order_is_preserved);
+}
+
 // TODO: create event loop in one thread and run in another
 
 TEST_F(EventLoopTest, schedule_1_callback) {
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "io/DataChunk.h"
+#include "io/Error.h"
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Collects sent data instead of real connection. Used to test connection adapters like FramedConnection.
+struct FakeConnection {
+    using EndSendCallback = std::function<void(FakeConnection&, const io::Error&)>;
+
+    void send_data(std::shared_ptr<const char> buffer, std::uint32_t size, EndSendCallback callback) {
+        sent.append(buffer.get(), size);
+        ++writes_count;
+        if (callback) {
+            callback(*this, io::Error(0));
+        }
+    }
+
+    void send_data(std::vector<io::DataChunk> chunks, EndSendCallback callback) {
+        for (const auto& chunk : chunks) {
+            sent.append(chunk.buf.get(), chunk.size);
+        }
+        ++writes_count;
+        if (callback) {
+            callback(*this, io::Error(0));
+        }
+    }
+
+    std::string sent;
+    std::size_t writes_count = 0;
+};
+
+inline io::DataChunk make_chunk(const std::string& data) {
+    std::shared_ptr<char> buf(new char[data.size()], std::default_delete<char[]>());
+    std::memcpy(buf.get(), data.data(), data.size());
+    return io::DataChunk(buf, data.size());
+}
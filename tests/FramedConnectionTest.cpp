@@ -0,0 +1,309 @@
+#include "UTCommon.h"
+#include "FakeConnection.h"
+
+#include "io/FramedConnection.h"
+#include "io/TcpClient.h"
+#include "io/TcpServer.h"
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct FramedConnectionTest : public testing::Test,
+                              public LogRedirector {
+
+protected:
+    using Framer = io::FramedConnection<FakeConnection>;
+
+    std::uint16_t m_default_port = 31540;
+    std::string m_default_addr = "127.0.0.1";
+};
+
+TEST_F(FramedConnectionTest, default_state) {
+    Framer framer(nullptr);
+    EXPECT_EQ(4, framer.prefix_size());
+    EXPECT_EQ(Framer::ByteOrder::BIG, framer.byte_order());
+    EXPECT_EQ(Framer::DEFAULT_MAX_FRAME_SIZE, framer.max_frame_size());
+    EXPECT_EQ(0, framer.zero_copy_frames_count());
+    EXPECT_EQ(0, framer.reassembled_frames_count());
+}
+
+TEST_F(FramedConnectionTest, frames_in_one_chunk_are_not_copied) {
+    FakeConnection connection;
+
+    std::vector<io::DataChunk> frames;
+    Framer framer([&](FakeConnection& conn, const io::DataChunk& frame, const io::Error& error) {
+        EXPECT_EQ(&connection, &conn);
+        EXPECT_FALSE(error);
+        frames.push_back(frame);
+    });
+
+    const auto chunk = make_chunk(std::string("\x00\x00\x00\x03" "abc" "\x00\x00\x00\x00" "\x00\x00\x00\x02" "de", 17));
+    framer.on_receive(connection, chunk);
+
+    ASSERT_EQ(3, frames.size());
+
+    EXPECT_EQ(3, frames[0].size);
+    EXPECT_EQ(4, frames[0].offset);
+    EXPECT_EQ(chunk.buf.get() + 4, frames[0].buf.get());
+    EXPECT_EQ("abc", std::string(frames[0].buf.get(), frames[0].size));
+
+    EXPECT_EQ(0, frames[1].size);
+    EXPECT_EQ(nullptr, frames[1].buf);
+
+    EXPECT_EQ(2, frames[2].size);
+    EXPECT_EQ(15, frames[2].offset);
+    EXPECT_EQ(chunk.buf.get() + 15, frames[2].buf.get());
+    EXPECT_EQ("de", std::string(frames[2].buf.get(), frames[2].size));
+
+    EXPECT_EQ(2, framer.zero_copy_frames_count());
+    EXPECT_EQ(0, framer.reassembled_frames_count());
+}
+
+TEST_F(FramedConnectionTest, frames_split_by_one_byte) {
+    FakeConnection connection;
+
+    std::vector<std::string> frames;
+    Framer framer([&](FakeConnection&, const io::DataChunk& frame, const io::Error& error) {
+        EXPECT_FALSE(error);
+        frames.emplace_back(frame.buf ? frame.buf.get() : "", frame.size);
+    },
+    2,
+    Framer::ByteOrder::LITTLE);
+
+    const std::string large(300, 'x');
+    const std::string stream = std::string("\x05\x00" "hello" "\x2C\x01", 9) + large + std::string("\x00\x00", 2);
+    for (std::size_t i = 0; i < stream.size(); ++i) {
+        framer.on_receive(connection, make_chunk(stream.substr(i, 1)));
+    }
+
+    ASSERT_EQ(3, frames.size());
+    EXPECT_EQ("hello", frames[0]);
+    EXPECT_EQ(large, frames[1]);
+    EXPECT_EQ("", frames[2]);
+    EXPECT_EQ(0, framer.zero_copy_frames_count());
+    EXPECT_EQ(2, framer.reassembled_frames_count());
+}
+
+TEST_F(FramedConnectionTest, prefix_sizes_and_byte_orders) {
+    for (auto byte_order : {Framer::ByteOrder::BIG, Framer::ByteOrder::LITTLE}) {
+        for (std::size_t prefix_size : {1, 2, 4, 8}) {
+            FakeConnection connection;
+
+            std::vector<std::string> frames;
+            Framer framer([&](FakeConnection&, const io::DataChunk& frame, const io::Error& error) {
+                EXPECT_FALSE(error);
+                frames.emplace_back(frame.buf.get(), frame.size);
+            },
+            prefix_size,
+            byte_order);
+
+            const std::string message_1(200, 'a');
+            const std::string message_2 = "second";
+            std::size_t send_callback_count = 0;
+
+            framer.send_frame(connection, message_1, [&](FakeConnection&, const io::Error& error) {
+                EXPECT_FALSE(error);
+                ++send_callback_count;
+            });
+
+            std::shared_ptr<char> buf(new char[message_2.size()], std::default_delete<char[]>());
+            std::memcpy(buf.get(), message_2.data(), message_2.size());
+            framer.send_frame(connection, buf, static_cast<std::uint32_t>(message_2.size()), [&](FakeConnection&, const io::Error& error) {
+                EXPECT_FALSE(error);
+                ++send_callback_count;
+            });
+
+            EXPECT_EQ(2, send_callback_count);
+            EXPECT_EQ(2, connection.writes_count);
+            ASSERT_EQ(2 * prefix_size + message_1.size() + message_2.size(), connection.sent.size());
+
+            if (byte_order == Framer::ByteOrder::BIG) {
+                EXPECT_EQ(200, static_cast<unsigned char>(connection.sent[prefix_size - 1])) << prefix_size;
+            } else {
+                EXPECT_EQ(200, static_cast<unsigned char>(connection.sent[0])) << prefix_size;
+            }
+
+            framer.on_receive(connection, make_chunk(connection.sent));
+            ASSERT_EQ(2, frames.size()) << prefix_size;
+            EXPECT_EQ(message_1, frames[0]);
+            EXPECT_EQ(message_2, frames[1]);
+        }
+    }
+}
+
+TEST_F(FramedConnectionTest, send_too_long_frame) {
+    FakeConnection connection;
+    Framer framer(nullptr, 1, Framer::ByteOrder::BIG, 1024);
+
+    std::size_t send_callback_count = 0;
+    framer.send_frame(connection, std::string(256, 'a'), [&](FakeConnection&, const io::Error& error) {
+        // Does not fit into 1 byte prefix
+        EXPECT_EQ(io::StatusCode::MESSAGE_TOO_LONG, error.code());
+        ++send_callback_count;
+    });
+
+    Framer framer_2(nullptr, 4, Framer::ByteOrder::BIG, 1024);
+    framer_2.send_frame(connection, std::string(1025, 'a'), [&](FakeConnection&, const io::Error& error) {
+        EXPECT_EQ(io::StatusCode::MESSAGE_TOO_LONG, error.code());
+        ++send_callback_count;
+    });
+
+    EXPECT_EQ(2, send_callback_count);
+    EXPECT_EQ(0, connection.writes_count);
+}
+
+TEST_F(FramedConnectionTest, receive_too_long_frame) {
+    FakeConnection connection;
+
+    std::size_t frames_count = 0;
+    std::size_t errors_count = 0;
+    Framer framer([&](FakeConnection&, const io::DataChunk& frame, const io::Error& error) {
+        if (error) {
+            EXPECT_EQ(io::StatusCode::MESSAGE_TOO_LONG, error.code());
+            ++errors_count;
+        } else {
+            ++frames_count;
+        }
+    },
+    4,
+    Framer::ByteOrder::BIG,
+    16);
+
+    framer.on_receive(connection, make_chunk(std::string("\x00\x00\x00\x01" "a" "\x00\x00\x00\x11", 9)));
+    EXPECT_EQ(1, frames_count);
+    EXPECT_EQ(1, errors_count);
+
+    // Rest of the stream is ignored
+    framer.on_receive(connection, make_chunk(std::string("\x00\x00\x00\x01" "a", 5)));
+    EXPECT_EQ(1, frames_count);
+    EXPECT_EQ(1, errors_count);
+
+    framer.reset();
+    framer.on_receive(connection, make_chunk(std::string("\x00\x00\x00\x01" "a", 5)));
+    EXPECT_EQ(2, frames_count);
+    EXPECT_EQ(1, errors_count);
+}
+
+TEST_F(FramedConnectionTest, reassembly_buffer_reuse) {
+    FakeConnection connection;
+
+    std::vector<io::DataChunk> frames;
+    bool retain_frames = false;
+    Framer framer([&](FakeConnection&, const io::DataChunk& frame, const io::Error& error) {
+        EXPECT_FALSE(error);
+        frames.push_back(retain_frames ? frame : io::DataChunk(nullptr, frame.size, reinterpret_cast<std::size_t>(frame.buf.get())));
+    });
+
+    const std::string frame = std::string("\x00\x00\x00\x04" "abcd", 8);
+    for (std::size_t i = 0; i < 4; ++i) {
+        retain_frames = i >= 2;
+        framer.on_receive(connection, make_chunk(frame.substr(0, 5)));
+        framer.on_receive(connection, make_chunk(frame.substr(5)));
+    }
+
+    ASSERT_EQ(4, frames.size());
+    EXPECT_EQ(4, framer.reassembled_frames_count());
+
+    // Not retained frames use the same buffer
+    EXPECT_EQ(frames[0].offset, frames[1].offset);
+    EXPECT_EQ(frames[1].offset, reinterpret_cast<std::size_t>(frames[2].buf.get()));
+
+    // Retained frame is not overwritten
+    EXPECT_NE(frames[2].buf.get(), frames[3].buf.get());
+    EXPECT_EQ("abcd", std::string(frames[2].buf.get(), frames[2].size));
+    EXPECT_EQ("abcd", std::string(frames[3].buf.get(), frames[3].size));
+}
+
+TEST_F(FramedConnectionTest, reset_from_callback) {
+    FakeConnection connection;
+
+    std::vector<std::string> frames;
+    Framer* framer_ptr = nullptr;
+    Framer framer([&](FakeConnection&, const io::DataChunk& frame, const io::Error& error) {
+        EXPECT_FALSE(error);
+        frames.emplace_back(frame.buf.get(), frame.size);
+        framer_ptr->reset();
+    },
+    1);
+    framer_ptr = &framer;
+
+    framer.on_receive(connection, make_chunk(std::string("\x01" "a" "\x01" "b", 4)));
+    ASSERT_EQ(1, frames.size());
+    EXPECT_EQ("a", frames[0]);
+
+    framer.on_receive(connection, make_chunk(std::string("\x01" "c", 2)));
+    ASSERT_EQ(2, frames.size());
+    EXPECT_EQ("c", frames[1]);
+}
+
+TEST_F(FramedConnectionTest, tcp_echo) {
+    // Server sends received frames back without copying, client checks them
+    const std::size_t FRAMES_COUNT = 200;
+
+    std::vector<std::string> messages;
+    for (std::size_t i = 0; i < FRAMES_COUNT; ++i) {
+        messages.emplace_back((i * 997) % 70000, static_cast<char>('a' + i % 26));
+    }
+
+    io::EventLoop loop;
+
+    std::size_t server_frames_count = 0;
+    std::size_t client_frames_count = 0;
+
+    io::FramedConnection<io::TcpConnectedClient> server_framer(
+        [&](io::TcpConnectedClient& client, const io::DataChunk& frame, const io::Error& error) {
+            EXPECT_FALSE(error);
+            ++server_frames_count;
+            server_framer.send_frame(client, frame.buf, static_cast<std::uint32_t>(frame.size));
+        });
+
+    auto server = new io::TcpServer(loop);
+    auto listen_error = server->listen({"0.0.0.0", m_default_port},
+        nullptr,
+        [&](io::TcpConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error);
+            server_framer.on_receive(client, data);
+        },
+        nullptr
+    );
+    ASSERT_FALSE(listen_error);
+
+    io::FramedConnection<io::TcpClient> client_framer(
+        [&](io::TcpClient& client, const io::DataChunk& frame, const io::Error& error) {
+            EXPECT_FALSE(error);
+            ASSERT_LT(client_frames_count, FRAMES_COUNT);
+            EXPECT_EQ(messages[client_frames_count].size(), frame.size);
+            EXPECT_TRUE(messages[client_frames_count] == std::string(frame.buf ? frame.buf.get() : "", frame.size)) << client_frames_count;
+            ++client_frames_count;
+
+            if (client_frames_count == FRAMES_COUNT) {
+                client.schedule_removal();
+                server->schedule_removal();
+            }
+        });
+
+    auto client = new io::TcpClient(loop);
+    client->connect({m_default_addr, m_default_port},
+        [&](io::TcpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error);
+            for (const auto& message : messages) {
+                client_framer.send_frame(client, message);
+            }
+        },
+        [&](io::TcpClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error);
+            client_framer.on_receive(client, data);
+        }
+    );
+
+    ASSERT_EQ(0, loop.run());
+
+    EXPECT_EQ(FRAMES_COUNT, server_frames_count);
+    EXPECT_EQ(FRAMES_COUNT, client_frames_count);
+    EXPECT_LT(0, server_framer.zero_copy_frames_count());
+    EXPECT_LT(0, server_framer.reassembled_frames_count());
+}
@@ -0,0 +1,282 @@
+#include "UTCommon.h"
+
+#include "io/detail/PeerTable.h"
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+struct PeerTableTest : public testing::Test,
+                       public LogRedirector {
+
+protected:
+    // Sequential IPv4 addresses and ports as they are stored in PeerId (network byte order is not important here)
+    static io::detail::PeerId ipv4_peer(std::uint32_t address, std::uint16_t port) {
+        return io::detail::PeerId(0, address, port);
+    }
+
+    // 16 ports per address
+    static std::vector<io::detail::PeerId> sequential_peers(std::uint32_t count) {
+        std::vector<io::detail::PeerId> peers;
+        peers.reserve(count);
+        for (std::uint32_t i = 0; i < count; ++i) {
+            peers.push_back(ipv4_peer(0x0A000000 + i / 16, static_cast<std::uint16_t>(50000 + i % 16)));
+        }
+        return peers;
+    }
+};
+
+TEST_F(PeerTableTest, default_constructor) {
+    io::detail::PeerTable<int> table;
+    EXPECT_EQ(0, table.size());
+    EXPECT_TRUE(table.empty());
+    EXPECT_EQ(nullptr, table.find(ipv4_peer(1, 1)));
+    EXPECT_FALSE(table.erase(ipv4_peer(1, 1)));
+}
+
+TEST_F(PeerTableTest, insert_find_erase) {
+    io::detail::PeerTable<int> table;
+
+    auto result = table.insert(ipv4_peer(0x7F000001, 1234));
+    ASSERT_TRUE(result.second);
+    ASSERT_NE(nullptr, result.first);
+    EXPECT_EQ(0, *result.first);
+    *result.first = 42;
+
+    EXPECT_EQ(1, table.size());
+    EXPECT_FALSE(table.empty());
+
+    result = table.insert(ipv4_peer(0x7F000001, 1234));
+    EXPECT_FALSE(result.second);
+    EXPECT_EQ(42, *result.first);
+    EXPECT_EQ(1, table.size());
+
+    ASSERT_NE(nullptr, table.find(ipv4_peer(0x7F000001, 1234)));
+    EXPECT_EQ(42, *table.find(ipv4_peer(0x7F000001, 1234)));
+    EXPECT_EQ(nullptr, table.find(ipv4_peer(0x7F000001, 1235)));
+    EXPECT_EQ(nullptr, table.find(ipv4_peer(0x7F000002, 1234)));
+    EXPECT_EQ(nullptr, table.find(io::detail::PeerId(1, 0x7F000001, 1234)));
+
+    EXPECT_TRUE(table.erase(ipv4_peer(0x7F000001, 1234)));
+    EXPECT_FALSE(table.erase(ipv4_peer(0x7F000001, 1234)));
+    EXPECT_EQ(nullptr, table.find(ipv4_peer(0x7F000001, 1234)));
+    EXPECT_EQ(0, table.size());
+}
+
+TEST_F(PeerTableTest, grow) {
+    const std::uint32_t COUNT = 10000;
+
+    io::detail::PeerTable<std::uint32_t> table;
+    for (std::uint32_t i = 0; i < COUNT; ++i) {
+        *table.insert(ipv4_peer(i, static_cast<std::uint16_t>(i))).first = i;
+    }
+
+    EXPECT_EQ(COUNT, table.size());
+    EXPECT_LE(COUNT, table.capacity());
+
+    for (std::uint32_t i = 0; i < COUNT; ++i) {
+        auto value = table.find(ipv4_peer(i, static_cast<std::uint16_t>(i)));
+        ASSERT_NE(nullptr, value) << i;
+        EXPECT_EQ(i, *value);
+    }
+}
+
+TEST_F(PeerTableTest, reserve) {
+    io::detail::PeerTable<int> table;
+    table.reserve(1000);
+    const auto capacity = table.capacity();
+    EXPECT_LE(1000, capacity);
+
+    for (std::uint32_t i = 0; i < 1000; ++i) {
+        table.insert(ipv4_peer(i, 1));
+    }
+
+    EXPECT_EQ(capacity, table.capacity());
+}
+
+TEST_F(PeerTableTest, erase_keeps_other_entries_reachable) {
+    // Many insertions and removals in a small table produce long probe sequences,
+    // removal should move entries backward without breaking them.
+    const std::uint32_t COUNT = 5000;
+
+    io::detail::PeerTable<std::uint32_t> table;
+    std::unordered_set<std::uint32_t> expected;
+
+    for (std::uint32_t i = 0; i < COUNT; ++i) {
+        *table.insert(ipv4_peer(i, 80)).first = i;
+        expected.insert(i);
+
+        if (i % 3 == 0) {
+            const std::uint32_t removed = i / 2;
+            const bool was_present = expected.erase(removed) != 0;
+            EXPECT_EQ(was_present, table.erase(ipv4_peer(removed, 80)));
+        }
+    }
+
+    EXPECT_EQ(expected.size(), table.size());
+
+    for (std::uint32_t i = 0; i < COUNT; ++i) {
+        auto value = table.find(ipv4_peer(i, 80));
+        if (expected.count(i)) {
+            ASSERT_NE(nullptr, value) << i;
+            EXPECT_EQ(i, *value);
+        } else {
+            EXPECT_EQ(nullptr, value) << i;
+        }
+    }
+
+    for (auto i : expected) {
+        EXPECT_TRUE(table.erase(ipv4_peer(i, 80)));
+    }
+
+    EXPECT_TRUE(table.empty());
+}
+
+TEST_F(PeerTableTest, for_each) {
+    io::detail::PeerTable<int> table;
+    for (std::uint32_t i = 0; i < 100; ++i) {
+        *table.insert(ipv4_peer(i, 1)).first = 1;
+    }
+
+    std::size_t counter = 0;
+    int sum = 0;
+    table.for_each([&](const io::detail::PeerId& id, int& value) {
+        EXPECT_EQ(1, id.port);
+        sum += value;
+        ++counter;
+    });
+
+    EXPECT_EQ(100, counter);
+    EXPECT_EQ(100, sum);
+}
+
+TEST_F(PeerTableTest, clear) {
+    io::detail::PeerTable<std::unique_ptr<int>> table;
+    for (std::uint32_t i = 0; i < 100; ++i) {
+        table.insert(ipv4_peer(i, 1)).first->reset(new int(1));
+    }
+
+    const auto capacity = table.capacity();
+
+    table.clear();
+    EXPECT_TRUE(table.empty());
+    EXPECT_EQ(capacity, table.capacity());
+    EXPECT_EQ(nullptr, table.find(ipv4_peer(0, 1)));
+
+    auto result = table.insert(ipv4_peer(0, 1));
+    EXPECT_TRUE(result.second);
+    EXPECT_EQ(nullptr, result.first->get());
+}
+
+TEST_F(PeerTableTest, move) {
+    io::detail::PeerTable<int> table_1;
+    *table_1.insert(ipv4_peer(1, 1)).first = 1;
+
+    io::detail::PeerTable<int> table_2(std::move(table_1));
+    EXPECT_EQ(0, table_1.size());
+    EXPECT_EQ(nullptr, table_1.find(ipv4_peer(1, 1)));
+    ASSERT_NE(nullptr, table_2.find(ipv4_peer(1, 1)));
+    EXPECT_EQ(1, *table_2.find(ipv4_peer(1, 1)));
+
+    // Moved from table is usable
+    *table_1.insert(ipv4_peer(2, 2)).first = 2;
+    EXPECT_EQ(1, table_1.size());
+
+    table_2 = std::move(table_1);
+    EXPECT_EQ(1, table_2.size());
+    EXPECT_EQ(nullptr, table_2.find(ipv4_peer(1, 1)));
+    ASSERT_NE(nullptr, table_2.find(ipv4_peer(2, 2)));
+    EXPECT_EQ(2, *table_2.find(ipv4_peer(2, 2)));
+}
+
+TEST_F(PeerTableTest, hash_of_swapped_address_and_port) {
+    // XOR of hashes of fields gave the same value for peers with swapped address and port
+    const io::detail::PeerId peer_1(0, 0x1234, 0x5678);
+    const io::detail::PeerId peer_2(0, 0x5678, 0x1234);
+    EXPECT_NE(io::detail::hash_value(peer_1), io::detail::hash_value(peer_2));
+
+    const io::detail::PeerId peer_3(0x1234, 0x5678, 0);
+    const io::detail::PeerId peer_4(0x5678, 0x1234, 0);
+    EXPECT_NE(io::detail::hash_value(peer_3), io::detail::hash_value(peer_4));
+}
+
+TEST_F(PeerTableTest, hash_distribution) {
+    // Peers from the same subnet with a few ports are typical for servers
+    const std::size_t BUCKETS_COUNT = 1024;
+    std::vector<std::size_t> buckets(BUCKETS_COUNT, 0);
+
+    for (std::uint32_t address = 0; address < 256; ++address) {
+        for (std::uint16_t port = 0; port < 64; ++port) {
+            ++buckets[io::detail::hash_value(ipv4_peer(0xC0A80000 + address, 40000 + port)) % BUCKETS_COUNT];
+        }
+    }
+
+    // 16 items per bucket on average
+    for (std::size_t i = 0; i < BUCKETS_COUNT; ++i) {
+        EXPECT_GT(48u, buckets[i]) << i;
+    }
+}
+
+TEST_F(PeerTableTest, lookup_many_peers) {
+    const std::uint32_t COUNT = 20000;
+
+    const auto peers = sequential_peers(COUNT);
+
+    io::detail::PeerTable<std::uint32_t> table;
+    std::unordered_map<io::detail::PeerId, std::uint32_t> map;
+    for (std::uint32_t i = 0; i < COUNT; ++i) {
+        *table.insert(peers[i]).first = i;
+        map[peers[i]] = i;
+    }
+
+    ASSERT_EQ(COUNT, table.size());
+    ASSERT_EQ(map.size(), table.size());
+
+    for (std::uint32_t i = 0; i < COUNT; ++i) {
+        const auto value = table.find(peers[i]);
+        ASSERT_NE(nullptr, value) << i;
+        ASSERT_EQ(map.find(peers[i])->second, *value) << i;
+    }
+
+    EXPECT_EQ(nullptr, table.find(ipv4_peer(0x0B000000, 50000)));
+}
+
+// Timing comparison with std::unordered_map, not a part of the regular run
+TEST_F(PeerTableTest, DISABLED_lookup_1m_peers_benchmark) {
+    const std::uint32_t COUNT = 1000000;
+
+    const auto peers = sequential_peers(COUNT);
+
+    io::detail::PeerTable<std::uint32_t> table;
+    std::unordered_map<io::detail::PeerId, std::uint32_t> map;
+    for (std::uint32_t i = 0; i < COUNT; ++i) {
+        *table.insert(peers[i]).first = i;
+        map[peers[i]] = i;
+    }
+
+    std::uint64_t table_sum = 0;
+    const auto table_start = std::chrono::high_resolution_clock::now();
+    for (std::uint32_t i = 0; i < COUNT; ++i) {
+        table_sum += *table.find(peers[i]);
+    }
+    const auto table_end = std::chrono::high_resolution_clock::now();
+
+    std::uint64_t map_sum = 0;
+    const auto map_start = std::chrono::high_resolution_clock::now();
+    for (std::uint32_t i = 0; i < COUNT; ++i) {
+        map_sum += map.find(peers[i])->second;
+    }
+    const auto map_end = std::chrono::high_resolution_clock::now();
+
+    const std::uint64_t expected_sum = std::uint64_t(COUNT) * (COUNT - 1) / 2;
+    EXPECT_EQ(expected_sum, table_sum);
+    EXPECT_EQ(expected_sum, map_sum);
+
+    std::cout << "PeerTable: " << std::chrono::duration_cast<std::chrono::milliseconds>(table_end - table_start).count()
+              << " ms, unordered_map: " << std::chrono::duration_cast<std::chrono::milliseconds>(map_end - map_start).count()
+              << " ms for " << COUNT << " lookups" << std::endl;
+}
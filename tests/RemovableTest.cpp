@@ -105,3 +105,109 @@ TEST_F(RemovableTest, change_callback_after_schedule_removal) {
     EXPECT_EQ(0, callback_1_counter);
     EXPECT_EQ(1, callback_2_counter);
 }
+
+namespace {
+
+class CountingRemovable : public io::Removable {
+public:
+    CountingRemovable(io::EventLoop& loop, std::size_t& destroyed_counter, io::Removable* next = nullptr) :
+        Removable(loop),
+        m_destroyed_counter(destroyed_counter),
+        m_next(next) {
+    }
+
+protected:
+    ~CountingRemovable() {
+        ++m_destroyed_counter;
+
+        if (m_next) {
+            m_next->schedule_removal();
+        }
+    }
+
+private:
+    std::size_t& m_destroyed_counter;
+    io::Removable* m_next = nullptr;
+};
+
+} // namespace
+
+TEST_F(RemovableTest, many_objects) {
+    io::EventLoop loop;
+
+    const std::size_t OBJECTS_COUNT = 50000;
+    std::size_t destroyed_counter = 0;
+    std::size_t callbacks_counter = 0;
+
+    for (std::size_t i = 0; i < OBJECTS_COUNT; ++i) {
+        auto removable = new CountingRemovable(loop, destroyed_counter);
+        removable->set_on_schedule_removal([&](const io::Removable&) {
+            ++callbacks_counter;
+        });
+        removable->schedule_removal();
+    }
+
+    EXPECT_EQ(OBJECTS_COUNT, loop.pending_removals_count());
+
+    ASSERT_EQ(0, loop.run());
+
+    EXPECT_EQ(OBJECTS_COUNT, callbacks_counter);
+    EXPECT_EQ(OBJECTS_COUNT, destroyed_counter);
+    EXPECT_EQ(0, loop.pending_removals_count());
+}
+
+TEST_F(RemovableTest, double_schedule_removal) {
+    io::EventLoop loop;
+
+    std::size_t destroyed_counter = 0;
+
+    auto removable = new CountingRemovable(loop, destroyed_counter);
+    removable->schedule_removal();
+    removable->schedule_removal();
+
+    EXPECT_EQ(1, loop.pending_removals_count());
+
+    ASSERT_EQ(0, loop.run());
+
+    EXPECT_EQ(1, destroyed_counter);
+}
+
+TEST_F(RemovableTest, object_is_valid_in_callbacks_of_the_same_loop_cycle) {
+    io::EventLoop loop;
+
+    std::size_t destroyed_counter = 0;
+    std::size_t callbacks_counter = 0;
+
+    auto removable = new CountingRemovable(loop, destroyed_counter);
+    removable->schedule_removal();
+
+    loop.schedule_callback([&]() {
+        EXPECT_EQ(0, destroyed_counter);
+        EXPECT_TRUE(removable->is_removal_scheduled());
+        ++callbacks_counter;
+    });
+
+    ASSERT_EQ(0, loop.run());
+
+    EXPECT_EQ(1, callbacks_counter);
+    EXPECT_EQ(1, destroyed_counter);
+}
+
+TEST_F(RemovableTest, schedule_removal_from_destructor) {
+    io::EventLoop loop;
+
+    const std::size_t OBJECTS_COUNT = 10;
+    std::size_t destroyed_counter = 0;
+
+    // Each object schedules removal of the next one in the chain when it is destroyed
+    io::Removable* next = nullptr;
+    for (std::size_t i = 0; i < OBJECTS_COUNT; ++i) {
+        next = new CountingRemovable(loop, destroyed_counter, next);
+    }
+    next->schedule_removal();
+
+    ASSERT_EQ(0, loop.run());
+
+    EXPECT_EQ(OBJECTS_COUNT, destroyed_counter);
+    EXPECT_EQ(0, loop.pending_removals_count());
+}
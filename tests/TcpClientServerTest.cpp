@@ -1,13 +1,20 @@
 #include "UTCommon.h"
 
+#include "io/File.h"
+#include "io/ShardedTcpServer.h"
 #include "io/TcpClient.h"
 #include "io/TcpServer.h"
 #include "io/ScopeExitGuard.h"
 #include "io/Timer.h"
 
+#include <atomic>
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <memory>
+#include <mutex>
+#include <set>
 #include <thread>
 #include <vector>
 
@@ -114,6 +121,36 @@ TEST_F(TcpClientServerTest, server_address_in_use) {
     ASSERT_EQ(0, loop.run());
 }
 
+#if defined(__APPLE__) || defined(__linux__)
+TEST_F(TcpClientServerTest, server_reuse_port) {
+    io::EventLoop loop;
+
+    auto server_1 = new io::TcpServer(loop);
+    EXPECT_FALSE(server_1->is_reuse_port());
+    server_1->reuse_port(true);
+    EXPECT_TRUE(server_1->is_reuse_port());
+    auto listen_error_1 = server_1->listen({m_default_addr, m_default_port}, nullptr, nullptr, nullptr);
+    EXPECT_FALSE(listen_error_1) << listen_error_1.string();
+
+    auto server_2 = new io::TcpServer(loop);
+    server_2->reuse_port(true);
+    auto listen_error_2 = server_2->listen({m_default_addr, m_default_port}, nullptr, nullptr, nullptr);
+    EXPECT_FALSE(listen_error_2) << listen_error_2.string();
+
+    // All sockets bound to the same endpoint should have SO_REUSEPORT set
+    auto server_3 = new io::TcpServer(loop);
+    auto listen_error_3 = server_3->listen({m_default_addr, m_default_port}, nullptr, nullptr, nullptr);
+    EXPECT_TRUE(listen_error_3);
+    EXPECT_EQ(io::StatusCode::ADDRESS_ALREADY_IN_USE, listen_error_3.code());
+
+    server_1->schedule_removal();
+    server_2->schedule_removal();
+    server_3->schedule_removal();
+
+    ASSERT_EQ(0, loop.run());
+}
+#endif
+
 TEST_F(TcpClientServerTest, client_connect_to_invalid_address) {
     io::EventLoop loop;
 
@@ -351,144 +388,1271 @@ TEST_F(TcpClientServerTest, server_sends_data_first) {
         EXPECT_EQ(std::string(data.buf.get(), data.size), message);
         data_received = true;
 
-        client.send_data("shutdown", [&](io::TcpClient& client, const io::Error& error) {
-            EXPECT_FALSE(error);
-            client.schedule_removal();
-        });
+        client.send_data("shutdown", [&](io::TcpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error);
+            client.schedule_removal();
+        });
+    });
+
+    ASSERT_EQ(0, loop.run());
+    EXPECT_TRUE(data_sent);
+    EXPECT_TRUE(data_received);
+}
+
+TEST_F(TcpClientServerTest, multiple_data_chunks_sent_in_a_row_by_client) {
+    // Note: in this test verifying that data send is queued and delivered in order
+
+    const std::size_t CHUNK_SIZE = 65536;
+    const std::size_t CHUNKS_COUNT = 20;
+    const std::size_t TOTAL_BYTES = CHUNK_SIZE * CHUNKS_COUNT;
+
+    ASSERT_EQ(0, CHUNK_SIZE % sizeof(std::uint32_t));
+
+    std::thread server_thread([this, TOTAL_BYTES]() {
+        io::EventLoop loop;
+        auto server = new io::TcpServer(loop);
+
+        std::size_t bytes_received = 0;
+
+        std::vector<unsigned char> total_bytes_received;
+
+        auto listen_error = server->listen({"0.0.0.0", m_default_port},
+        [&](io::TcpConnectedClient& client, const io::Error& error) {
+            EXPECT_FALSE(error);
+        },
+        [&](io::TcpConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+            total_bytes_received.insert(total_bytes_received.end(), data.buf.get(), data.buf.get() + data.size);
+            bytes_received += data.size;
+            if (bytes_received >= TOTAL_BYTES) {
+                server->schedule_removal();
+            }
+        },
+        nullptr);
+        EXPECT_FALSE(listen_error);
+
+        EXPECT_EQ(0, loop.run());
+        EXPECT_EQ(TOTAL_BYTES, bytes_received);
+        EXPECT_EQ(TOTAL_BYTES, total_bytes_received.size());
+        for (std::size_t i = 0; i < total_bytes_received.size(); i += 4) {
+            ASSERT_EQ(i / 4, *reinterpret_cast<std::uint32_t*>((&total_bytes_received[0] + i)));
+        }
+    });
+
+    std::thread client_thread([this, CHUNK_SIZE, CHUNKS_COUNT]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+        std::size_t counter = 0;
+        std::function<void(io::TcpClient&, const io::Error&)> on_data_sent = [&](io::TcpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error);
+            if (++counter == CHUNKS_COUNT) {
+                client.schedule_removal();
+            }
+        };
+
+        io::EventLoop loop;
+        auto client = new io::TcpClient(loop);
+        client->connect({m_default_addr, m_default_port}, [&](io::TcpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error);
+
+            for (size_t i = 0; i < CHUNKS_COUNT; ++i) {
+                std::shared_ptr<char> buf(new char[CHUNK_SIZE], [](const char* p) { delete[] p; });
+                for (std::size_t k = 0; k < CHUNK_SIZE; k += 4) {
+                    (*reinterpret_cast<std::uint32_t*>(buf.get() + k) ) = k / 4 + i * CHUNK_SIZE / 4;
+                }
+                client.send_data(buf, CHUNK_SIZE, on_data_sent);
+            }
+        },
+        nullptr);
+
+        EXPECT_EQ(0, loop.run());
+    });
+
+    io::ScopeExitGuard guard([&server_thread, &client_thread](){
+        client_thread.join();
+        server_thread.join();
+    });
+}
+
+TEST_F(TcpClientServerTest, null_send_buf) {
+    io::EventLoop loop;
+
+    std::shared_ptr<char> buf;
+
+    std::size_t server_on_send_count = 0;
+    std::size_t client_on_send_count = 0;
+
+    auto server = new io::TcpServer(loop);
+    auto listen_error = server->listen({"0.0.0.0", m_default_port},
+        [&](io::TcpConnectedClient& client, const io::Error& error) {
+            EXPECT_FALSE(error);
+
+            client.send_data(buf, 1,
+                [&](io::TcpConnectedClient& client, const io::Error& error) {
+                    EXPECT_TRUE(error);
+                    EXPECT_EQ(io::StatusCode::INVALID_ARGUMENT, error.code());
+                    ++server_on_send_count;
+                    server->schedule_removal();
+                }
+            );
+        },
+        nullptr,
+        nullptr
+    );
+    ASSERT_FALSE(listen_error);
+
+    bool data_sent = false;
+
+    auto client = new io::TcpClient(loop);
+    client->connect({m_default_addr, m_default_port},
+        [&](io::TcpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error);
+
+            client.send_data(buf, 1,
+                [&](io::TcpClient& client, const io::Error& error) {
+                    EXPECT_TRUE(error);
+                    EXPECT_EQ(io::StatusCode::INVALID_ARGUMENT, error.code());
+                    ++client_on_send_count;
+                    client.schedule_removal();
+                }
+            );
+        },
+        nullptr
+    );
+
+    EXPECT_EQ(0, server_on_send_count);
+    EXPECT_EQ(0, client_on_send_count);
+
+    ASSERT_EQ(0, loop.run());
+
+    EXPECT_EQ(1, server_on_send_count);
+    EXPECT_EQ(1, client_on_send_count);
+}
+
+TEST_F(TcpClientServerTest, send_data_chunks) {
+    // Note: header and payload live in different buffers and are sent by a single write
+    io::EventLoop loop;
+
+    const std::string header = "HEADER:";
+    const std::string payload = "__payload__";
+    const std::string expected_message = "HEADER:payload";
+
+    std::shared_ptr<char> header_buf(new char[header.size()], [](const char* p) { delete[] p; });
+    std::copy(header.begin(), header.end(), header_buf.get());
+    std::shared_ptr<char> payload_buf(new char[payload.size()], [](const char* p) { delete[] p; });
+    std::copy(payload.begin(), payload.end(), payload_buf.get());
+    // Part of the buffer shares ownership of it
+    const std::shared_ptr<const char> payload_part(payload_buf, payload_buf.get() + 2);
+
+    std::size_t server_on_send_count = 0;
+    std::size_t client_on_send_count = 0;
+    std::string server_received_message;
+    std::string client_received_message;
+
+    auto server = new io::TcpServer(loop);
+    auto listen_error = server->listen({"0.0.0.0", m_default_port},
+        [&](io::TcpConnectedClient& client, const io::Error& error) {
+            EXPECT_FALSE(error);
+        },
+        [&](io::TcpConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error);
+            server_received_message.append(data.buf.get(), data.size);
+            if (server_received_message.size() < expected_message.size()) {
+                return;
+            }
+
+            client.send_data({{header_buf, header.size()}, {payload_part, 7}},
+                [&](io::TcpConnectedClient& client, const io::Error& error) {
+                    EXPECT_FALSE(error);
+                    ++server_on_send_count;
+                }
+            );
+        },
+        nullptr
+    );
+    ASSERT_FALSE(listen_error);
+
+    auto client = new io::TcpClient(loop);
+    client->connect({m_default_addr, m_default_port},
+        [&](io::TcpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error);
+
+            std::vector<io::DataChunk> chunks;
+            chunks.emplace_back(header_buf, header.size());
+            chunks.emplace_back(nullptr, 0); // Skipped
+            chunks.emplace_back(payload_part, 7);
+
+            client.send_data(std::move(chunks),
+                [&](io::TcpClient& client, const io::Error& error) {
+                    EXPECT_FALSE(error);
+                    ++client_on_send_count;
+                }
+            );
+            EXPECT_EQ(1, client.pending_write_requesets());
+        },
+        [&](io::TcpClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error);
+            client_received_message.append(data.buf.get(), data.size);
+            if (client_received_message.size() >= expected_message.size()) {
+                client.schedule_removal();
+                server->schedule_removal();
+            }
+        }
+    );
+
+    ASSERT_EQ(0, loop.run());
+
+    EXPECT_EQ(1, server_on_send_count);
+    EXPECT_EQ(1, client_on_send_count);
+    EXPECT_EQ(expected_message, server_received_message);
+    EXPECT_EQ(expected_message, client_received_message);
+}
+
+TEST_F(TcpClientServerTest, echo_received_chunks_by_send_data_chunks) {
+    // Offset of received chunk is the position in the stream, it does not affect sent data
+    io::EventLoop loop;
+
+    const std::string first_message = "first";
+    const std::string second_message = "second";
+
+    std::size_t server_on_send_count = 0;
+    std::size_t second_chunk_offset = 0;
+    std::string client_received_message;
+
+    auto server = new io::TcpServer(loop);
+    auto listen_error = server->listen({"0.0.0.0", m_default_port},
+        [&](io::TcpConnectedClient& client, const io::Error& error) {
+            EXPECT_FALSE(error);
+        },
+        [&](io::TcpConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error);
+            if (data.offset) {
+                second_chunk_offset = data.offset;
+            }
+
+            client.send_data({data},
+                [&](io::TcpConnectedClient& client, const io::Error& error) {
+                    EXPECT_FALSE(error);
+                    ++server_on_send_count;
+                }
+            );
+        },
+        nullptr
+    );
+    ASSERT_FALSE(listen_error);
+
+    auto client = new io::TcpClient(loop);
+    client->connect({m_default_addr, m_default_port},
+        [&](io::TcpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error);
+            client.send_data(first_message);
+        },
+        [&](io::TcpClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error);
+            client_received_message.append(data.buf.get(), data.size);
+            if (client_received_message == first_message) {
+                client.send_data(second_message);
+            } else if (client_received_message.size() >= first_message.size() + second_message.size()) {
+                client.schedule_removal();
+                server->schedule_removal();
+            }
+        }
+    );
+
+    ASSERT_EQ(0, loop.run());
+
+    EXPECT_EQ(2, server_on_send_count);
+    EXPECT_EQ(first_message.size(), second_chunk_offset);
+    EXPECT_EQ(first_message + second_message, client_received_message);
+}
+
+TEST_F(TcpClientServerTest, send_data_chunks_invalid_arguments) {
+    io::EventLoop loop;
+
+    std::shared_ptr<char> buf(new char[4], [](const char* p) { delete[] p; });
+
+    std::size_t client_on_send_count = 0;
+
+    auto server = new io::TcpServer(loop);
+    auto listen_error = server->listen({"0.0.0.0", m_default_port},
+        [&](io::TcpConnectedClient& client, const io::Error& error) {
+            EXPECT_FALSE(error);
+        },
+        nullptr,
+        nullptr
+    );
+    ASSERT_FALSE(listen_error);
+
+    auto on_send = [&](io::TcpClient& client, const io::Error& error) {
+        EXPECT_EQ(io::StatusCode::INVALID_ARGUMENT, error.code());
+        ++client_on_send_count;
+    };
+
+    auto client = new io::TcpClient(loop);
+
+    client->send_data({{buf, 4}}, [&](io::TcpClient& client, const io::Error& error) {
+        EXPECT_EQ(io::StatusCode::NOT_CONNECTED, error.code());
+        ++client_on_send_count;
+    });
+
+    client->connect({m_default_addr, m_default_port},
+        [&](io::TcpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error);
+
+            client.send_data(std::vector<io::DataChunk>(), on_send);
+            client.send_data({{buf, 0}, {nullptr, 0}}, on_send);
+            client.send_data({{buf, 4}, {nullptr, 1}}, on_send);
+            EXPECT_EQ(0, client.pending_write_requesets());
+
+            client.schedule_removal();
+            server->schedule_removal();
+        },
+        nullptr
+    );
+
+    ASSERT_EQ(0, loop.run());
+
+    EXPECT_EQ(4, client_on_send_count);
+}
+
+TEST_F(TcpClientServerTest, cork_send) {
+    // Note: 300 sends are more than fits to a single corked write, order of data and callbacks should be preserved
+    io::EventLoop loop;
+
+    const std::size_t SENDS_COUNT = 300;
+
+    std::string expected_message;
+    for (std::size_t i = 0; i < SENDS_COUNT; ++i) {
+        expected_message += std::to_string(i) + ";";
+    }
+
+    std::string server_received_message;
+    std::size_t client_on_send_count = 0;
+    std::size_t server_on_send_count = 0;
+    std::string client_received_message;
+
+    auto server = new io::TcpServer(loop);
+    auto listen_error = server->listen({"0.0.0.0", m_default_port},
+        [&](io::TcpConnectedClient& client, const io::Error& error) {
+            EXPECT_FALSE(error);
+            EXPECT_FALSE(client.is_cork_send());
+        },
+        [&](io::TcpConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error);
+            server_received_message.append(data.buf.get(), data.size);
+            if (server_received_message.size() < expected_message.size()) {
+                return;
+            }
+
+            client.cork_send(true);
+            client.send_data("Hello ", [&](io::TcpConnectedClient& client, const io::Error& error) {
+                EXPECT_FALSE(error);
+                EXPECT_EQ(0, server_on_send_count);
+                ++server_on_send_count;
+            });
+            client.send_data(std::string("client!"), [&](io::TcpConnectedClient& client, const io::Error& error) {
+                EXPECT_FALSE(error);
+                EXPECT_EQ(1, server_on_send_count);
+                ++server_on_send_count;
+            });
+            EXPECT_EQ(2, client.pending_write_requesets());
+
+            // Disabling writes corked data immediately
+            client.cork_send(false);
+            EXPECT_FALSE(client.is_cork_send());
+        },
+        nullptr
+    );
+    ASSERT_FALSE(listen_error);
+
+    auto client = new io::TcpClient(loop);
+    EXPECT_FALSE(client->is_cork_send());
+    client->cork_send(true);
+    EXPECT_TRUE(client->is_cork_send());
+
+    client->connect({m_default_addr, m_default_port},
+        [&](io::TcpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error);
+
+            for (std::size_t i = 0; i < SENDS_COUNT; ++i) {
+                client.send_data(std::to_string(i) + ";", [&, i](io::TcpClient& client, const io::Error& error) {
+                    EXPECT_FALSE(error);
+                    EXPECT_EQ(i, client_on_send_count);
+                    ++client_on_send_count;
+                });
+            }
+
+            EXPECT_EQ(0, client_on_send_count);
+        },
+        [&](io::TcpClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error);
+            client_received_message.append(data.buf.get(), data.size);
+            if (client_received_message == "Hello client!") {
+                client.schedule_removal();
+                server->schedule_removal();
+            }
+        }
+    );
+
+    ASSERT_EQ(0, loop.run());
+
+    EXPECT_EQ(SENDS_COUNT, client_on_send_count);
+    EXPECT_EQ(2, server_on_send_count);
+    EXPECT_EQ(expected_message, server_received_message);
+    EXPECT_EQ("Hello client!", client_received_message);
+}
+
+TEST_F(TcpClientServerTest, cork_send_data_chunks_and_close) {
+    io::EventLoop loop;
+
+    const std::string header = "HEADER:";
+    const std::string payload = "payload";
+
+    std::shared_ptr<char> header_buf(new char[header.size()], [](const char* p) { delete[] p; });
+    std::copy(header.begin(), header.end(), header_buf.get());
+    std::shared_ptr<char> payload_buf(new char[payload.size()], [](const char* p) { delete[] p; });
+    std::copy(payload.begin(), payload.end(), payload_buf.get());
+
+    std::string server_received_message;
+    std::size_t client_on_send_count = 0;
+
+    auto server = new io::TcpServer(loop);
+    auto listen_error = server->listen({"0.0.0.0", m_default_port},
+        [&](io::TcpConnectedClient& client, const io::Error& error) {
+            EXPECT_FALSE(error);
+        },
+        [&](io::TcpConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error);
+            server_received_message.append(data.buf.get(), data.size);
+        },
+        [&](io::TcpConnectedClient& client, const io::Error& error) {
+            server->schedule_removal();
+        }
+    );
+    ASSERT_FALSE(listen_error);
+
+    auto client = new io::TcpClient(loop);
+    client->cork_send(true);
+    client->connect({m_default_addr, m_default_port},
+        [&](io::TcpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error);
+
+            client.send_data({{header_buf, header.size()}, {payload_buf, payload.size()}},
+                [&](io::TcpClient& client, const io::Error& error) {
+                    ++client_on_send_count;
+                }
+            );
+            client.send_data({{nullptr, 1}}, [&](io::TcpClient& client, const io::Error& error) {
+                EXPECT_EQ(io::StatusCode::INVALID_ARGUMENT, error.code());
+                ++client_on_send_count;
+            });
+            EXPECT_EQ(1, client.pending_write_requesets());
+
+            // Corked data is written before connection is closed
+            client.schedule_removal();
+        },
+        nullptr
+    );
+
+    ASSERT_EQ(0, loop.run());
+
+    EXPECT_EQ(2, client_on_send_count);
+    EXPECT_EQ(header + payload, server_received_message);
+}
+
+TEST_F(TcpClientServerTest, write_watermarks) {
+    io::EventLoop loop;
+
+    const std::size_t CHUNK_SIZE = 4 * 1024 * 1024;
+    const std::size_t CHUNKS_COUNT = 8;
+    const std::size_t HIGH_WATERMARK = 2 * CHUNK_SIZE;
+    const std::size_t LOW_WATERMARK = CHUNK_SIZE / 4;
+
+    std::shared_ptr<char> buf(new char[CHUNK_SIZE], std::default_delete<char[]>());
+    std::memset(buf.get(), 'a', CHUNK_SIZE);
+
+    std::size_t buffer_full_count = 0;
+    std::size_t buffer_drained_count = 0;
+    std::size_t server_on_send_count = 0;
+    std::size_t client_bytes_received = 0;
+
+    auto server = new io::TcpServer(loop);
+    auto listen_error = server->listen({"0.0.0.0", m_default_port},
+        [&](io::TcpConnectedClient& client, const io::Error& error) {
+            EXPECT_FALSE(error);
+            EXPECT_FALSE(client.is_write_buffer_full());
+            EXPECT_EQ(0, client.pending_write_bytes());
+
+            EXPECT_FALSE(client.set_write_watermarks(LOW_WATERMARK, HIGH_WATERMARK));
+            client.set_on_write_buffer_full([&](io::TcpConnectedClient& client) {
+                EXPECT_TRUE(client.is_write_buffer_full());
+                EXPECT_LE(HIGH_WATERMARK, client.pending_write_bytes());
+                ++buffer_full_count;
+            });
+            client.set_on_write_buffer_drained([&](io::TcpConnectedClient& client) {
+                EXPECT_FALSE(client.is_write_buffer_full());
+                EXPECT_GE(LOW_WATERMARK, client.pending_write_bytes());
+                ++buffer_drained_count;
+            });
+
+            for (std::size_t i = 0; i < CHUNKS_COUNT; ++i) {
+                client.send_data(buf, CHUNK_SIZE, [&](io::TcpConnectedClient& client, const io::Error& error) {
+                    EXPECT_FALSE(error);
+                    ++server_on_send_count;
+                });
+            }
+
+            // Kernel buffers could not hold all the data at once
+            EXPECT_EQ(1, buffer_full_count);
+            EXPECT_TRUE(client.is_write_buffer_full());
+            EXPECT_EQ(CHUNK_SIZE * CHUNKS_COUNT, client.pending_write_bytes());
+        },
+        nullptr,
+        nullptr
+    );
+    ASSERT_FALSE(listen_error);
+
+    auto client = new io::TcpClient(loop);
+    client->connect({m_default_addr, m_default_port},
+        [&](io::TcpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error);
+        },
+        [&](io::TcpClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error);
+            client_bytes_received += data.size;
+            if (client_bytes_received == CHUNK_SIZE * CHUNKS_COUNT) {
+                client.schedule_removal();
+                server->schedule_removal();
+            }
+        }
+    );
+
+    ASSERT_EQ(0, loop.run());
+
+    EXPECT_EQ(CHUNKS_COUNT, server_on_send_count);
+    EXPECT_EQ(CHUNK_SIZE * CHUNKS_COUNT, client_bytes_received);
+    EXPECT_EQ(1, buffer_full_count);
+    EXPECT_EQ(1, buffer_drained_count);
+}
+
+TEST_F(TcpClientServerTest, write_watermarks_invalid_arguments) {
+    io::EventLoop loop;
+
+    auto client = new io::TcpClient(loop);
+    EXPECT_EQ(io::StatusCode::INVALID_ARGUMENT, client->set_write_watermarks(2, 1).code());
+    EXPECT_FALSE(client->set_write_watermarks(1, 1));
+    // Disabling
+    EXPECT_FALSE(client->set_write_watermarks(0, 0));
+    EXPECT_FALSE(client->is_write_buffer_full());
+    EXPECT_EQ(0, client->pending_write_bytes());
+
+    client->schedule_removal();
+
+    ASSERT_EQ(0, loop.run());
+}
+
+TEST_F(TcpClientServerTest, pause_and_resume_reading) {
+    io::EventLoop loop;
+
+    std::string server_received_message;
+    std::string client_received_message;
+    bool server_reading_resumed = false;
+    bool client_reading_resumed = false;
+
+    auto server = new io::TcpServer(loop);
+    auto listen_error = server->listen({"0.0.0.0", m_default_port},
+        [&](io::TcpConnectedClient& client, const io::Error& error) {
+            EXPECT_FALSE(error);
+            EXPECT_FALSE(client.is_reading_paused());
+            EXPECT_FALSE(client.pause_reading());
+            EXPECT_TRUE(client.is_reading_paused());
+            // Second pause does nothing
+            EXPECT_FALSE(client.pause_reading());
+
+            client.send_data("server");
+
+            (new io::Timer(loop))->start(100,
+                [&](io::Timer& timer) {
+                    EXPECT_TRUE(server_received_message.empty());
+                    server_reading_resumed = true;
+                    EXPECT_FALSE(client.resume_reading());
+                    EXPECT_FALSE(client.is_reading_paused());
+                    EXPECT_FALSE(client.resume_reading());
+                    timer.schedule_removal();
+                }
+            );
+        },
+        [&](io::TcpConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error);
+            EXPECT_TRUE(server_reading_resumed);
+            server_received_message.append(data.buf.get(), data.size);
+        },
+        nullptr
+    );
+    ASSERT_FALSE(listen_error);
+
+    auto client = new io::TcpClient(loop);
+    EXPECT_EQ(io::StatusCode::NOT_CONNECTED, client->pause_reading().code());
+    EXPECT_EQ(io::StatusCode::NOT_CONNECTED, client->resume_reading().code());
+
+    client->connect({m_default_addr, m_default_port},
+        [&](io::TcpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error);
+            EXPECT_FALSE(client.pause_reading());
+            EXPECT_TRUE(client.is_reading_paused());
+
+            client.send_data("client");
+
+            (new io::Timer(loop))->start(200,
+                [&](io::Timer& timer) {
+                    EXPECT_TRUE(client_received_message.empty());
+                    client_reading_resumed = true;
+                    EXPECT_FALSE(client.resume_reading());
+                    timer.schedule_removal();
+                }
+            );
+        },
+        [&](io::TcpClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error);
+            EXPECT_TRUE(client_reading_resumed);
+            client_received_message.append(data.buf.get(), data.size);
+            if (client_received_message == "server") {
+                client.schedule_removal();
+                server->schedule_removal();
+            }
+        }
+    );
+
+    ASSERT_EQ(0, loop.run());
+
+    EXPECT_EQ("client", server_received_message);
+    EXPECT_EQ("server", client_received_message);
+}
+
+TEST_F(TcpClientServerTest, read_buffers_are_shared_between_connections) {
+    io::EventLoop loop;
+
+    const std::size_t CLIENTS_COUNT = 50;
+
+    std::size_t server_receive_count = 0;
+    std::size_t clients_closed_count = 0;
+
+    auto server = new io::TcpServer(loop);
+    auto listen_error = server->listen({"0.0.0.0", m_default_port},
+        nullptr,
+        [&](io::TcpConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error);
+            EXPECT_EQ("hello", std::string(data.buf.get(), data.size));
+            ++server_receive_count;
+            client.close();
+        },
+        nullptr
+    );
+    ASSERT_FALSE(listen_error);
+
+    for (std::size_t i = 0; i < CLIENTS_COUNT; ++i) {
+        auto client = new io::TcpClient(loop);
+        client->connect({m_default_addr, m_default_port},
+            [&](io::TcpClient& client, const io::Error& error) {
+                EXPECT_FALSE(error);
+                client.send_data("hello");
+            },
+            nullptr,
+            [&](io::TcpClient& client, const io::Error& error) {
+                client.schedule_removal();
+                if (++clients_closed_count == CLIENTS_COUNT) {
+                    server->schedule_removal();
+                }
+            }
+        );
+    }
+
+    ASSERT_EQ(0, loop.run());
+
+    EXPECT_EQ(CLIENTS_COUNT, server_receive_count);
+    // Buffer is released after each read, so a single one is enough for all connections
+    EXPECT_LE(CLIENTS_COUNT, loop.read_buffer_pool_hits());
+    EXPECT_GE(3, loop.read_buffer_pool_misses());
+}
+
+TEST_F(TcpClientServerTest, retained_read_buffers_are_not_reused) {
+    io::EventLoop loop;
+
+    const std::size_t DATA_SIZE = 4 * 1024 * 1024;
+
+    std::shared_ptr<char> buf(new char[DATA_SIZE], std::default_delete<char[]>());
+    for (std::size_t i = 0; i < DATA_SIZE; ++i) {
+        buf.get()[i] = static_cast<char>(i % 251);
+    }
+
+    std::vector<io::DataChunk> received_chunks;
+    std::size_t received_size = 0;
+
+    auto server = new io::TcpServer(loop);
+    auto listen_error = server->listen({"0.0.0.0", m_default_port},
+        [&](io::TcpConnectedClient& client, const io::Error& error) {
+            EXPECT_FALSE(error);
+            client.send_data(buf, DATA_SIZE);
+        },
+        nullptr,
+        nullptr
+    );
+    ASSERT_FALSE(listen_error);
+
+    auto client = new io::TcpClient(loop);
+    client->connect({m_default_addr, m_default_port},
+        [&](io::TcpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error);
+        },
+        [&](io::TcpClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error);
+            received_chunks.push_back(data);
+            received_size += data.size;
+            if (received_size == DATA_SIZE) {
+                client.schedule_removal();
+                server->schedule_removal();
+            }
+        }
+    );
+
+    ASSERT_EQ(0, loop.run());
+
+    ASSERT_EQ(DATA_SIZE, received_size);
+
+    std::size_t offset = 0;
+    for (const auto& chunk : received_chunks) {
+        EXPECT_EQ(offset, chunk.offset);
+        ASSERT_EQ(0, std::memcmp(buf.get() + offset, chunk.buf.get(), chunk.size)) << offset;
+        offset += chunk.size;
+    }
+}
+
+TEST_F(TcpClientServerTest, server_read_buffer_allocator) {
+    io::EventLoop loop;
+
+    // Arena of fixed size slots, large enough for any read buffer
+    const std::size_t SLOT_SIZE = 64 * 1024;
+    const std::size_t SLOTS_COUNT = 4;
+    std::vector<char> arena(SLOT_SIZE * SLOTS_COUNT);
+    std::vector<bool> slots_used(SLOTS_COUNT, false);
+
+    std::size_t allocate_count = 0;
+    std::size_t release_count = 0;
+
+    io::ReadBufferAllocator allocator(
+        [&](std::size_t size) -> char* {
+            EXPECT_GE(SLOT_SIZE, size);
+            for (std::size_t i = 0; i < SLOTS_COUNT; ++i) {
+                if (!slots_used[i]) {
+                    slots_used[i] = true;
+                    ++allocate_count;
+                    return arena.data() + i * SLOT_SIZE;
+                }
+            }
+            return nullptr;
+        },
+        [&](char* buffer) {
+            const std::size_t index = std::size_t(buffer - arena.data()) / SLOT_SIZE;
+            ASSERT_LT(index, SLOTS_COUNT);
+            EXPECT_TRUE(slots_used[index]);
+            slots_used[index] = false;
+            ++release_count;
+        }
+    );
+
+    std::string server_received_message;
+    io::DataChunk retained_chunk;
+
+    auto server = new io::TcpServer(loop);
+    EXPECT_EQ(io::StatusCode::INVALID_ARGUMENT,
+              server->set_read_buffer_allocator(io::ReadBufferAllocator(allocator.allocate, nullptr)).code());
+    EXPECT_FALSE(server->set_read_buffer_allocator(allocator));
+
+    auto listen_error = server->listen({"0.0.0.0", m_default_port},
+        nullptr,
+        [&](io::TcpConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error);
+            // Data is received directly into the arena
+            EXPECT_GE(data.buf.get(), arena.data());
+            EXPECT_LT(data.buf.get(), arena.data() + arena.size());
+
+            server_received_message.append(data.buf.get(), data.size);
+            retained_chunk = data;
+            client.close();
+        },
+        nullptr
+    );
+    ASSERT_FALSE(listen_error);
+
+    auto client = new io::TcpClient(loop);
+    client->connect({m_default_addr, m_default_port},
+        [&](io::TcpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error);
+            client.send_data("Hello!");
+        },
+        nullptr,
+        [&](io::TcpClient& client, const io::Error& error) {
+            client.schedule_removal();
+            server->schedule_removal();
+        }
+    );
+
+    ASSERT_EQ(0, loop.run());
+
+    EXPECT_EQ("Hello!", server_received_message);
+    EXPECT_LE(1, allocate_count);
+    // Retained buffer is released only with the last DataChunk
+    EXPECT_EQ(allocate_count - 1, release_count);
+    EXPECT_EQ("Hello!", std::string(retained_chunk.buf.get(), retained_chunk.size));
+
+    retained_chunk = io::DataChunk();
+    EXPECT_EQ(allocate_count, release_count);
+}
+
+TEST_F(TcpClientServerTest, client_read_buffer_allocator_out_of_memory) {
+    io::EventLoop loop;
+
+    std::size_t client_close_count = 0;
+
+    auto server = new io::TcpServer(loop);
+    auto listen_error = server->listen({"0.0.0.0", m_default_port},
+        [&](io::TcpConnectedClient& client, const io::Error& error) {
+            EXPECT_FALSE(error);
+            client.send_data("Hello!");
+        },
+        nullptr,
+        nullptr
+    );
+    ASSERT_FALSE(listen_error);
+
+    auto client = new io::TcpClient(loop);
+    EXPECT_FALSE(client->set_read_buffer_allocator({
+        [](std::size_t) -> char* { return nullptr; },
+        [](char*) { FAIL() << "Nothing was allocated"; }
+    }));
+
+    client->connect({m_default_addr, m_default_port},
+        [&](io::TcpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error);
+        },
+        [&](io::TcpClient& client, const io::DataChunk& data, const io::Error& error) {
+            ADD_FAILURE() << "No data should be received";
+        },
+        [&](io::TcpClient& client, const io::Error& error) {
+            EXPECT_EQ(io::StatusCode::NO_BUFFER_SPACE_AVAILABLE, error.code());
+            ++client_close_count;
+            client.schedule_removal();
+            server->schedule_removal();
+        }
+    );
+
+    ASSERT_EQ(0, loop.run());
+
+    EXPECT_EQ(1, client_close_count);
+}
+
+TEST_F(TcpClientServerTest, server_send_file) {
+    // File is larger than socket buffers and client does not read at first, so sending waits for the socket
+    const std::size_t FILE_SIZE = 8 * 1024 * 1024;
+    const std::size_t OFFSET = 100;
+    const std::size_t LENGTH = FILE_SIZE - 2 * OFFSET;
+
+    std::string file_content(FILE_SIZE, 0);
+    for (std::size_t i = 0; i < FILE_SIZE; ++i) {
+        file_content[i] = static_cast<char>(i * 7 + i / 251);
+    }
+
+    const std::string file_path = create_temp_test_directory() + "/send_file";
+    {
+        std::ofstream ofile(file_path, std::ios::binary);
+        ASSERT_FALSE(ofile.fail());
+        ofile.write(file_content.data(), file_content.size());
+    }
+
+    const std::string expected_message = "header" + file_content.substr(OFFSET, LENGTH) + "trailer";
+
+    io::EventLoop loop;
+
+    std::size_t send_file_callback_count = 0;
+    std::size_t header_callback_count = 0;
+    std::size_t trailer_callback_count = 0;
+    std::string client_received_message;
+
+    auto file = new io::File(loop);
+    auto server = new io::TcpServer(loop);
+
+    file->open(file_path, [&](io::File& file, const io::Error& error) {
+        ASSERT_FALSE(error);
+
+        auto listen_error = server->listen({"0.0.0.0", m_default_port},
+            [&](io::TcpConnectedClient& client, const io::Error& error) {
+                EXPECT_FALSE(error);
+
+                client.send_data("header", [&](io::TcpConnectedClient& client, const io::Error& error) {
+                    EXPECT_FALSE(error);
+                    EXPECT_EQ(0, send_file_callback_count);
+                    ++header_callback_count;
+                });
+
+                client.send_file(file, OFFSET, LENGTH,
+                    [&](io::TcpConnectedClient& client, std::size_t bytes_sent, const io::Error& error) {
+                        EXPECT_FALSE(error);
+                        EXPECT_EQ(LENGTH, bytes_sent);
+                        EXPECT_EQ(1, header_callback_count);
+                        EXPECT_EQ(0, trailer_callback_count);
+                        ++send_file_callback_count;
+                    }
+                );
+
+                // Held until the file is sent
+                client.send_data("trailer", [&](io::TcpConnectedClient& client, const io::Error& error) {
+                    EXPECT_FALSE(error);
+                    EXPECT_EQ(1, send_file_callback_count);
+                    ++trailer_callback_count;
+                });
+                EXPECT_EQ(3, client.pending_write_requesets());
+                EXPECT_LT(0, client.pending_write_bytes());
+            },
+            nullptr,
+            nullptr
+        );
+        ASSERT_FALSE(listen_error);
+
+        auto client = new io::TcpClient(loop);
+        client->connect({m_default_addr, m_default_port},
+            [&](io::TcpClient& client, const io::Error& error) {
+                EXPECT_FALSE(error);
+                EXPECT_FALSE(client.pause_reading());
+
+                (new io::Timer(loop))->start(100,
+                    [&](io::Timer& timer) {
+                        EXPECT_EQ(0, send_file_callback_count);
+                        EXPECT_FALSE(client.resume_reading());
+                        timer.schedule_removal();
+                    }
+                );
+            },
+            [&](io::TcpClient& client, const io::DataChunk& data, const io::Error& error) {
+                EXPECT_FALSE(error);
+                client_received_message.append(data.buf.get(), data.size);
+                if (client_received_message.size() >= expected_message.size()) {
+                    client.schedule_removal();
+                    server->schedule_removal();
+                    file.schedule_removal();
+                }
+            }
+        );
+    });
+
+    ASSERT_EQ(0, loop.run());
+
+    EXPECT_EQ(1, header_callback_count);
+    EXPECT_EQ(1, send_file_callback_count);
+    EXPECT_EQ(1, trailer_callback_count);
+    ASSERT_EQ(expected_message.size(), client_received_message.size());
+    EXPECT_TRUE(expected_message == client_received_message);
+}
+
+TEST_F(TcpClientServerTest, client_close_during_send_file) {
+    // Server does not read, so sending waits for the socket when connection is closed
+    const std::size_t FILE_SIZE = 8 * 1024 * 1024;
+
+    const std::string file_path = create_temp_test_directory() + "/send_file";
+    {
+        std::ofstream ofile(file_path, std::ios::binary);
+        ASSERT_FALSE(ofile.fail());
+        ofile.write(std::string(FILE_SIZE, 'a').data(), FILE_SIZE);
+    }
+
+    io::EventLoop loop;
+
+    std::size_t send_file_callback_count = 0;
+    std::size_t close_callback_count = 0;
+
+    auto file = new io::File(loop);
+    auto server = new io::TcpServer(loop);
+
+    file->open(file_path, [&](io::File& file, const io::Error& error) {
+        ASSERT_FALSE(error);
+
+        auto listen_error = server->listen({"0.0.0.0", m_default_port},
+            [&](io::TcpConnectedClient& client, const io::Error& error) {
+                EXPECT_FALSE(error);
+                EXPECT_FALSE(client.pause_reading());
+            },
+            nullptr,
+            nullptr
+        );
+        ASSERT_FALSE(listen_error);
+
+        auto client = new io::TcpClient(loop);
+        client->connect({m_default_addr, m_default_port},
+            [&](io::TcpClient& client, const io::Error& error) {
+                EXPECT_FALSE(error);
+
+                client.send_file(file, 0, FILE_SIZE,
+                    [&](io::TcpClient& client, std::size_t bytes_sent, const io::Error& error) {
+                        EXPECT_EQ(io::StatusCode::OPERATION_CANCELED, error.code());
+                        EXPECT_LT(0, bytes_sent);
+                        EXPECT_GT(FILE_SIZE, bytes_sent);
+                        EXPECT_EQ(0, close_callback_count);
+                        ++send_file_callback_count;
+                    }
+                );
+
+                (new io::Timer(loop))->start(100,
+                    [&](io::Timer& timer) {
+                        EXPECT_EQ(0, send_file_callback_count);
+                        EXPECT_EQ(1, client.pending_write_requesets());
+                        client.schedule_removal();
+                        server->schedule_removal();
+                        file.schedule_removal();
+                        timer.schedule_removal();
+                    }
+                );
+            },
+            nullptr,
+            [&](io::TcpClient& client, const io::Error& error) {
+                EXPECT_EQ(1, send_file_callback_count);
+                ++close_callback_count;
+            }
+        );
     });
 
     ASSERT_EQ(0, loop.run());
-    EXPECT_TRUE(data_sent);
-    EXPECT_TRUE(data_received);
-}
 
-TEST_F(TcpClientServerTest, multiple_data_chunks_sent_in_a_row_by_client) {
-    // Note: in this test verifying that data send is queued and delivered in order
+    EXPECT_EQ(1, send_file_callback_count);
+    EXPECT_EQ(1, close_callback_count);
+}
 
-    const std::size_t CHUNK_SIZE = 65536;
-    const std::size_t CHUNKS_COUNT = 20;
-    const std::size_t TOTAL_BYTES = CHUNK_SIZE * CHUNKS_COUNT;
+TEST_F(TcpClientServerTest, client_send_file_errors) {
+    const std::string file_content = "0123456789";
+    const std::string file_path = create_temp_test_directory() + "/send_file";
+    {
+        std::ofstream ofile(file_path, std::ios::binary);
+        ASSERT_FALSE(ofile.fail());
+        ofile.write(file_content.data(), file_content.size());
+    }
 
-    ASSERT_EQ(0, CHUNK_SIZE % sizeof(std::uint32_t));
+    io::EventLoop loop;
 
-    std::thread server_thread([this, TOTAL_BYTES]() {
-        io::EventLoop loop;
-        auto server = new io::TcpServer(loop);
+    std::size_t callbacks_count = 0;
+    std::string server_received_message;
 
-        std::size_t bytes_received = 0;
+    auto file = new io::File(loop);
+    auto server = new io::TcpServer(loop);
+    auto client = new io::TcpClient(loop);
 
-        std::vector<unsigned char> total_bytes_received;
+    // Not connected
+    client->send_file(*file, 0, 1,
+        [&](io::TcpClient& client, std::size_t bytes_sent, const io::Error& error) {
+            EXPECT_EQ(io::StatusCode::NOT_CONNECTED, error.code());
+            EXPECT_EQ(0, bytes_sent);
+            ++callbacks_count;
+        }
+    );
 
-        auto listen_error = server->listen({"0.0.0.0", m_default_port},
-        [&](io::TcpConnectedClient& client, const io::Error& error) {
-            EXPECT_FALSE(error);
-        },
+    auto listen_error = server->listen({"0.0.0.0", m_default_port},
+        nullptr,
         [&](io::TcpConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
-            total_bytes_received.insert(total_bytes_received.end(), data.buf.get(), data.buf.get() + data.size);
-            bytes_received += data.size;
-            if (bytes_received >= TOTAL_BYTES) {
+            EXPECT_FALSE(error);
+            server_received_message.append(data.buf.get(), data.size);
+            if (server_received_message.size() == 4) {
                 server->schedule_removal();
             }
         },
-        nullptr);
-        EXPECT_FALSE(listen_error);
+        nullptr
+    );
+    ASSERT_FALSE(listen_error);
 
-        EXPECT_EQ(0, loop.run());
-        EXPECT_EQ(TOTAL_BYTES, bytes_received);
-        EXPECT_EQ(TOTAL_BYTES, total_bytes_received.size());
-        for (std::size_t i = 0; i < total_bytes_received.size(); i += 4) {
-            ASSERT_EQ(i / 4, *reinterpret_cast<std::uint32_t*>((&total_bytes_received[0] + i)));
-        }
-    });
+    client->connect({m_default_addr, m_default_port},
+        [&](io::TcpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error);
 
-    std::thread client_thread([this, CHUNK_SIZE, CHUNKS_COUNT]() {
-        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            // File is not open
+            client.send_file(*file, 0, 1,
+                [&](io::TcpClient& client, std::size_t bytes_sent, const io::Error& error) {
+                    EXPECT_EQ(io::StatusCode::INVALID_ARGUMENT, error.code());
+                    EXPECT_EQ(0, bytes_sent);
+                    ++callbacks_count;
+                }
+            );
 
-        std::size_t counter = 0;
-        std::function<void(io::TcpClient&, const io::Error&)> on_data_sent = [&](io::TcpClient& client, const io::Error& error) {
-            EXPECT_FALSE(error);
-            if (++counter == CHUNKS_COUNT) {
-                client.schedule_removal();
-            }
-        };
+            file->open(file_path, [&](io::File& file, const io::Error& error) {
+                ASSERT_FALSE(error);
 
-        io::EventLoop loop;
-        auto client = new io::TcpClient(loop);
-        client->connect({m_default_addr, m_default_port}, [&](io::TcpClient& client, const io::Error& error) {
-            EXPECT_FALSE(error);
+                // Zero length
+                client.send_file(file, 0, 0,
+                    [&](io::TcpClient& client, std::size_t bytes_sent, const io::Error& error) {
+                        EXPECT_EQ(io::StatusCode::INVALID_ARGUMENT, error.code());
+                        ++callbacks_count;
+                    }
+                );
 
-            for (size_t i = 0; i < CHUNKS_COUNT; ++i) {
-                std::shared_ptr<char> buf(new char[CHUNK_SIZE], [](const char* p) { delete[] p; });
-                for (std::size_t k = 0; k < CHUNK_SIZE; k += 4) {
-                    (*reinterpret_cast<std::uint32_t*>(buf.get() + k) ) = k / 4 + i * CHUNK_SIZE / 4;
-                }
-                client.send_data(buf, CHUNK_SIZE, on_data_sent);
-            }
+                // File is shorter than requested, available part is sent
+                client.send_file(file, 6, 100,
+                    [&](io::TcpClient& client, std::size_t bytes_sent, const io::Error& error) {
+                        EXPECT_EQ(io::StatusCode::END_OF_FILE, error.code());
+                        EXPECT_EQ(4, bytes_sent);
+                        EXPECT_EQ(0, client.pending_write_bytes());
+                        ++callbacks_count;
+                        client.schedule_removal();
+                        file.schedule_removal();
+                    }
+                );
+            });
         },
-        nullptr);
+        nullptr
+    );
 
-        EXPECT_EQ(0, loop.run());
-    });
+    ASSERT_EQ(0, loop.run());
 
-    io::ScopeExitGuard guard([&server_thread, &client_thread](){
-        client_thread.join();
-        server_thread.join();
-    });
+    EXPECT_EQ(4, callbacks_count);
+    EXPECT_EQ("6789", server_received_message);
 }
 
-TEST_F(TcpClientServerTest, null_send_buf) {
-    io::EventLoop loop;
+TEST_F(TcpClientServerTest, zero_copy_send) {
+    const std::size_t BIG_SIZE = 8 * 1024 * 1024;
+    const std::size_t SMALL_SIZE = 1024;
 
-    std::shared_ptr<char> buf;
+    std::shared_ptr<char> big_buffer(new char[BIG_SIZE], std::default_delete<char[]>());
+    for (std::size_t i = 0; i < BIG_SIZE; ++i) {
+        big_buffer.get()[i] = static_cast<char>(i * 11 + i / 509);
+    }
 
-    std::size_t server_on_send_count = 0;
-    std::size_t client_on_send_count = 0;
+    std::shared_ptr<char> small_buffer(new char[SMALL_SIZE], std::default_delete<char[]>());
+    std::memset(small_buffer.get(), 'x', SMALL_SIZE);
+
+    io::EventLoop loop;
+
+    std::size_t big_send_callback_count = 0;
+    std::size_t small_send_callback_count = 0;
+    std::string client_received_message;
 
     auto server = new io::TcpServer(loop);
     auto listen_error = server->listen({"0.0.0.0", m_default_port},
         [&](io::TcpConnectedClient& client, const io::Error& error) {
             EXPECT_FALSE(error);
+            EXPECT_EQ(0, client.zero_copy_send_threshold());
+            EXPECT_FALSE(client.set_zero_copy_send_threshold(1024 * 1024));
+            EXPECT_EQ(1024 * 1024, client.zero_copy_send_threshold());
 
-            client.send_data(buf, 1,
-                [&](io::TcpConnectedClient& client, const io::Error& error) {
-                    EXPECT_TRUE(error);
-                    EXPECT_EQ(io::StatusCode::INVALID_ARGUMENT, error.code());
-                    ++server_on_send_count;
-                    server->schedule_removal();
-                }
-            );
+            // Completions are received without reading too
+            EXPECT_FALSE(client.pause_reading());
+
+            client.send_data(big_buffer, BIG_SIZE, [&](io::TcpConnectedClient& client, const io::Error& error) {
+                EXPECT_FALSE(error);
+                // Buffer is released by the library before the callback
+                EXPECT_EQ(1, big_buffer.use_count());
+                ++big_send_callback_count;
+            });
+
+            // Below the threshold
+            client.send_data(small_buffer, SMALL_SIZE, [&](io::TcpConnectedClient& client, const io::Error& error) {
+                EXPECT_FALSE(error);
+                ++small_send_callback_count;
+            });
+
+            EXPECT_EQ(2, client.pending_write_requesets());
+            EXPECT_EQ(BIG_SIZE + SMALL_SIZE, client.pending_write_bytes());
+#if defined(__linux__)
+            EXPECT_EQ(1, client.zero_copy_sends_count());
+#else
+            EXPECT_EQ(0, client.zero_copy_sends_count());
+#endif
         },
         nullptr,
         nullptr
     );
     ASSERT_FALSE(listen_error);
 
-    bool data_sent = false;
-
     auto client = new io::TcpClient(loop);
     client->connect({m_default_addr, m_default_port},
         [&](io::TcpClient& client, const io::Error& error) {
             EXPECT_FALSE(error);
+        },
+        [&](io::TcpClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error);
+            client_received_message.append(data.buf.get(), data.size);
+            if (client_received_message.size() == BIG_SIZE + SMALL_SIZE) {
+                (new io::Timer(loop))->start(100,
+                    [&](io::Timer& timer) {
+                        client.schedule_removal();
+                        server->schedule_removal();
+                        timer.schedule_removal();
+                    }
+                );
+            }
+        }
+    );
 
-            client.send_data(buf, 1,
-                [&](io::TcpClient& client, const io::Error& error) {
-                    EXPECT_TRUE(error);
-                    EXPECT_EQ(io::StatusCode::INVALID_ARGUMENT, error.code());
-                    ++client_on_send_count;
-                    client.schedule_removal();
-                }
-            );
+    ASSERT_EQ(0, loop.run());
+
+    EXPECT_EQ(1, big_send_callback_count);
+    EXPECT_EQ(1, small_send_callback_count);
+    ASSERT_EQ(BIG_SIZE + SMALL_SIZE, client_received_message.size());
+    EXPECT_TRUE(std::string(big_buffer.get(), BIG_SIZE) == client_received_message.substr(0, BIG_SIZE));
+    EXPECT_TRUE(std::string(SMALL_SIZE, 'x') == client_received_message.substr(BIG_SIZE));
+}
+
+TEST_F(TcpClientServerTest, zero_copy_send_and_close) {
+    const std::size_t SIZE = 256 * 1024;
+
+    std::shared_ptr<char> buffer(new char[SIZE], std::default_delete<char[]>());
+    for (std::size_t i = 0; i < SIZE; ++i) {
+        buffer.get()[i] = static_cast<char>(i * 7 + i / 311);
+    }
+
+    io::EventLoop loop;
+
+    std::size_t send_callback_count = 0;
+    std::size_t client_on_close_count = 0;
+    std::string client_received_message;
+
+    auto server = new io::TcpServer(loop);
+    auto listen_error = server->listen({"0.0.0.0", m_default_port},
+        [&](io::TcpConnectedClient& client, const io::Error& error) {
+            EXPECT_FALSE(error);
+            EXPECT_FALSE(client.set_zero_copy_send_threshold(1));
+
+            client.send_data(buffer, SIZE, [&](io::TcpConnectedClient& client, const io::Error& error) {
+                // Data is in the kernel already, so send is not canceled by close
+                EXPECT_FALSE(error) << error.string();
+                ++send_callback_count;
+            });
+
+            // Closing before kernel notified that buffer was sent
+            client.close();
         },
+        nullptr,
         nullptr
     );
+    ASSERT_FALSE(listen_error);
 
-    EXPECT_EQ(0, server_on_send_count);
-    EXPECT_EQ(0, client_on_send_count);
+    auto client = new io::TcpClient(loop);
+    client->connect({m_default_addr, m_default_port},
+        [&](io::TcpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error);
+        },
+        [&](io::TcpClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error);
+            client_received_message.append(data.buf.get(), data.size);
+        },
+        [&](io::TcpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error);
+            ++client_on_close_count;
+            client.schedule_removal();
+            server->schedule_removal();
+        }
+    );
 
     ASSERT_EQ(0, loop.run());
 
-    EXPECT_EQ(1, server_on_send_count);
-    EXPECT_EQ(1, client_on_send_count);
+    EXPECT_EQ(1, send_callback_count);
+    EXPECT_EQ(1, client_on_close_count);
+    ASSERT_EQ(SIZE, client_received_message.size());
+    EXPECT_TRUE(std::string(buffer.get(), SIZE) == client_received_message);
+    // Buffer is held after close until kernel releases it, but not longer
+    EXPECT_EQ(1, buffer.use_count());
 }
 
 TEST_F(TcpClientServerTest, server_shutdown_callback) {
@@ -3059,3 +4223,117 @@ TEST_F(TcpClientServerTest, client_and_server_simultaneously_send_data_each_othe
 
 
 // TODO: ipv6
+
+#if defined(__linux__)
+// SO_REUSEPORT load balancing is available only on Linux
+TEST_F(TcpClientServerTest, sharded_server_echo) {
+    const std::size_t LOOPS_COUNT = 4;
+    const std::size_t CLIENTS_COUNT = 32;
+    const std::string message = "Hello!";
+
+    io::EventLoopGroup group(LOOPS_COUNT);
+
+    std::mutex mutex;
+    std::set<std::thread::id> server_thread_ids;
+    std::atomic<std::size_t> server_on_new_connection_count(0);
+    std::atomic<std::size_t> server_on_receive_count(0);
+    std::atomic<std::size_t> server_on_close_count(0);
+
+    io::ShardedTcpServer server(group);
+    auto listen_error = server.listen({m_default_addr, m_default_port},
+        [&](io::TcpConnectedClient& client, const io::Error& error) {
+            EXPECT_FALSE(error);
+            ++server_on_new_connection_count;
+
+            std::lock_guard<std::mutex> guard(mutex);
+            server_thread_ids.insert(std::this_thread::get_id());
+        },
+        [&](io::TcpConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error);
+            ++server_on_receive_count;
+            client.send_data(std::string(data.buf.get(), data.size));
+        },
+        nullptr
+    );
+    ASSERT_FALSE(listen_error) << listen_error.string();
+    EXPECT_EQ(LOOPS_COUNT, server.shards_count());
+    EXPECT_EQ(m_default_port, server.endpoint().port());
+
+    std::thread client_thread([&]() {
+        io::EventLoop loop;
+
+        std::size_t client_on_receive_count = 0;
+
+        for (std::size_t i = 0; i < CLIENTS_COUNT; ++i) {
+            auto client = new io::TcpClient(loop);
+            client->connect({m_default_addr, m_default_port},
+                [&](io::TcpClient& client, const io::Error& error) {
+                    EXPECT_FALSE(error);
+                    client.send_data(message);
+                },
+                [&](io::TcpClient& client, const io::DataChunk& data, const io::Error& error) {
+                    EXPECT_FALSE(error);
+                    EXPECT_EQ(message, std::string(data.buf.get(), data.size));
+                    client.schedule_removal();
+
+                    if (++client_on_receive_count == CLIENTS_COUNT) {
+                        server.close([&](io::TcpServer&, const io::Error& error) {
+                            EXPECT_FALSE(error);
+                            ++server_on_close_count;
+                        });
+                    }
+                }
+            );
+        }
+
+        ASSERT_EQ(0, loop.run());
+
+        EXPECT_EQ(CLIENTS_COUNT, client_on_receive_count);
+    });
+
+    ASSERT_EQ(0, group.run());
+    client_thread.join();
+
+    EXPECT_EQ(CLIENTS_COUNT, server_on_new_connection_count);
+    EXPECT_EQ(CLIENTS_COUNT, server_on_receive_count);
+    EXPECT_EQ(LOOPS_COUNT, server_on_close_count);
+    // Kernel distributes connections by hash of the 4-tuple, so more than one loop should be involved
+    EXPECT_GT(server_thread_ids.size(), 1);
+}
+
+TEST_F(TcpClientServerTest, sharded_server_close_after_group_run) {
+    const std::size_t LOOPS_COUNT = 2;
+
+    io::EventLoopGroup group(LOOPS_COUNT);
+
+    std::size_t server_on_close_count = 0;
+
+    {
+        io::ShardedTcpServer server(group);
+        auto listen_error = server.listen({m_default_addr, m_default_port}, nullptr, nullptr, nullptr);
+        ASSERT_FALSE(listen_error) << listen_error.string();
+
+        // Loops exit only when listening sockets are closed
+        for (std::size_t i = 0; i < LOOPS_COUNT; ++i) {
+            group.loop(i).execute_on_loop_thread([&server, i]() {
+                server.shard(i).close();
+            });
+        }
+
+        ASSERT_EQ(0, group.run());
+
+        server.close([&](io::TcpServer&, const io::Error& error) {
+            EXPECT_FALSE(error);
+            ++server_on_close_count;
+        });
+
+        EXPECT_EQ(LOOPS_COUNT, server_on_close_count);
+        EXPECT_EQ(0, server.shards_count());
+        for (std::size_t i = 0; i < LOOPS_COUNT; ++i) {
+            EXPECT_EQ(1, group.loop(i).pending_removals_count());
+        }
+    }
+
+    EXPECT_EQ(LOOPS_COUNT, server_on_close_count);
+}
+#endif
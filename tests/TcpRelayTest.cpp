@@ -0,0 +1,200 @@
+#include "UTCommon.h"
+
+#include "io/TcpClient.h"
+#include "io/TcpRelay.h"
+#include "io/TcpServer.h"
+#include "io/Timer.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+struct TcpRelayTest : public testing::Test,
+                      public LogRedirector {
+
+protected:
+    std::uint16_t m_proxy_port = 31540;
+    std::uint16_t m_upstream_port = 31541;
+    std::string m_default_addr = "127.0.0.1";
+
+    void test_relay_in_both_directions(bool zero_copy);
+
+    static std::string make_message(std::size_t size, char seed) {
+        std::string message(size, 0);
+        for (std::size_t i = 0; i < size; ++i) {
+            message[i] = static_cast<char>(seed + i * 13 + i / 257);
+        }
+        return message;
+    }
+};
+
+void TcpRelayTest::test_relay_in_both_directions(bool zero_copy) {
+    // Client -> proxy (relay) -> upstream server. Upstream responds after the whole request is received
+    // and finishes sending, this is propagated to the client. Client closes connection after response.
+    const std::string request = make_message(1024 * 1024, 'a');
+    const std::string response = make_message(16 * 1024 * 1024, 'z');
+
+    io::EventLoop loop;
+
+    std::string upstream_received;
+    std::string client_received;
+    std::size_t relay_end_callback_count = 0;
+    std::size_t client_close_callback_count = 0;
+
+    auto upstream_server = new io::TcpServer(loop);
+    auto listen_error = upstream_server->listen({"0.0.0.0", m_upstream_port},
+        nullptr,
+        [&](io::TcpConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error);
+            upstream_received.append(data.buf.get(), data.size);
+            if (upstream_received.size() == request.size()) {
+                client.send_data(response);
+                client.shutdown();
+            }
+        },
+        nullptr
+    );
+    ASSERT_FALSE(listen_error);
+
+    auto relay = new io::TcpRelay(loop);
+    relay->set_zero_copy(zero_copy);
+    auto upstream_client = new io::TcpClient(loop);
+
+    auto proxy_server = new io::TcpServer(loop);
+    listen_error = proxy_server->listen({"0.0.0.0", m_proxy_port},
+        [&](io::TcpConnectedClient& downstream, const io::Error& error) {
+            EXPECT_FALSE(error);
+
+            // Data which arrives before upstream connection is established stays in the socket
+            EXPECT_FALSE(downstream.pause_reading());
+
+            upstream_client->connect({m_default_addr, m_upstream_port},
+                [&](io::TcpClient& upstream, const io::Error& error) {
+                    EXPECT_FALSE(error);
+
+                    auto start_error = relay->start(downstream, upstream,
+                        [&](io::TcpRelay& relay, const io::Error& error) {
+                            EXPECT_FALSE(error);
+                            EXPECT_FALSE(relay.is_active());
+                            EXPECT_EQ(request.size(), relay.bytes_to_upstream());
+                            EXPECT_EQ(response.size(), relay.bytes_to_downstream());
+                            ++relay_end_callback_count;
+
+                            downstream.close();
+                            upstream_client->schedule_removal();
+                            relay.schedule_removal();
+                            proxy_server->schedule_removal();
+                            upstream_server->schedule_removal();
+                        }
+                    );
+                    EXPECT_FALSE(start_error);
+                    EXPECT_TRUE(relay->is_active());
+                    EXPECT_EQ(io::StatusCode::RESOURCE_BUSY_OR_LOCKED, relay->start(downstream, upstream).code());
+                },
+                [&](io::TcpClient&, const io::DataChunk&, const io::Error&) {
+                    ADD_FAILURE() << "Relayed data should not be passed to user";
+                }
+            );
+        },
+        [&](io::TcpConnectedClient&, const io::DataChunk&, const io::Error&) {
+            ADD_FAILURE() << "Relayed data should not be passed to user";
+        },
+        nullptr
+    );
+    ASSERT_FALSE(listen_error);
+
+    auto client = new io::TcpClient(loop);
+    client->connect({m_default_addr, m_proxy_port},
+        [&](io::TcpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error);
+            client.send_data(request);
+
+            // Slow reader, relay should wait until client's socket is writable
+            EXPECT_FALSE(client.pause_reading());
+            (new io::Timer(loop))->start(100,
+                [&](io::Timer& timer) {
+                    EXPECT_FALSE(client.resume_reading());
+                    timer.schedule_removal();
+                }
+            );
+        },
+        [&](io::TcpClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error);
+            client_received.append(data.buf.get(), data.size);
+        },
+        [&](io::TcpClient& client, const io::Error& error) {
+            // End of stream from the proxy, connection is closed by the library
+            EXPECT_FALSE(error);
+            ++client_close_callback_count;
+            client.schedule_removal();
+        }
+    );
+
+    ASSERT_EQ(0, loop.run());
+
+    EXPECT_EQ(1, relay_end_callback_count);
+    EXPECT_EQ(1, client_close_callback_count);
+    ASSERT_EQ(request.size(), upstream_received.size());
+    EXPECT_TRUE(request == upstream_received);
+    ASSERT_EQ(response.size(), client_received.size());
+    EXPECT_TRUE(response == client_received);
+}
+
+TEST_F(TcpRelayTest, default_state) {
+    io::EventLoop loop;
+
+    auto relay = new io::TcpRelay(loop);
+    EXPECT_FALSE(relay->is_active());
+    EXPECT_EQ(0, relay->bytes_to_upstream());
+    EXPECT_EQ(0, relay->bytes_to_downstream());
+#if defined(__linux__)
+    EXPECT_TRUE(relay->is_zero_copy());
+#else
+    EXPECT_FALSE(relay->is_zero_copy());
+#endif
+    relay->schedule_removal();
+
+    ASSERT_EQ(0, loop.run());
+}
+
+TEST_F(TcpRelayTest, start_with_not_connected_client) {
+    io::EventLoop loop;
+
+    auto relay = new io::TcpRelay(loop);
+    auto upstream_client = new io::TcpClient(loop);
+
+    auto server = new io::TcpServer(loop);
+    auto listen_error = server->listen({"0.0.0.0", m_proxy_port},
+        [&](io::TcpConnectedClient& downstream, const io::Error& error) {
+            EXPECT_FALSE(error);
+            EXPECT_EQ(io::StatusCode::NOT_CONNECTED, relay->start(downstream, *upstream_client).code());
+            EXPECT_FALSE(relay->is_active());
+
+            relay->schedule_removal();
+            upstream_client->schedule_removal();
+            server->schedule_removal();
+        },
+        nullptr,
+        nullptr
+    );
+    ASSERT_FALSE(listen_error);
+
+    auto client = new io::TcpClient(loop);
+    client->connect({m_default_addr, m_proxy_port},
+        nullptr,
+        nullptr,
+        [&](io::TcpClient& client, const io::Error& error) {
+            client.schedule_removal();
+        }
+    );
+
+    ASSERT_EQ(0, loop.run());
+}
+
+TEST_F(TcpRelayTest, relay_in_both_directions_zero_copy) {
+    test_relay_in_both_directions(true);
+}
+
+TEST_F(TcpRelayTest, relay_in_both_directions_buffered) {
+    test_relay_in_both_directions(false);
+}
@@ -0,0 +1,314 @@
+#include "UTCommon.h"
+
+#include "io/Timer.h"
+#include "io/TimerWheel.h"
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <vector>
+
+struct TimerWheelTest : public testing::Test,
+                        public LogRedirector {
+
+};
+
+TEST_F(TimerWheelTest, constructor) {
+    io::EventLoop loop;
+
+    auto wheel = new io::TimerWheel(loop, 5);
+    EXPECT_EQ(5, wheel->tick_ms());
+    EXPECT_EQ(0, wheel->active_timers_count());
+
+    ASSERT_EQ(0, loop.run());
+
+    wheel->schedule_removal();
+    ASSERT_EQ(0, loop.run());
+}
+
+TEST_F(TimerWheelTest, zero_tick_defaults_to_1ms) {
+    io::EventLoop loop;
+
+    auto wheel = new io::TimerWheel(loop, 0);
+    EXPECT_EQ(1, wheel->tick_ms());
+
+    wheel->schedule_removal();
+    ASSERT_EQ(0, loop.run());
+}
+
+TEST_F(TimerWheelTest, schedule_with_no_repeat) {
+    io::EventLoop loop;
+
+    auto wheel = new io::TimerWheel(loop);
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+    auto end_time = start_time;
+
+    const uint64_t TIMEOUT_MS = 100;
+    size_t call_counter = 0;
+
+    auto timer = new io::Timer(*wheel);
+    timer->start(TIMEOUT_MS, [&](io::Timer& timer) {
+        end_time = std::chrono::high_resolution_clock::now();
+        ++call_counter;
+    });
+
+    EXPECT_EQ(1, wheel->active_timers_count());
+    EXPECT_EQ(TIMEOUT_MS, timer->timeout_ms());
+    EXPECT_EQ(0, timer->repeat_ms());
+
+    ASSERT_EQ(0, loop.run());
+
+    const auto timer_duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+    EXPECT_GE(timer_duration, TIMEOUT_MS - 10); // -10 because sometime timer may wake up a bit earlier
+
+    EXPECT_EQ(1, call_counter);
+    EXPECT_EQ(0, wheel->active_timers_count());
+
+    timer->schedule_removal();
+    wheel->schedule_removal();
+    ASSERT_EQ(0, loop.run());
+}
+
+TEST_F(TimerWheelTest, schedule_with_repeat) {
+    io::EventLoop loop;
+
+    auto wheel = new io::TimerWheel(loop);
+
+    const uint64_t TIMEOUT_MS = 50;
+    const uint64_t REPEAT_MS = 300;
+    size_t call_counter = 0;
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+    auto end_time_1 = start_time;
+    auto end_time_2 = start_time;
+
+    auto timer = new io::Timer(*wheel);
+    timer->start(TIMEOUT_MS, REPEAT_MS, [&](io::Timer& timer) {
+        EXPECT_EQ(TIMEOUT_MS, timer.timeout_ms());
+        EXPECT_EQ(REPEAT_MS, timer.repeat_ms());
+
+        if (call_counter == 0) {
+            end_time_1 = std::chrono::high_resolution_clock::now();
+        } else {
+            end_time_2 = std::chrono::high_resolution_clock::now();
+            timer.stop();
+        }
+
+        ++call_counter;
+    });
+
+    ASSERT_EQ(0, loop.run());
+
+    EXPECT_EQ(2, call_counter);
+
+    const auto timer_duration_1 = std::chrono::duration_cast<std::chrono::milliseconds>(end_time_1 - start_time).count();
+    EXPECT_GE(timer_duration_1, TIMEOUT_MS - 10);
+
+    const auto timer_duration_2 = std::chrono::duration_cast<std::chrono::milliseconds>(end_time_2 - end_time_1).count();
+    EXPECT_GE(timer_duration_2, REPEAT_MS - 10);
+
+    timer->schedule_removal();
+    wheel->schedule_removal();
+    ASSERT_EQ(0, loop.run());
+}
+
+TEST_F(TimerWheelTest, multiple_intervals) {
+    io::EventLoop loop;
+
+    auto wheel = new io::TimerWheel(loop);
+
+    const std::deque<std::uint64_t> timeouts = {30, 300, 10};
+    std::vector<std::uint64_t> received_timeouts;
+
+    auto timer = new io::Timer(*wheel);
+    timer->start(timeouts, [&](io::Timer& timer) {
+        received_timeouts.push_back(timer.timeout_ms());
+    });
+
+    ASSERT_EQ(0, loop.run());
+
+    EXPECT_EQ(std::vector<std::uint64_t>(timeouts.begin(), timeouts.end()), received_timeouts);
+    EXPECT_EQ(3, timer->callback_call_counter());
+
+    timer->schedule_removal();
+    wheel->schedule_removal();
+    ASSERT_EQ(0, loop.run());
+}
+
+TEST_F(TimerWheelTest, expiration_order) {
+    // Timeouts cover the first and the second levels of the wheel
+    io::EventLoop loop;
+
+    auto wheel = new io::TimerWheel(loop);
+
+    const std::vector<std::uint64_t> timeouts = {700, 5, 260, 0, 90, 255, 513};
+    std::vector<std::uint64_t> received_timeouts;
+
+    for (auto timeout : timeouts) {
+        auto timer = new io::Timer(*wheel);
+        timer->start(timeout, [&](io::Timer& timer) {
+            received_timeouts.push_back(timer.timeout_ms());
+            timer.schedule_removal();
+        });
+    }
+
+    auto sorted_timeouts = timeouts;
+    std::sort(sorted_timeouts.begin(), sorted_timeouts.end());
+
+    ASSERT_EQ(0, loop.run());
+
+    EXPECT_EQ(sorted_timeouts, received_timeouts);
+
+    wheel->schedule_removal();
+    ASSERT_EQ(0, loop.run());
+}
+
+TEST_F(TimerWheelTest, coarse_tick) {
+    io::EventLoop loop;
+
+    auto wheel = new io::TimerWheel(loop, 50);
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+    auto end_time = start_time;
+
+    auto timer = new io::Timer(*wheel);
+    timer->start(60, [&](io::Timer& timer) {
+        end_time = std::chrono::high_resolution_clock::now();
+    });
+
+    ASSERT_EQ(0, loop.run());
+
+    // Timeout is rounded up to 2 ticks
+    const auto timer_duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+    EXPECT_GE(timer_duration, 100 - 10);
+
+    timer->schedule_removal();
+    wheel->schedule_removal();
+    ASSERT_EQ(0, loop.run());
+}
+
+TEST_F(TimerWheelTest, coarse_tick_timer_started_in_the_middle_of_tick) {
+    io::EventLoop loop;
+
+    auto wheel = new io::TimerWheel(loop, 50);
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+    auto end_time = start_time;
+
+    auto wheel_timer = new io::Timer(*wheel);
+
+    // Keeps wheel ticking from its start
+    auto long_wheel_timer = new io::Timer(*wheel);
+    long_wheel_timer->start(200, [&](io::Timer& timer) {
+    });
+
+    // Partially elapsed tick should not be counted in timeout
+    auto timer = new io::Timer(loop);
+    timer->start(30, [&](io::Timer& timer) {
+        start_time = std::chrono::high_resolution_clock::now();
+        wheel_timer->start(50, [&](io::Timer& timer) {
+            end_time = std::chrono::high_resolution_clock::now();
+        });
+    });
+
+    ASSERT_EQ(0, loop.run());
+
+    const auto timer_duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+    EXPECT_GE(timer_duration, 50 - 2);
+
+    timer->schedule_removal();
+    wheel_timer->schedule_removal();
+    long_wheel_timer->schedule_removal();
+    wheel->schedule_removal();
+    ASSERT_EQ(0, loop.run());
+}
+
+TEST_F(TimerWheelTest, restart_and_stop_from_callback) {
+    io::EventLoop loop;
+
+    auto wheel = new io::TimerWheel(loop);
+
+    auto timer_1 = new io::Timer(*wheel);
+    auto timer_2 = new io::Timer(*wheel);
+
+    std::size_t timer_1_counter = 0;
+    std::size_t timer_2_counter = 0;
+
+    // Both timers expire at the same tick, the first one stops the second
+    timer_1->start(10, [&](io::Timer& timer) {
+        ++timer_1_counter;
+        timer_2->stop();
+
+        if (timer_1_counter < 3) {
+            timer.start(0, [&](io::Timer& timer) {
+                ++timer_1_counter;
+            });
+        }
+    });
+    timer_2->start(10, [&](io::Timer& timer) {
+        ++timer_2_counter;
+    });
+
+    ASSERT_EQ(0, loop.run());
+
+    EXPECT_EQ(2, timer_1_counter);
+    EXPECT_EQ(0, timer_2_counter);
+
+    timer_1->schedule_removal();
+    timer_2->schedule_removal();
+    wheel->schedule_removal();
+    ASSERT_EQ(0, loop.run());
+}
+
+TEST_F(TimerWheelTest, 500k_timers_start_stop_restart) {
+    io::EventLoop loop;
+
+    auto wheel = new io::TimerWheel(loop);
+
+    std::size_t callback_counter = 0;
+    auto common_callback = [&](io::Timer& timer) {
+        ++callback_counter;
+        timer.schedule_removal();
+    };
+
+    const std::size_t COUNT = 500000;
+    std::vector<io::Timer*> timers;
+    timers.reserve(COUNT);
+
+    for (std::size_t i = 0; i < COUNT; ++i) {
+        auto timer = new io::Timer(*wheel);
+        timer->start(i % 500 + 1, common_callback);
+        timers.push_back(timer);
+    }
+
+    EXPECT_EQ(COUNT, wheel->active_timers_count());
+
+    // Stopping every second timer and restarting every fourth
+    std::size_t stopped_count = 0;
+    for (std::size_t i = 0; i < COUNT; i += 2) {
+        timers[i]->stop();
+        ++stopped_count;
+
+        if (i % 4 == 0) {
+            timers[i]->start(i % 300, common_callback);
+            --stopped_count;
+        }
+    }
+
+    EXPECT_EQ(COUNT - stopped_count, wheel->active_timers_count());
+
+    ASSERT_EQ(0, loop.run());
+
+    EXPECT_EQ(COUNT - stopped_count, callback_counter);
+    EXPECT_EQ(0, wheel->active_timers_count());
+
+    for (std::size_t i = 0; i < COUNT; i += 2) {
+        if (i % 4) {
+            timers[i]->schedule_removal();
+        }
+    }
+
+    wheel->schedule_removal();
+    ASSERT_EQ(0, loop.run());
+}
@@ -1,8 +1,10 @@
 #include "UTCommon.h"
 
+#include "io/FramedConnection.h"
 #include "io/Path.h"
 #include "io/TlsTcpClient.h"
 #include "io/TlsTcpServer.h"
+#include "io/Timer.h"
 #include "io/global/Version.h"
 
 #include <vector>
@@ -468,6 +470,285 @@ TEST_F(TlsTcpClientServerTest, server_send_data_to_client) {
     EXPECT_EQ(0, server_on_receive_callback_count);
 }
 
+TEST_F(TlsTcpClientServerTest, client_and_server_send_data_chunks) {
+    const std::string header = "HEADER:";
+    const std::string payload = "__payload__";
+    const std::string expected_message = "HEADER:payload";
+
+    std::shared_ptr<char> header_buf(new char[header.size()], [](const char* p) { delete[] p; });
+    std::copy(header.begin(), header.end(), header_buf.get());
+    std::shared_ptr<char> payload_buf(new char[payload.size()], [](const char* p) { delete[] p; });
+    std::copy(payload.begin(), payload.end(), payload_buf.get());
+    // Part of the buffer shares ownership of it
+    const std::shared_ptr<const char> payload_part(payload_buf, payload_buf.get() + 2);
+
+    const std::vector<io::DataChunk> chunks = {{header_buf, header.size()}, {nullptr, 0}, {payload_part, 7}};
+
+    std::size_t client_on_send_callback_count = 0;
+    std::size_t server_on_send_callback_count = 0;
+    std::string client_received_message;
+    std::string server_received_message;
+
+    io::EventLoop loop;
+
+    auto server = new io::TlsTcpServer(loop, m_cert_path, m_key_path);
+
+    auto listen_error = server->listen({m_default_addr, m_default_port},
+        [&](io::TlsTcpConnectedClient& client, const io::Error& error) {
+            EXPECT_FALSE(error);
+            client.send_data(chunks, [&](io::TlsTcpConnectedClient& client, const io::Error& error) {
+                EXPECT_FALSE(error);
+                ++server_on_send_callback_count;
+            });
+        },
+        [&](io::TlsTcpConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error);
+            server_received_message.append(data.buf.get(), data.size);
+            if (server_received_message.size() >= expected_message.size()) {
+                server->shutdown([](io::TlsTcpServer& server, const io::Error& error) {server.schedule_removal();});
+            }
+        });
+    ASSERT_FALSE(listen_error);
+
+    auto client = new io::TlsTcpClient(loop);
+
+    client->connect({m_default_addr, m_default_port},
+        [&](io::TlsTcpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error);
+            client.send_data(chunks, [&](io::TlsTcpClient& client, const io::Error& error) {
+                EXPECT_FALSE(error);
+                ++client_on_send_callback_count;
+            });
+        },
+        [&](io::TlsTcpClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error);
+            client_received_message.append(data.buf.get(), data.size);
+        },
+        [&](io::TlsTcpClient& client, const io::Error& error) {
+            client.schedule_removal();
+        }
+    );
+
+    ASSERT_EQ(0, loop.run());
+
+    EXPECT_EQ(1, client_on_send_callback_count);
+    EXPECT_EQ(1, server_on_send_callback_count);
+    EXPECT_EQ(expected_message, client_received_message);
+    EXPECT_EQ(expected_message, server_received_message);
+}
+
+TEST_F(TlsTcpClientServerTest, client_and_server_send_frames) {
+    const std::vector<std::string> messages = {"first", "", std::string(100000, 'x'), "last"};
+
+    std::vector<io::DataChunk> server_received_frames;
+    std::vector<std::string> client_received_frames;
+
+    io::EventLoop loop;
+
+    io::FramedConnection<io::TlsTcpConnectedClient> server_framer(
+        [&](io::TlsTcpConnectedClient& client, const io::DataChunk& frame, const io::Error& error) {
+            EXPECT_FALSE(error);
+            // Frames are retained, the ones which were not copied should not be overwritten by next data
+            server_received_frames.push_back(frame);
+            if (server_received_frames.size() == messages.size()) {
+                for (const auto& received_frame : server_received_frames) {
+                    server_framer.send_frame(client, received_frame.buf, static_cast<std::uint32_t>(received_frame.size));
+                }
+            }
+        },
+        4,
+        io::FramedConnection<io::TlsTcpConnectedClient>::ByteOrder::LITTLE,
+        100000);
+
+    auto server = new io::TlsTcpServer(loop, m_cert_path, m_key_path);
+
+    auto listen_error = server->listen({m_default_addr, m_default_port},
+        nullptr,
+        [&](io::TlsTcpConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error);
+            server_framer.on_receive(client, data);
+        });
+    ASSERT_FALSE(listen_error);
+
+    io::FramedConnection<io::TlsTcpClient> client_framer(
+        [&](io::TlsTcpClient& client, const io::DataChunk& frame, const io::Error& error) {
+            EXPECT_FALSE(error);
+            client_received_frames.emplace_back(frame.buf ? frame.buf.get() : "", frame.size);
+            if (client_received_frames.size() == messages.size()) {
+                client.schedule_removal();
+                server->shutdown([](io::TlsTcpServer& server, const io::Error& error) {server.schedule_removal();});
+            }
+        },
+        4,
+        io::FramedConnection<io::TlsTcpClient>::ByteOrder::LITTLE,
+        100000);
+
+    auto client = new io::TlsTcpClient(loop);
+
+    client->connect({m_default_addr, m_default_port},
+        [&](io::TlsTcpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error);
+            for (const auto& message : messages) {
+                client_framer.send_frame(client, message, [&](io::TlsTcpClient& client, const io::Error& error) {
+                    EXPECT_FALSE(error);
+                });
+            }
+        },
+        [&](io::TlsTcpClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error);
+            client_framer.on_receive(client, data);
+        }
+    );
+
+    ASSERT_EQ(0, loop.run());
+
+    EXPECT_EQ(messages.size(), server_received_frames.size());
+    EXPECT_EQ(messages, client_received_frames);
+}
+
+TEST_F(TlsTcpClientServerTest, client_send_data_chunks_invalid_arguments) {
+    io::EventLoop loop;
+
+    std::size_t client_on_send_callback_count = 0;
+
+    auto client = new io::TlsTcpClient(loop);
+    client->send_data(std::vector<io::DataChunk>(), [&](io::TlsTcpClient& client, const io::Error& error) {
+        EXPECT_EQ(io::StatusCode::NOT_CONNECTED, error.code());
+        ++client_on_send_callback_count;
+    });
+
+    client->schedule_removal();
+
+    ASSERT_EQ(0, loop.run());
+
+    EXPECT_EQ(1, client_on_send_callback_count);
+}
+
+TEST_F(TlsTcpClientServerTest, client_write_watermarks) {
+    const std::string message = "Hello!";
+
+    std::size_t client_buffer_full_count = 0;
+    std::size_t client_buffer_drained_count = 0;
+    std::size_t client_on_send_callback_count = 0;
+    std::string server_received_message;
+
+    io::EventLoop loop;
+
+    auto server = new io::TlsTcpServer(loop, m_cert_path, m_key_path);
+
+    auto listen_error = server->listen({m_default_addr, m_default_port},
+        [&](io::TlsTcpConnectedClient& client, const io::Error& error) {
+            EXPECT_FALSE(error);
+        },
+        [&](io::TlsTcpConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error);
+            server_received_message.append(data.buf.get(), data.size);
+            if (server_received_message.size() >= message.size()) {
+                server->shutdown([](io::TlsTcpServer& server, const io::Error& error) {server.schedule_removal();});
+            }
+        });
+    ASSERT_FALSE(listen_error);
+
+    auto client = new io::TlsTcpClient(loop);
+    EXPECT_EQ(io::StatusCode::INVALID_ARGUMENT, client->set_write_watermarks(2, 1).code());
+    EXPECT_EQ(0, client->pending_write_bytes());
+    EXPECT_FALSE(client->is_write_buffer_full());
+
+    client->set_on_write_buffer_full([&](io::TlsTcpClient& client) {
+        EXPECT_TRUE(client.is_write_buffer_full());
+        ++client_buffer_full_count;
+    });
+    client->set_on_write_buffer_drained([&](io::TlsTcpClient& client) {
+        EXPECT_FALSE(client.is_write_buffer_full());
+        EXPECT_EQ(0, client.pending_write_bytes());
+        ++client_buffer_drained_count;
+    });
+
+    client->connect({m_default_addr, m_default_port},
+        [&](io::TlsTcpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error);
+            // Any pending byte fills the buffer
+            EXPECT_FALSE(client.set_write_watermarks(0, 1));
+            client.send_data(message, [&](io::TlsTcpClient& client, const io::Error& error) {
+                EXPECT_FALSE(error);
+                ++client_on_send_callback_count;
+            });
+
+            // Encrypted message is larger than the original one
+            EXPECT_LT(message.size(), client.pending_write_bytes());
+            EXPECT_TRUE(client.is_write_buffer_full());
+            EXPECT_EQ(1, client_buffer_full_count);
+        },
+        nullptr,
+        [&](io::TlsTcpClient& client, const io::Error& error) {
+            client.schedule_removal();
+        }
+    );
+
+    ASSERT_EQ(0, loop.run());
+
+    EXPECT_EQ(1, client_on_send_callback_count);
+    EXPECT_EQ(1, client_buffer_full_count);
+    EXPECT_EQ(1, client_buffer_drained_count);
+    EXPECT_EQ(message, server_received_message);
+}
+
+TEST_F(TlsTcpClientServerTest, server_pause_and_resume_reading) {
+    const std::string message = "Hello!";
+
+    bool server_reading_resumed = false;
+    std::string server_received_message;
+
+    io::EventLoop loop;
+
+    auto server = new io::TlsTcpServer(loop, m_cert_path, m_key_path);
+
+    auto listen_error = server->listen({m_default_addr, m_default_port},
+        [&](io::TlsTcpConnectedClient& client, const io::Error& error) {
+            EXPECT_FALSE(error);
+            EXPECT_FALSE(client.pause_reading());
+            EXPECT_TRUE(client.is_reading_paused());
+
+            (new io::Timer(loop))->start(100,
+                [&](io::Timer& timer) {
+                    EXPECT_TRUE(server_received_message.empty());
+                    server_reading_resumed = true;
+                    EXPECT_FALSE(client.resume_reading());
+                    EXPECT_FALSE(client.is_reading_paused());
+                    timer.schedule_removal();
+                }
+            );
+        },
+        [&](io::TlsTcpConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error);
+            EXPECT_TRUE(server_reading_resumed);
+            server_received_message.append(data.buf.get(), data.size);
+            if (server_received_message.size() >= message.size()) {
+                server->shutdown([](io::TlsTcpServer& server, const io::Error& error) {server.schedule_removal();});
+            }
+        });
+    ASSERT_FALSE(listen_error);
+
+    auto client = new io::TlsTcpClient(loop);
+    EXPECT_EQ(io::StatusCode::NOT_CONNECTED, client->pause_reading().code());
+    EXPECT_FALSE(client->is_reading_paused());
+
+    client->connect({m_default_addr, m_default_port},
+        [&](io::TlsTcpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error);
+            client.send_data(message);
+        },
+        nullptr,
+        [&](io::TlsTcpClient& client, const io::Error& error) {
+            client.schedule_removal();
+        }
+    );
+
+    ASSERT_EQ(0, loop.run());
+
+    EXPECT_EQ(message, server_received_message);
+}
+
 TEST_F(TlsTcpClientServerTest, server_send_simultaneous_multiple_chunks_to_client) {
     const std::vector<std::string> messages = {
         "a",
@@ -7,8 +7,16 @@
 #include "io/Timer.h"
 
 #include <cstdint>
+#include <cstring>
+#include <functional>
+#include <set>
+#include <string>
 #include <unordered_map>
 #include <thread>
+#include <vector>
+
+// Just to include platform-specific networking headers
+#include <uv.h>
 
 struct UdpClientServerTest : public testing::Test,
                              public LogRedirector {
@@ -1830,6 +1838,93 @@ TEST_F(UdpClientServerTest, double_close_peer_from_server) {
     EXPECT_EQ(1, server_on_data_receive_callback_count);
 }
 
+TEST_F(UdpClientServerTest, close_many_peers_from_server) {
+    io::EventLoop loop;
+
+    const std::size_t CLIENTS_COUNT = 50;
+    const std::size_t INACTIVE_TIMEOUT = 100;
+
+    std::size_t server_on_new_peer_callback_count = 0;
+    std::size_t server_on_data_receive_callback_count = 0;
+
+    auto server = new io::UdpServer(loop);
+    auto error = server->start_receive(
+        { m_default_addr, m_default_port },
+        [&](io::UdpPeer& peer, const io::Error& error) {
+            EXPECT_FALSE(error);
+            ++server_on_new_peer_callback_count;
+        },
+        [&] (io::UdpPeer& peer, const io::DataChunk&, const io::Error& error) {
+            EXPECT_FALSE(error);
+            ++server_on_data_receive_callback_count;
+            // Each next peer is quarantined longer
+            peer.close(INACTIVE_TIMEOUT + server_on_data_receive_callback_count % CLIENTS_COUNT);
+        },
+        1000 * 5,
+        nullptr
+    );
+    EXPECT_FALSE(error);
+
+    // Clients are bound with SO_REUSEADDR, so the same port could be assigned to several of them.
+    // Such clients are indistinguishable for the server, so they are replaced.
+    std::vector<io::UdpClient*> clients;
+    std::set<std::uint16_t> client_ports;
+    while (clients.size() < CLIENTS_COUNT) {
+        auto client = new io::UdpClient(loop);
+        EXPECT_FALSE(client->set_destination({0x7F000001u, m_default_port}));
+        if (!client_ports.insert(client->bound_port()).second) {
+            client->schedule_removal();
+            continue;
+        }
+
+        clients.push_back(client);
+        client->send_data("!");
+    }
+
+    auto send_to_inactive_timer = new io::Timer(loop);
+    send_to_inactive_timer->start(
+        INACTIVE_TIMEOUT / 2,
+        [&] (io::Timer& timer) {
+            EXPECT_EQ(CLIENTS_COUNT, server_on_data_receive_callback_count);
+
+            for (auto client : clients) {
+                client->send_data("!"); // Ignored
+            }
+            timer.schedule_removal();
+        }
+    );
+
+    auto send_after_timeout_timer = new io::Timer(loop);
+    send_after_timeout_timer->start(
+        INACTIVE_TIMEOUT * 2,
+        [&] (io::Timer& timer) {
+            EXPECT_EQ(CLIENTS_COUNT, server_on_data_receive_callback_count);
+
+            for (auto client : clients) {
+                client->send_data("!");
+            }
+            timer.schedule_removal();
+        }
+    );
+
+    auto cleanup_timer = new io::Timer(loop);
+    cleanup_timer->start(
+        INACTIVE_TIMEOUT * 3,
+        [&] (io::Timer& timer) {
+            server->schedule_removal();
+            for (auto client : clients) {
+                client->schedule_removal();
+            }
+            timer.schedule_removal();
+        }
+    );
+
+    EXPECT_EQ(0, loop.run());
+
+    EXPECT_EQ(CLIENTS_COUNT * 2, server_on_new_peer_callback_count);
+    EXPECT_EQ(CLIENTS_COUNT * 2, server_on_data_receive_callback_count);
+}
+
 TEST_F(UdpClientServerTest, close_peer_from_server_and_than_try_send) {
     io::EventLoop loop;
 
@@ -2145,3 +2240,678 @@ TEST_F(UdpClientServerTest, ipv6_peer_identity) {
 // TODO: client start receive without destination set???? Allow receive from any peer????
 
 // TODO: server receive close and receive again
+
+TEST_F(UdpClientServerTest, server_receive_buffers_reuse) {
+    io::EventLoop loop;
+
+    const std::size_t MESSAGES_COUNT = 200;
+    std::size_t server_on_data_receive_count = 0;
+    std::size_t pool_hits = 0;
+    std::size_t pool_misses = 0;
+
+    auto server = new io::UdpServer(loop);
+    EXPECT_EQ(64 * 1024, server->max_datagram_size());
+    EXPECT_EQ(0, server->receive_buffer_pool_hits());
+    EXPECT_EQ(0, server->receive_buffer_pool_misses());
+
+    auto listen_error = server->start_receive({m_default_addr, m_default_port},
+        [&](io::UdpPeer& peer, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error);
+            EXPECT_EQ(std::to_string(server_on_data_receive_count), std::string(data.buf.get(), data.size));
+            if (++server_on_data_receive_count == MESSAGES_COUNT) {
+                pool_hits = server->receive_buffer_pool_hits();
+                pool_misses = server->receive_buffer_pool_misses();
+                server->schedule_removal();
+            }
+        }
+    );
+    ASSERT_FALSE(listen_error);
+
+    auto client = new io::UdpClient(loop);
+    client->set_destination({0x7F000001u, m_default_port});
+
+    std::size_t messages_sent = 0;
+    std::function<void(io::UdpClient&, const io::Error&)> on_send = [&](io::UdpClient& client, const io::Error& error) {
+        EXPECT_FALSE(error);
+        if (++messages_sent == MESSAGES_COUNT) {
+            client.schedule_removal();
+            return;
+        }
+
+        client.send_data(std::to_string(messages_sent), on_send);
+    };
+    client->send_data(std::to_string(messages_sent), on_send);
+
+    ASSERT_EQ(0, loop.run());
+
+    EXPECT_EQ(MESSAGES_COUNT, server_on_data_receive_count);
+    // Buffers are not retained by callback, so the single buffer is reused
+    EXPECT_EQ(1, pool_misses);
+    EXPECT_EQ(MESSAGES_COUNT - 1, pool_hits);
+}
+
+TEST_F(UdpClientServerTest, server_retained_receive_buffers_are_not_reused) {
+    io::EventLoop loop;
+
+    const std::size_t MESSAGES_COUNT = 10;
+    const std::size_t DATAGRAM_SIZE = 100;
+
+    std::vector<io::DataChunk> retained_chunks;
+    std::size_t pool_hits = 0;
+    std::size_t pool_misses = 0;
+
+    auto server = new io::UdpServer(loop);
+    EXPECT_EQ(io::StatusCode::INVALID_ARGUMENT, server->set_max_datagram_size(0).code());
+    EXPECT_EQ(io::StatusCode::INVALID_ARGUMENT, server->set_max_datagram_size(1024 * 1024).code());
+    EXPECT_FALSE(server->set_max_datagram_size(DATAGRAM_SIZE));
+    EXPECT_EQ(DATAGRAM_SIZE, server->max_datagram_size());
+
+    auto listen_error = server->start_receive({m_default_addr, m_default_port},
+        [&](io::UdpPeer& peer, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error);
+            // Larger datagrams are truncated to the max datagram size
+            EXPECT_EQ(DATAGRAM_SIZE, data.size);
+
+            retained_chunks.push_back(data);
+            if (retained_chunks.size() == MESSAGES_COUNT) {
+                pool_hits = server->receive_buffer_pool_hits();
+                pool_misses = server->receive_buffer_pool_misses();
+                server->schedule_removal();
+            }
+        }
+    );
+    ASSERT_FALSE(listen_error);
+
+    auto client = new io::UdpClient(loop);
+    client->set_destination({0x7F000001u, m_default_port});
+
+    std::size_t messages_sent = 0;
+    std::function<void(io::UdpClient&, const io::Error&)> on_send = [&](io::UdpClient& client, const io::Error& error) {
+        EXPECT_FALSE(error);
+        if (++messages_sent == MESSAGES_COUNT) {
+            client.schedule_removal();
+            return;
+        }
+
+        client.send_data(std::string(DATAGRAM_SIZE * 2, char('a' + messages_sent)), on_send);
+    };
+    client->send_data(std::string(DATAGRAM_SIZE * 2, char('a' + messages_sent)), on_send);
+
+    ASSERT_EQ(0, loop.run());
+
+    ASSERT_EQ(MESSAGES_COUNT, retained_chunks.size());
+    EXPECT_EQ(MESSAGES_COUNT, pool_misses);
+    EXPECT_EQ(0, pool_hits);
+
+    // Retained data was not overwritten by the next datagrams
+    for (std::size_t i = 0; i < retained_chunks.size(); ++i) {
+        EXPECT_EQ(std::string(DATAGRAM_SIZE, char('a' + i)),
+                  std::string(retained_chunks[i].buf.get(), retained_chunks[i].size));
+    }
+}
+
+TEST_F(UdpClientServerTest, server_read_buffer_allocator) {
+    io::EventLoop loop;
+
+    const std::size_t MESSAGES_COUNT = 10;
+    const std::size_t DATAGRAM_SIZE = 100;
+
+    std::set<const char*> allocated_buffers;
+    std::size_t allocate_count = 0;
+    std::size_t release_count = 0;
+
+    std::vector<io::DataChunk> retained_chunks;
+
+    auto server = new io::UdpServer(loop);
+    EXPECT_FALSE(server->set_max_datagram_size(DATAGRAM_SIZE));
+    // Batch receive takes buffers from allocator too
+    EXPECT_FALSE(server->set_receive_batch_size(4));
+    EXPECT_EQ(io::StatusCode::INVALID_ARGUMENT,
+              server->set_read_buffer_allocator({nullptr, [](char*) {}}).code());
+    EXPECT_FALSE(server->set_read_buffer_allocator({
+        [&](std::size_t size) -> char* {
+            EXPECT_EQ(DATAGRAM_SIZE, size);
+            ++allocate_count;
+            auto buffer = new char[size];
+            allocated_buffers.insert(buffer);
+            return buffer;
+        },
+        [&](char* buffer) {
+            EXPECT_EQ(1, allocated_buffers.erase(buffer));
+            ++release_count;
+            delete[] buffer;
+        }
+    }));
+
+    auto listen_error = server->start_receive({m_default_addr, m_default_port},
+        [&](io::UdpPeer& peer, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error);
+            EXPECT_EQ(1, allocated_buffers.count(data.buf.get()));
+
+            retained_chunks.push_back(data);
+            if (retained_chunks.size() == MESSAGES_COUNT) {
+                server->schedule_removal();
+            }
+        }
+    );
+    ASSERT_FALSE(listen_error);
+
+    auto client = new io::UdpClient(loop);
+    client->set_destination({0x7F000001u, m_default_port});
+
+    std::size_t messages_sent = 0;
+    std::function<void(io::UdpClient&, const io::Error&)> on_send = [&](io::UdpClient& client, const io::Error& error) {
+        EXPECT_FALSE(error);
+        if (++messages_sent == MESSAGES_COUNT) {
+            client.schedule_removal();
+            return;
+        }
+
+        client.send_data(std::string(DATAGRAM_SIZE, char('a' + messages_sent)), on_send);
+    };
+    client->send_data(std::string(DATAGRAM_SIZE, char('a' + messages_sent)), on_send);
+
+    ASSERT_EQ(0, loop.run());
+
+    ASSERT_EQ(MESSAGES_COUNT, retained_chunks.size());
+    for (std::size_t i = 0; i < retained_chunks.size(); ++i) {
+        EXPECT_EQ(std::string(DATAGRAM_SIZE, char('a' + i)),
+                  std::string(retained_chunks[i].buf.get(), retained_chunks[i].size));
+    }
+
+    EXPECT_EQ(allocate_count - MESSAGES_COUNT, release_count);
+    retained_chunks.clear();
+    EXPECT_EQ(allocate_count, release_count);
+    EXPECT_TRUE(allocated_buffers.empty());
+}
+
+TEST_F(UdpClientServerTest, receive_batch_size_invalid_values) {
+    io::EventLoop loop;
+
+    auto server = new io::UdpServer(loop);
+    EXPECT_EQ(1, server->receive_batch_size());
+    EXPECT_EQ(io::Error(io::StatusCode::INVALID_ARGUMENT), server->set_receive_batch_size(0));
+    EXPECT_EQ(io::Error(io::StatusCode::INVALID_ARGUMENT), server->set_receive_batch_size(100500));
+    EXPECT_FALSE(server->set_receive_batch_size(32));
+    EXPECT_EQ(32, server->receive_batch_size());
+
+    auto client = new io::UdpClient(loop);
+    EXPECT_EQ(1, client->receive_batch_size());
+    EXPECT_EQ(io::Error(io::StatusCode::INVALID_ARGUMENT), client->set_receive_batch_size(0));
+    EXPECT_EQ(io::Error(io::StatusCode::INVALID_ARGUMENT), client->set_receive_batch_size(100500));
+    EXPECT_FALSE(client->set_receive_batch_size(32));
+    EXPECT_EQ(32, client->receive_batch_size());
+
+    server->schedule_removal();
+    client->schedule_removal();
+
+    ASSERT_EQ(0, loop.run());
+}
+
+TEST_F(UdpClientServerTest, server_batch_receive) {
+    io::EventLoop loop;
+
+    const std::size_t MESSAGES_COUNT = 100;
+    std::size_t server_on_data_receive_count = 0;
+    std::size_t batches_count = 0;
+
+    auto server = new io::UdpServer(loop);
+    ASSERT_FALSE(server->set_receive_batch_size(16));
+
+    auto listen_error = server->start_receive_batch({m_default_addr, m_default_port},
+        [&](io::UdpServer& server, const io::UdpServer::ReceivedDatagram* datagrams, std::size_t count, const io::Error& error) {
+            EXPECT_FALSE(error);
+            EXPECT_GT(count, 0);
+            EXPECT_LE(count, 16);
+            ++batches_count;
+
+            for (std::size_t i = 0; i < count; ++i) {
+                ASSERT_TRUE(datagrams[i].peer);
+                EXPECT_EQ(0x7F000001u, datagrams[i].peer->endpoint().ipv4_addr());
+                EXPECT_EQ(std::to_string(server_on_data_receive_count),
+                          std::string(datagrams[i].data.buf.get(), datagrams[i].data.size));
+                ++server_on_data_receive_count;
+            }
+
+            if (server_on_data_receive_count == MESSAGES_COUNT) {
+                server.schedule_removal();
+            }
+        }
+    );
+    ASSERT_FALSE(listen_error);
+
+    auto client = new io::UdpClient(loop);
+    client->set_destination({0x7F000001u, m_default_port});
+
+    std::size_t messages_sent = 0;
+    for (std::size_t i = 0; i < MESSAGES_COUNT; ++i) {
+        client->send_data(std::to_string(i), [&](io::UdpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error);
+            if (++messages_sent == MESSAGES_COUNT) {
+                client.schedule_removal();
+            }
+        });
+    }
+
+    ASSERT_EQ(0, loop.run());
+
+    EXPECT_EQ(MESSAGES_COUNT, server_on_data_receive_count);
+#if defined(__linux__)
+    EXPECT_LT(batches_count, MESSAGES_COUNT);
+#else
+    EXPECT_EQ(MESSAGES_COUNT, batches_count);
+#endif
+}
+
+TEST_F(UdpClientServerTest, server_batch_receive_with_peers_tracking) {
+    io::EventLoop loop;
+
+    const std::size_t MESSAGES_COUNT = 50;
+    std::size_t server_on_data_receive_count = 0;
+    std::size_t server_on_new_peer_count = 0;
+    std::size_t server_on_timeout_count = 0;
+
+    auto server = new io::UdpServer(loop);
+    ASSERT_FALSE(server->set_receive_batch_size(8));
+
+    io::UdpPeer* first_peer = nullptr;
+
+    auto listen_error = server->start_receive({m_default_addr, m_default_port},
+        [&](io::UdpPeer& peer, const io::Error& error) {
+            EXPECT_FALSE(error);
+            ++server_on_new_peer_count;
+        },
+        [&](io::UdpPeer& peer, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error);
+            if (first_peer == nullptr) {
+                first_peer = &peer;
+            }
+            EXPECT_EQ(first_peer, &peer);
+            EXPECT_EQ(std::to_string(server_on_data_receive_count), std::string(data.buf.get(), data.size));
+            ++server_on_data_receive_count;
+        },
+        100,
+        [&](io::UdpPeer& peer, const io::Error& error) {
+            EXPECT_FALSE(error);
+            ++server_on_timeout_count;
+            server->schedule_removal();
+        }
+    );
+    ASSERT_FALSE(listen_error);
+
+    auto client = new io::UdpClient(loop);
+    client->set_destination({0x7F000001u, m_default_port});
+
+    std::size_t messages_sent = 0;
+    for (std::size_t i = 0; i < MESSAGES_COUNT; ++i) {
+        client->send_data(std::to_string(i), [&](io::UdpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error);
+            if (++messages_sent == MESSAGES_COUNT) {
+                client.schedule_removal();
+            }
+        });
+    }
+
+    ASSERT_EQ(0, loop.run());
+
+    EXPECT_EQ(MESSAGES_COUNT, server_on_data_receive_count);
+    EXPECT_EQ(1, server_on_new_peer_count);
+    EXPECT_EQ(1, server_on_timeout_count);
+}
+
+TEST_F(UdpClientServerTest, empty_datagrams_are_skipped_with_and_without_batch_receive) {
+    for (std::size_t batch_size : {1, 16}) {
+        io::EventLoop loop;
+
+        std::vector<std::string> received;
+
+        auto server = new io::UdpServer(loop);
+        ASSERT_FALSE(server->set_receive_batch_size(batch_size));
+        auto listen_error = server->start_receive({m_default_addr, m_default_port},
+            [&](io::UdpPeer& peer, const io::DataChunk& data, const io::Error& error) {
+                EXPECT_FALSE(error);
+                received.emplace_back(data.buf.get(), data.size);
+                if (received.size() == 3) {
+                    server->schedule_removal();
+                }
+            }
+        );
+        ASSERT_FALSE(listen_error);
+
+        // Sending with raw socket, because UdpClient rejects empty data
+        auto socket_handle = ::socket(AF_INET, SOCK_DGRAM, 0);
+        ASSERT_GT(socket_handle, 0);
+
+        ::sockaddr_in dest_addr{0};
+        dest_addr.sin_family = AF_INET;
+        dest_addr.sin_addr.s_addr = ::htonl(0x7F000001u);
+        dest_addr.sin_port = ::htons(m_default_port);
+
+        for (const std::string message : {"a", "", "b", "", "", "c"}) {
+            const auto result = ::sendto(socket_handle, message.data(), message.size(), 0,
+                                         reinterpret_cast<sockaddr*>(&dest_addr), sizeof(dest_addr));
+            ASSERT_NE(-1, result);
+        }
+
+        ::close(socket_handle);
+
+        ASSERT_EQ(0, loop.run());
+
+        EXPECT_EQ((std::vector<std::string>{"a", "b", "c"}), received) << "batch size: " << batch_size;
+    }
+}
+
+TEST_F(UdpClientServerTest, client_batch_receive) {
+    io::EventLoop loop;
+
+    const std::size_t MESSAGES_COUNT = 100;
+    std::size_t client_on_data_receive_count = 0;
+
+    auto server = new io::UdpServer(loop);
+    auto listen_error = server->start_receive({m_default_addr, m_default_port},
+        [&](io::UdpPeer& peer, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error);
+            for (std::size_t i = 0; i < MESSAGES_COUNT; ++i) {
+                peer.send_data(std::to_string(i));
+            }
+        }
+    );
+    ASSERT_FALSE(listen_error);
+
+    auto client = new io::UdpClient(loop);
+    ASSERT_FALSE(client->set_receive_batch_size(16));
+    ASSERT_FALSE(client->set_destination({0x7F000001u, m_default_port}));
+
+    auto receive_error = client->start_receive(
+        [&](io::UdpClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error);
+            EXPECT_EQ(std::to_string(client_on_data_receive_count), std::string(data.buf.get(), data.size));
+            if (++client_on_data_receive_count == MESSAGES_COUNT) {
+                client.schedule_removal();
+                server->schedule_removal();
+            }
+        }
+    );
+    ASSERT_FALSE(receive_error);
+
+    client->send_data("start");
+
+    ASSERT_EQ(0, loop.run());
+
+    EXPECT_EQ(MESSAGES_COUNT, client_on_data_receive_count);
+}
+
+TEST_F(UdpClientServerTest, server_send_batch) {
+    io::EventLoop loop;
+
+    const std::size_t MESSAGES_COUNT = 100;
+    std::size_t server_on_datagram_sent_count = 0;
+    std::size_t server_on_batch_sent_count = 0;
+    std::size_t client_on_data_receive_count = 0;
+
+    auto server = new io::UdpServer(loop);
+    auto listen_error = server->start_receive({m_default_addr, m_default_port},
+        [&](io::UdpPeer& peer, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error);
+
+            std::vector<io::UdpServer::OutgoingDatagram> datagrams;
+            for (std::size_t i = 0; i < MESSAGES_COUNT; ++i) {
+                const auto message = std::to_string(i);
+                std::shared_ptr<char> buf(new char[message.size()], std::default_delete<char[]>());
+                std::memcpy(buf.get(), message.c_str(), message.size());
+
+                datagrams.push_back({peer.endpoint(), buf, static_cast<std::uint32_t>(message.size()),
+                    [&](io::UdpServer& server, const io::Endpoint& endpoint, const io::Error& error) {
+                        EXPECT_FALSE(error);
+                        EXPECT_EQ(0x7F000001u, endpoint.ipv4_addr());
+                        ++server_on_datagram_sent_count;
+                    }
+                });
+            }
+
+            server->send_batch(std::move(datagrams), [&](io::UdpServer& server, const io::Error& error) {
+                EXPECT_FALSE(error);
+                EXPECT_EQ(MESSAGES_COUNT, server_on_datagram_sent_count);
+                ++server_on_batch_sent_count;
+            });
+        }
+    );
+    ASSERT_FALSE(listen_error);
+
+    auto client = new io::UdpClient(loop);
+    ASSERT_FALSE(client->set_destination({0x7F000001u, m_default_port}));
+    auto receive_error = client->start_receive(
+        [&](io::UdpClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error);
+            EXPECT_EQ(std::to_string(client_on_data_receive_count), std::string(data.buf.get(), data.size));
+            if (++client_on_data_receive_count == MESSAGES_COUNT) {
+                client.schedule_removal();
+                server->schedule_removal();
+            }
+        }
+    );
+    ASSERT_FALSE(receive_error);
+
+    client->send_data("start");
+
+    ASSERT_EQ(0, loop.run());
+
+    EXPECT_EQ(MESSAGES_COUNT, client_on_data_receive_count);
+    EXPECT_EQ(MESSAGES_COUNT, server_on_datagram_sent_count);
+    EXPECT_EQ(1, server_on_batch_sent_count);
+}
+
+TEST_F(UdpClientServerTest, client_send_batch) {
+    io::EventLoop loop;
+
+    const std::size_t BATCHES_COUNT = 3;
+    const std::size_t MESSAGES_IN_BATCH_COUNT = 50;
+    std::size_t server_on_data_receive_count = 0;
+    std::size_t client_on_datagram_sent_count = 0;
+    std::size_t client_on_batch_sent_count = 0;
+
+    auto server = new io::UdpServer(loop);
+    auto listen_error = server->start_receive({m_default_addr, m_default_port},
+        [&](io::UdpPeer& peer, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error);
+            EXPECT_EQ(std::to_string(server_on_data_receive_count), std::string(data.buf.get(), data.size));
+            if (++server_on_data_receive_count == BATCHES_COUNT * MESSAGES_IN_BATCH_COUNT) {
+                server->schedule_removal();
+            }
+        }
+    );
+    ASSERT_FALSE(listen_error);
+
+    auto client = new io::UdpClient(loop);
+    ASSERT_FALSE(client->set_destination({0x7F000001u, m_default_port}));
+
+    // All batches are queued during the same loop iteration and sent together
+    for (std::size_t batch_index = 0; batch_index < BATCHES_COUNT; ++batch_index) {
+        std::vector<io::UdpClient::OutgoingDatagram> datagrams;
+        for (std::size_t i = 0; i < MESSAGES_IN_BATCH_COUNT; ++i) {
+            const auto message = std::to_string(batch_index * MESSAGES_IN_BATCH_COUNT + i);
+            std::shared_ptr<char> buf(new char[message.size()], std::default_delete<char[]>());
+            std::memcpy(buf.get(), message.c_str(), message.size());
+
+            datagrams.push_back({buf, static_cast<std::uint32_t>(message.size()),
+                [&](io::UdpClient& client, const io::Error& error) {
+                    EXPECT_FALSE(error);
+                    ++client_on_datagram_sent_count;
+                }
+            });
+        }
+
+        client->send_batch(std::move(datagrams), [&](io::UdpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error);
+            if (++client_on_batch_sent_count == BATCHES_COUNT) {
+                client.schedule_removal();
+            }
+        });
+    }
+
+    ASSERT_EQ(0, loop.run());
+
+    EXPECT_EQ(BATCHES_COUNT * MESSAGES_IN_BATCH_COUNT, server_on_data_receive_count);
+    EXPECT_EQ(BATCHES_COUNT * MESSAGES_IN_BATCH_COUNT, client_on_datagram_sent_count);
+    EXPECT_EQ(BATCHES_COUNT, client_on_batch_sent_count);
+}
+
+TEST_F(UdpClientServerTest, client_send_batch_errors) {
+    io::EventLoop loop;
+
+    std::size_t client_on_batch_sent_count = 0;
+    std::size_t client_on_datagram_sent_count = 0;
+
+    std::shared_ptr<char> buf(new char[4], std::default_delete<char[]>());
+    std::memcpy(buf.get(), "data", 4);
+
+    auto client = new io::UdpClient(loop);
+    client->send_batch({{buf, 4, nullptr}}, [&](io::UdpClient& client, const io::Error& error) {
+        EXPECT_EQ(io::StatusCode::DESTINATION_ADDRESS_REQUIRED, error.code());
+        ++client_on_batch_sent_count;
+    });
+
+    ASSERT_FALSE(client->set_destination({0x7F000001u, m_default_port}));
+
+    client->send_batch({}, [&](io::UdpClient& client, const io::Error& error) {
+        EXPECT_EQ(io::StatusCode::INVALID_ARGUMENT, error.code());
+        ++client_on_batch_sent_count;
+    });
+
+    // Only datagram of size 0 fails
+    client->send_batch({{buf, 4, nullptr}, {buf, 0, nullptr}, {buf, 4, nullptr}},
+        [&](io::UdpClient& client, const io::Error& error) {
+            EXPECT_EQ(io::StatusCode::INVALID_ARGUMENT, error.code());
+            ++client_on_batch_sent_count;
+
+            // Queued datagrams are canceled on close
+            auto on_canceled = [&](io::UdpClient& client, const io::Error& error) {
+                EXPECT_EQ(io::StatusCode::OPERATION_CANCELED, error.code());
+                ++client_on_datagram_sent_count;
+            };
+            client.send_batch({{buf, 4, on_canceled}, {buf, 4, on_canceled}},
+                [&](io::UdpClient& client, const io::Error& error) {
+                    EXPECT_EQ(io::StatusCode::OPERATION_CANCELED, error.code());
+                    ++client_on_batch_sent_count;
+                }
+            );
+
+            client.schedule_removal();
+        }
+    );
+
+    ASSERT_EQ(0, loop.run());
+
+    EXPECT_EQ(4, client_on_batch_sent_count);
+    EXPECT_EQ(2, client_on_datagram_sent_count);
+}
+
+TEST_F(UdpClientServerTest, untracked_peers_reuse) {
+    io::EventLoop loop;
+
+    const std::size_t MESSAGES_COUNT = 100;
+    std::size_t server_on_data_receive_count = 0;
+    std::size_t client_on_data_receive_count = 0;
+
+    auto server = new io::UdpServer(loop);
+    auto listen_error = server->start_receive({m_default_addr, m_default_port},
+        [&](io::UdpPeer& peer, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error);
+            // Recycled peer does not keep data of the previous one
+            EXPECT_EQ(nullptr, peer.user_data());
+            peer.set_user_data(&server_on_data_receive_count);
+
+            EXPECT_EQ(0x7F000001u, peer.endpoint().ipv4_addr());
+            EXPECT_EQ(std::to_string(server_on_data_receive_count), std::string(data.buf.get(), data.size));
+            ++server_on_data_receive_count;
+
+            // Replying from the receive callback
+            peer.send_data(std::string(data.buf.get(), data.size));
+        }
+    );
+    ASSERT_FALSE(listen_error);
+
+    auto client = new io::UdpClient(loop);
+    ASSERT_FALSE(client->set_destination({0x7F000001u, m_default_port}));
+    auto receive_error = client->start_receive(
+        [&](io::UdpClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error);
+            EXPECT_EQ(std::to_string(client_on_data_receive_count), std::string(data.buf.get(), data.size));
+            if (++client_on_data_receive_count == MESSAGES_COUNT) {
+                client.schedule_removal();
+                server->schedule_removal();
+                return;
+            }
+
+            client.send_data(std::to_string(client_on_data_receive_count));
+        }
+    );
+    ASSERT_FALSE(receive_error);
+
+    std::size_t allocated_peers_count = 0;
+    std::size_t reused_peers_count = 0;
+    client->send_data("0");
+
+    loop.schedule_callback([&]() {
+        EXPECT_EQ(0, server->allocated_untracked_peers_count());
+        EXPECT_EQ(0, server->reused_untracked_peers_count());
+    });
+
+    server->set_on_schedule_removal([&](const io::Removable&) {
+        allocated_peers_count = server->allocated_untracked_peers_count();
+        reused_peers_count = server->reused_untracked_peers_count();
+    });
+
+    ASSERT_EQ(0, loop.run());
+
+    EXPECT_EQ(MESSAGES_COUNT, server_on_data_receive_count);
+    EXPECT_EQ(MESSAGES_COUNT, client_on_data_receive_count);
+    // Peer is held by the pending reply, but the reply is always sent before the next request
+    EXPECT_EQ(1, allocated_peers_count);
+    EXPECT_EQ(MESSAGES_COUNT - 1, reused_peers_count);
+}
+
+TEST_F(UdpClientServerTest, untracked_peer_with_removal_callback_is_not_reused) {
+    io::EventLoop loop;
+
+    const std::size_t MESSAGES_COUNT = 10;
+    std::size_t server_on_data_receive_count = 0;
+    std::size_t peers_removed_count = 0;
+
+    auto server = new io::UdpServer(loop);
+    auto listen_error = server->start_receive({m_default_addr, m_default_port},
+        [&](io::UdpPeer& peer, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error);
+            peer.set_on_schedule_removal([&](const io::Removable&) {
+                ++peers_removed_count;
+            });
+
+            if (++server_on_data_receive_count == MESSAGES_COUNT) {
+                EXPECT_EQ(MESSAGES_COUNT, server->allocated_untracked_peers_count());
+                EXPECT_EQ(0, server->reused_untracked_peers_count());
+                server->schedule_removal();
+            }
+        }
+    );
+    ASSERT_FALSE(listen_error);
+
+    auto client = new io::UdpClient(loop);
+    ASSERT_FALSE(client->set_destination({0x7F000001u, m_default_port}));
+
+    std::size_t messages_sent = 0;
+    std::function<void(io::UdpClient&, const io::Error&)> on_send = [&](io::UdpClient& client, const io::Error& error) {
+        EXPECT_FALSE(error);
+        if (++messages_sent == MESSAGES_COUNT) {
+            client.schedule_removal();
+            return;
+        }
+
+        client.send_data(std::to_string(messages_sent), on_send);
+    };
+    client->send_data(std::to_string(messages_sent), on_send);
+
+    ASSERT_EQ(0, loop.run());
+
+    EXPECT_EQ(MESSAGES_COUNT, server_on_data_receive_count);
+    EXPECT_EQ(MESSAGES_COUNT, peers_removed_count);
+}